@@ -3,17 +3,24 @@
 #pragma once
 
 
-#include <async\config.hpp>
-
-#include <async\manager.hpp>
-#include <async\promise.hpp>
-#include <async\promise_send.hpp>
-
-#include <async\manager__impl.hpp>
-#include <async\promise__impl.hpp>
-#include <async\promise_send__impl.hpp>
-
-#include <async\pool_threads_always.hpp>
-#include <async\pool_threads_ondemand.hpp>
-
-#include <async\logger_wostream.hpp>
+#include <async/config.hpp>
+
+#include <async/manager.hpp>
+#include <async/promise.hpp>
+#include <async/promise_send.hpp>
+
+#include <async/manager__impl.hpp>
+#include <async/promise__impl.hpp>
+#include <async/promise_send__impl.hpp>
+#include <async/promise_coroutine.hpp>
+
+#include <async/pool_threads_always.hpp>
+#include <async/pool_threads_ondemand.hpp>
+#include <async/pool_threads_hybrid.hpp>
+#include <async/pool_threads_numa.hpp>
+#include <async/pool_threads_stealing.hpp>
+#include <async/pool_resource.hpp>
+
+#include <async/logger_wostream.hpp>
+#include <async/logger_async.hpp>
+#include <async/logger_trace.hpp>
@@ -27,4 +27,34 @@ namespace async
 #endif // !ASYNC_LIB_API
 
 
+#ifdef ASYNC_LIB_NO_LOGGING
+    constexpr bool logging_enabled{ false }; // The contexts of log are not stored and the logger is never called
+#else
+    constexpr bool logging_enabled{ true };
+#endif
+
+
+// The empty members (e.g. log_ctx_t with ASYNC_LIB_NO_LOGGING) take no memory
+#ifndef ASYNC_NO_UNIQUE_ADDRESS
+#   if defined(_MSC_VER) && !defined(__clang__)
+#       define ASYNC_NO_UNIQUE_ADDRESS [[msvc::no_unique_address]]
+#   elif defined(__has_cpp_attribute)
+#       if __has_cpp_attribute(no_unique_address)
+#           define ASYNC_NO_UNIQUE_ADDRESS [[no_unique_address]]
+#       endif
+#   endif
+#   ifndef ASYNC_NO_UNIQUE_ADDRESS
+#       define ASYNC_NO_UNIQUE_ADDRESS
+#   endif
+#endif // !ASYNC_NO_UNIQUE_ADDRESS
+
+
+#if defined(__cpp_impl_coroutine) && !defined(ASYNC_LIB_NO_COROUTINES)
+#   define ASYNC_LIB_COROUTINES
+    constexpr bool coroutines_enabled{ true }; // co_await on promise and promise as the result of coroutine (see promise_coroutine.hpp)
+#else
+    constexpr bool coroutines_enabled{ false };
+#endif
+
+
 } // namespace async
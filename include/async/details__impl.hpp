@@ -3,11 +3,12 @@
 
 #include <string>
 #include <cassert>
+#include <optional>
 #include <string_view>
 
-#include <async\logger.hpp>
-#include <async\promise_types.hpp>
-#include <async\value_or_promise.hpp>
+#include <async/logger.hpp>
+#include <async/promise_types.hpp>
+#include <async/value_or_promise.hpp>
 
 
 namespace async::details
@@ -212,35 +213,181 @@ namespace async::details
 		return add_details_log_ctx(log, append_log_ctx(log_ctx, log_ctx_next_node_view), details_view);
 	}
 
+#ifdef ASYNC_LIB_NO_LOGGING
+
+	// The context of log is empty: nothing is normalized, appended and allocated
+
+	constexpr no_log_ctx add_details_log_ctx(logger*, no_log_ctx, std::wstring_view) noexcept
+	{
+		return {};
+	}
+	[[nodiscard]] constexpr no_log_ctx normalize_log_ctx(no_log_ctx) noexcept
+	{
+		return {};
+	}
+	[[nodiscard]] constexpr no_log_ctx normalize_log_ctx(logger*, no_log_ctx, std::wstring_view) noexcept
+	{
+		return {};
+	}
+	constexpr no_log_ctx append_log_ctx(logger*, no_log_ctx, no_log_ctx) noexcept
+	{
+		return {};
+	}
+
+#else
+
+	// The labels are normalized by interning, the steps are appended only for the logger
+
+	inline interned_log_ctx& add_details_log_ctx(logger* log, interned_log_ctx& log_ctx, std::wstring_view details_view)
+	{
+		assert(!details_view.empty());
+
+		if (log)
+			log_ctx.add_details(details_view);
+
+		return log_ctx;
+	}
+	inline interned_log_ctx add_details_log_ctx(logger* log, const interned_log_ctx& log_ctx_src, std::wstring_view details_view)
+	{
+		interned_log_ctx log_ctx{ log_ctx_src };
+		return std::move(add_details_log_ctx(log, log_ctx, details_view));
+	}
+	[[nodiscard]] inline interned_log_ctx normalize_log_ctx(interned_log_ctx&& log_ctx) noexcept
+	{
+		return std::move(log_ctx);
+	}
+	[[nodiscard]] inline interned_log_ctx normalize_log_ctx(logger* log, interned_log_ctx&& log_ctx, std::wstring_view details_view)
+	{
+		add_details_log_ctx(log, log_ctx, details_view);
+		return std::move(log_ctx);
+	}
+	inline interned_log_ctx& append_log_ctx(logger* log, interned_log_ctx& log_ctx, const interned_log_ctx& log_ctx_next_node)
+	{
+		if (log)
+			log_ctx.append(log_ctx_next_node);
+
+		return log_ctx;
+	}
+
+#endif // ASYNC_LIB_NO_LOGGING
+
 	template<class _Value>
 	inline prom_data_ptr<_Value> take_data_of_promise(promise<_Value>& promise)
 	{
 		return promise.take_data();
 	}
 
-	inline void add_task_in_pool(pool::ctx_t pool_ctx, pool& pool_impl, task_variant_t&& task_v) noexcept
+	inline pool::task_t trace_task(pool& pool_impl, pool::task_t&& task)
+	{
+		// The logger marks the enqueue now, the dequeue and the finish are marked by the task (see logger_trace)
+
+		if constexpr (logging_enabled)
+		{
+			if (logger* const log = pool_impl.log())
+			{
+				if (const std::uint64_t task_id = log->task_enqueued(pool_impl))
+				{
+					return pool_impl.make_task([log, task_id, tsk = std::move(task)](pool::ctx_t pool_ctx) mutable
+					{
+						// The finish is marked also by the exception of the task: the stack of the running tasks of the thread is kept
+						struct finish_guard_t
+						{
+							logger* const log;
+							const std::uint64_t task_id;
+
+							~finish_guard_t()
+							{
+								log->task_finished(task_id);
+							}
+						};
+
+						log->task_dequeued(task_id);
+
+						const finish_guard_t finish_guard{ log, task_id };
+						tsk(std::move(pool_ctx));
+					});
+				}
+			}
+		}
+
+		return std::move(task);
+	}
+
+	inline void add_task_in_pool(pool::ctx_t pool_ctx, pool& pool_impl, task_variant_t&& task_v, pool::priority_t priority) noexcept
 	{
 		if (pool::task_t* const one_task = std::get_if<pool::task_t>(&task_v))
 		{
-			pool_impl.add_task(std::move(pool_ctx), std::move(*one_task));
+			pool_impl.add_task(std::move(pool_ctx), trace_task(pool_impl, std::move(*one_task)), priority);
 		}
 		else
 		{
 			pool::more_tasks_t& more_tasks{ std::get<pool::more_tasks_t>(task_v) };
 			assert(!more_tasks.empty());
 
-			auto it_task{ begin(more_tasks) };
-			const auto it_task_end{ end(more_tasks) };
+			for (pool::task_t& tsk : more_tasks)
+				tsk = trace_task(pool_impl, std::move(tsk));
 
-			pool_impl.add_task(std::move(pool_ctx), std::move(*it_task++));
+			pool_impl.add_tasks(std::move(pool_ctx), more_tasks.data(), more_tasks.size(), priority);
+		}
+	}
 
-			while (it_task != it_task_end)
-			{
-				pool_impl.add_task(pool::unknown_ctx, std::move(*it_task++));
-			}
+	inline void add_task_in_pool_or_batch(pool::ctx_t pool_ctx, pool& pool_impl, task_variant_t&& task_v, pool::priority_t priority, pool::more_tasks_t* ready_tasks) noexcept
+	{
+		// The batch is added in the pool later by the caller (with one call pool::add_tasks)
+
+		if (!ready_tasks)
+		{
+			add_task_in_pool(std::move(pool_ctx), pool_impl, std::move(task_v), priority);
+		}
+		else
+		if (pool::task_t* const one_task = std::get_if<pool::task_t>(&task_v))
+		{
+			ready_tasks->push_back(trace_task(pool_impl, std::move(*one_task)));
+		}
+		else
+		{
+			for (pool::task_t& tsk : std::get<pool::more_tasks_t>(task_v))
+				ready_tasks->push_back(trace_task(pool_impl, std::move(tsk)));
 		}
 	}
 
+	inline std::size_t& inline_exec_depth() noexcept
+	{
+		static thread_local std::size_t depth{ 0 };
+		return depth;
+	}
+
+	inline bool try_exec_inline(const pool::ctx_t& pool_ctx, pool& pool_impl, task_variant_t& task_v, std::optional<pool::exec_t> exec) noexcept
+	{
+		// The ready next step with pool::exec_t::inline_exec is executed in this thread, instead of the pool
+
+		if (exec.value_or(pool_impl.continuations_exec()) != pool::exec_t::inline_exec)
+			return false;
+
+		pool::task_t* const one_task = std::get_if<pool::task_t>(&task_v);
+		if (!one_task)
+			return false;
+
+		std::size_t& depth{ inline_exec_depth() };
+		if (depth >= pool::inline_exec_depth_max)
+			return false; // The long chain of the inline steps goes through the queue, so the stack does not overflow
+
+		pool::task_t task{ std::move(*one_task) };
+
+		depth += 1;
+		try
+		{
+			task(pool_ctx);
+		}
+		catch (...)
+		{
+			log_except(pool_impl.log(), std::current_exception(), L"Processing async task inline finished with error"sv);
+		}
+		depth -= 1;
+
+		return true;
+	}
+
 	template<class _Value>
 	struct api
 	{
@@ -268,7 +415,8 @@ namespace async::details
 			{
 				//Ok: new_state = result_state_t::executable;
 
-				details::add_task_in_pool(std::move(pool_ctx), pool, std::move(result.next_task_v));
+				if (!details::try_exec_inline(pool_ctx, pool, result.next_task_v, result.exec))
+					details::add_task_in_pool(std::move(pool_ctx), pool, std::move(result.next_task_v), result.priority);
 			}
 			else
 			{
@@ -279,112 +427,113 @@ namespace async::details
 
 	public:
 
-		static inline value_or_promise_t<_Value> apply_task(logger* log, std::wstring_view log_ctx_view, const task_t<_Value>& tsk_v) noexcept
+		static inline value_or_promise_t<_Value> apply_task(logger* log, const log_ctx_t& log_ctx, const task_t<_Value>& tsk_v) noexcept
 		{
 			using _Arg = void;
 
 			try
 			{
-                const log_scope log_scope_guard{ log, L'[', log_ctx_view, L']' };
+                const log_scope log_scope_guard{ log, L'[', log_ctx, L']' };
 				
 				value_t<_Arg> arg{};
 				arg.set_value();
 
 				if (std::get_if<function_1_t<_Value, _Arg>>(&tsk_v))
-					return traits_value_or_promise<_Value>::apply<_Arg>(std::get<function_1_t<_Value, _Arg>>(tsk_v), std::move(arg));
+					return traits_value_or_promise<_Value>::template apply<_Arg>(std::get<function_1_t<_Value, _Arg>>(tsk_v), std::move(arg));
 				else
-					return traits_value_or_promise<_Value>::apply<_Arg>(std::get<function_2_t<_Value, _Arg>>(tsk_v), std::move(arg));
+					return traits_value_or_promise<_Value>::template apply<_Arg>(std::get<function_2_t<_Value, _Arg>>(tsk_v), std::move(arg));
 			}
 			catch (...)
 			{
                 // tarce
-                log_except(log, std::current_exception(), L'[', log_ctx_view, L']');
+                log_except(log, std::current_exception(), L'[', log_ctx, L']');
 
 				value_or_promise_t<_Value> result{};
 				result.set_except(std::current_exception());
 				return result;
 			}
-			__assume(false);
 		}
 
 		template<class _Arg>
-		static inline value_or_promise_t<_Value> apply_then(logger* log, std::wstring& log_ctx, const then_t<_Value, _Arg>& thn, value_t<_Arg>& arg) noexcept
+		static inline value_or_promise_t<_Value> apply_then(logger* log, const log_ctx_t& log_ctx, const then_t<_Value, _Arg>& thn, value_t<_Arg>& arg) noexcept
 		{
 			try
 			{
-                const log_scope log_scope_guard{ log, L'[', log_ctx_view, L']' };
+                const log_scope log_scope_guard{ log, L'[', log_ctx, L']' };
 				
 				if (std::get_if<function_1_t<_Value, value_t<_Arg>>>(&thn))
-					return traits_value_or_promise<_Value>::apply<value_t<_Arg>>(std::get<function_1_t<_Value, value_t<_Arg>>>(thn), std::move(arg));
+					return traits_value_or_promise<_Value>::template apply<value_t<_Arg>>(std::get<function_1_t<_Value, value_t<_Arg>>>(thn), std::move(arg));
 				else
-					return traits_value_or_promise<_Value>::apply<value_t<_Arg>>(std::get<function_2_t<_Value, value_t<_Arg>>>(thn), std::move(arg));
+					return traits_value_or_promise<_Value>::template apply<value_t<_Arg>>(std::get<function_2_t<_Value, value_t<_Arg>>>(thn), std::move(arg));
 			}
 			catch (...)
 			{
-				::logger::log_exception(std::current_exception(), ::logger::level::trace, head_title(log_ctx));
+                // trace
+                log_except(log, std::current_exception(), L'[', log_ctx, L']');
 
 				value_or_promise_t<_Value> result{};
 				result.set_except(std::current_exception());
 				return result;
 			}
-			__assume(false);
 		}
 
 		template<class _Arg>
-		static inline value_or_promise_t<_Value> apply_success(logger* log, std::wstring_view log_ctx_view, const success_t<_Value, _Arg>& scss, value_t<_Arg>& arg) noexcept
+		static inline value_or_promise_t<_Value> apply_success(logger* log, const log_ctx_t& log_ctx, const success_t<_Value, _Arg>& scss, value_t<_Arg>& arg) noexcept
 		{
 			assert(arg.has_value());
 
 			try
 			{
-                const log_scope log_scope_guard{ log, L'[', log_ctx_view, L']' };
+                const log_scope log_scope_guard{ log, L'[', log_ctx, L']' };
 
 				if (std::get_if<function_1_t<_Value, _Arg>>(&scss))
-					return traits_value_or_promise<_Value>::apply<_Arg>(std::get<function_1_t<_Value, _Arg>>(scss), std::move(arg));
+					return traits_value_or_promise<_Value>::template apply<_Arg>(std::get<function_1_t<_Value, _Arg>>(scss), std::move(arg));
 				else
-					return traits_value_or_promise<_Value>::apply<_Arg>(std::get<function_2_t<_Value, _Arg>>(scss), std::move(arg));
+					return traits_value_or_promise<_Value>::template apply<_Arg>(std::get<function_2_t<_Value, _Arg>>(scss), std::move(arg));
 			}
 			catch (...)
 			{
                 // trace
-                log_except(log, std::current_exception(), L'[', log_ctx_view, L']');
+                log_except(log, std::current_exception(), L'[', log_ctx, L']');
 
 				value_or_promise_t<_Value> result{};
 				result.set_except(std::current_exception());
 				return result;
 			}
-			__assume(false);
 		}
 
-		static inline value_or_promise_t<_Value> apply_reject(logger* log, std::wstring_view log_ctx_view, const reject_t<_Value>& rjct, std::exception_ptr except) noexcept
+		static inline value_or_promise_t<_Value> apply_reject(logger* log, const log_ctx_t& log_ctx, const reject_t<_Value>& rjct, std::exception_ptr except) noexcept
 		{
 			try
 			{
-                const log_scope log_scope_guard{ log, L'[', log_ctx_view, L']' };
+                const log_scope log_scope_guard{ log, L'[', log_ctx, L']' };
 				
 				if (std::get_if<function_1_t<_Value, std::exception_ptr>>(&rjct))
-					return traits_value_or_promise<_Value>::apply<std::exception_ptr>(std::get<function_1_t<_Value, std::exception_ptr>>(rjct), except);
+					return traits_value_or_promise<_Value>::template apply<std::exception_ptr>(std::get<function_1_t<_Value, std::exception_ptr>>(rjct), except);
 				else
-					return traits_value_or_promise<_Value>::apply<std::exception_ptr>(std::get<function_2_t<_Value, std::exception_ptr>>(rjct), except);
+					return traits_value_or_promise<_Value>::template apply<std::exception_ptr>(std::get<function_2_t<_Value, std::exception_ptr>>(rjct), except);
 			}
 			catch (...)
 			{
                 // trace
-                log_except(log, std::current_exception(), L'[', log_ctx_view, L']');
+                log_except(log, std::current_exception(), L'[', log_ctx, L']');
 
 				value_or_promise_t<_Value> result{};
 				result.set_except(std::current_exception());
 				return result;
 			}
-			__assume(false);
 		}
 
 	public:
 
-		static void bind_next_step(pool::ctx_t pool_ctx, result_t<_Value>& result, pool& pool, pool::task_t&& next_task)
+		template<class _NextStep>
+		static void bind_next_step(pool::ctx_t pool_ctx, result_t<_Value>& result, pool& pool, _NextStep&& next_step, pool::more_tasks_t* ready_tasks = nullptr)
 		{
 			using namespace std::literals;
 
+			// The closure of the next step is allocated from the memory resource of pool (if it does not fit in the task)
+			pool::task_t next_task{ pool.make_task(std::forward<_NextStep>(next_step)) };
+
 			assert(next_task);
 
 			if (pool::task_t* const result_next_task = std::get_if<pool::task_t>(&result.next_task_v))
@@ -406,7 +555,8 @@ namespace async::details
 					{
 						//Ok: new_state = result_state_t::executable;
 
-						details::add_task_in_pool(std::move(pool_ctx), pool, std::move(result.next_task_v));
+						if (!details::try_exec_inline(pool_ctx, pool, result.next_task_v, result.exec))
+							details::add_task_in_pool_or_batch(std::move(pool_ctx), pool, std::move(result.next_task_v), result.priority, ready_tasks);
 						assert(!std::get<pool::task_t>(result.next_task_v));
 					}
 					else
@@ -433,7 +583,8 @@ namespace async::details
 					{
 						//Ok: new_state = result_state_t::executable;
 
-						details::add_task_in_pool(std::move(pool_ctx), pool, std::move(result.next_task_v));
+						if (!details::try_exec_inline(pool_ctx, pool, result.next_task_v, result.exec))
+							details::add_task_in_pool_or_batch(std::move(pool_ctx), pool, std::move(result.next_task_v), result.priority, ready_tasks);
 						assert(!std::get<pool::task_t>(result.next_task_v));
 					}
 					else
@@ -473,24 +624,24 @@ namespace async::details
 
 
 	template<class _Result, class _Arg>
-	value_or_promise_t<_Result> then_then(logger* log, std::wstring& log_ctx, value_t<_Arg>& arg, const then_t<_Result, _Arg>& thn)
+	value_or_promise_t<_Result> then_then(logger* log, log_ctx_t& log_ctx, value_t<_Arg>& arg, const then_t<_Result, _Arg>& thn)
 	{
 		assert(arg.is_established());
 	
         add_details_log_ctx(log, log_ctx, (arg.has_value() ? L"scss"sv : L"rjct"sv));
         
-        return api<_Result>::apply_then<_Arg>(log, log_ctx, thn, arg);
+        return api<_Result>::template apply_then<_Arg>(log, log_ctx, thn, arg);
 	}
 
 	template<class _Result, class _Arg>
-	value_or_promise_t<_Result> then_success_reject(logger* log, std::wstring& log_ctx, value_t<_Arg>& arg, const success_t<_Result, _Arg>& scss, const reject_t<_Result>& rjct)
+	value_or_promise_t<_Result> then_success_reject(logger* log, log_ctx_t& log_ctx, value_t<_Arg>& arg, const success_t<_Result, _Arg>& scss, const reject_t<_Result>& rjct)
 	{
 		assert(arg.is_established());
 
 		if (arg.has_value())
 		{
 			add_details_log_ctx(log, log_ctx, L"scss"sv);
-			return api<_Result>::apply_success<_Arg>(log, log_ctx, scss, arg);
+			return api<_Result>::template apply_success<_Arg>(log, log_ctx, scss, arg);
 		}
 		
 		assert(arg.has_except());
@@ -500,14 +651,14 @@ namespace async::details
 	}
 
 	template<class _Result, class _Arg>
-	value_or_promise_t<_Result> then_success(logger* log, std::wstring& log_ctx, value_t<_Arg>& arg, const success_t<_Result, _Arg>& scss)
+	value_or_promise_t<_Result> then_success(logger* log, log_ctx_t& log_ctx, value_t<_Arg>& arg, const success_t<_Result, _Arg>& scss)
 	{
 		assert(arg.is_established());
 
 		if (arg.has_value())
 		{
 			add_details_log_ctx(log, log_ctx, L"scss"sv);
-			return api<_Result>::apply_success<_Arg>(log, log_ctx, scss, arg);
+			return api<_Result>::template apply_success<_Arg>(log, log_ctx, scss, arg);
 		}
 
 		assert(arg.has_except());
@@ -520,7 +671,7 @@ namespace async::details
 	}
 
 	template<class _Value>
-	value_or_promise_t<_Value> then_reject(logger* log, std::wstring& log_ctx, value_t<_Value>&& val_value, const reject_t<_Value>& rjct)
+	value_or_promise_t<_Value> then_reject(logger* log, log_ctx_t& log_ctx, value_t<_Value>&& val_value, const reject_t<_Value>& rjct)
 	{
 		assert(val_value.is_established());
 
@@ -538,7 +689,7 @@ namespace async::details
 	}
 
 	template<class _Value>
-	value_or_promise_t<_Value> then_finaly(logger* log, std::wstring& log_ctx, value_or_promise_t<_Value>&& result, const finally_t& fnly) noexcept
+	value_or_promise_t<_Value> then_finaly(logger* log, log_ctx_t& log_ctx, value_or_promise_t<_Value>&& result, const finally_t& fnly) noexcept
 	{
 		add_details_log_ctx(log, log_ctx, L"fnly"sv);
 
@@ -558,6 +709,57 @@ namespace async::details
 		return std::move(result);
 	}
 
+	/** \brief Shared state of the promise, whose result is set by the armed timer (see \a manager::delay and \a manager::schedule_at).
+	 *
+	 * \details The timer, which is dropped without the expiration (see \a timer_wheel::stop), rejects the promise
+	 *          with \a promise_errc::broken_promise, as the dropped \a promise::send does.
+	 */
+	template<class _Value>
+	class armed_prom_data
+	{
+	public:
+
+		explicit armed_prom_data(prom_data_ptr<_Value> data) noexcept
+			: m_data(std::move(data))
+		{}
+
+		armed_prom_data(armed_prom_data&& other) noexcept = default;
+		armed_prom_data(const armed_prom_data& other) = delete;
+
+		armed_prom_data& operator=(armed_prom_data&& other) = delete;
+		armed_prom_data& operator=(const armed_prom_data& other) = delete;
+
+		~armed_prom_data()
+		{
+			if (m_data)
+			{
+				try
+				{
+					value_or_promise_t<_Value> result{};
+					result.set_except(std::make_exception_ptr(promise_error{ promise_errc::broken_promise }));
+
+					api<_Value>::set_result(pool::unknown_ctx, m_data, std::move(result));
+				}
+				catch (...)
+				{
+				}
+			}
+		}
+
+	public:
+
+		/** \brief The timer is expired: the result is set by the owner.
+		 */
+		[[nodiscard]] prom_data_ptr<_Value> take() noexcept
+		{
+			return std::move(m_data);
+		}
+
+	private:
+
+		prom_data_ptr<_Value> m_data;
+	};
+
 	template<class... _Values>
 	struct api_all
 	{
@@ -586,7 +788,7 @@ namespace async::details
 		static_assert(api_all::size < (static_cast<std::size_t>(~0) - 1));
 
 		template<std::size_t arg_mumber>
-		static void bind_next_steps_impl(const res_data_t& res_data, const std::shared_ptr<shared_data_t>& shared_data, tuple_arg_datas_t& tuple_arg_datas)
+		static void bind_next_steps_impl(const res_data_t& res_data, const std::shared_ptr<shared_data_t>& shared_data, tuple_arg_datas_t& tuple_arg_datas, pool::more_tasks_t& ready_tasks)
 		{
 			constexpr std::size_t arg_index{ arg_mumber - 1 };
 			using arg_value_t = std::tuple_element_t<arg_index, typle_values_t>;
@@ -594,6 +796,12 @@ namespace async::details
 
 			const arg_data_t& arg_data{ std::get<arg_index>(tuple_arg_datas) };
 
+			// The steps of the already resolved arguments are collected in one batch, if they are executed in the resulting pool
+			// with the priority of the result
+			const bool is_same_pool_and_priority{ arg_data->pool == res_data->pool && arg_data->result.priority == res_data->result.priority };
+
+			pool::more_tasks_t* const arg_ready_tasks{ is_same_pool_and_priority ? &ready_tasks : nullptr };
+
 			details::api<arg_value_t>::bind_next_step(
 				pool::unknown_ctx,
 				arg_data->result,
@@ -666,25 +874,21 @@ namespace async::details
 
 					details::api<typle_values_t>::set_result(std::move(pool_ctx), res_data, std::move(shared_data->res_values));
 				}
-			});
+			}, arg_ready_tasks);
 		}
 		template<std::size_t arg_mumber>
-		static inline void bind_next_steps_recursive(const res_data_t& res_data, const std::shared_ptr<shared_data_t>& shared_data, tuple_arg_datas_t& tuple_arg_datas)
-		{
-			bind_next_steps_impl<arg_mumber>(res_data, shared_data, tuple_arg_datas);
-			bind_next_steps_recursive<arg_mumber + 1>(res_data, shared_data, tuple_arg_datas);
-		}
-		template<>
-		static inline void bind_next_steps_recursive<size>(const res_data_t& res_data, const std::shared_ptr<shared_data_t>& shared_data, tuple_arg_datas_t& tuple_arg_datas)
+		static inline void bind_next_steps_recursive(const res_data_t& res_data, const std::shared_ptr<shared_data_t>& shared_data, tuple_arg_datas_t& tuple_arg_datas, pool::more_tasks_t& ready_tasks)
 		{
-			bind_next_steps_impl<size>(res_data, shared_data, tuple_arg_datas);
+			bind_next_steps_impl<arg_mumber>(res_data, shared_data, tuple_arg_datas, ready_tasks);
+			if constexpr (arg_mumber < size)
+				bind_next_steps_recursive<arg_mumber + 1>(res_data, shared_data, tuple_arg_datas, ready_tasks);
 		}
 
 	public:
 
-		static inline void bind_next_steps(const res_data_t& res_data, const std::shared_ptr<shared_data_t>& shared_data, tuple_arg_datas_t& tuple_arg_datas)
+		static inline void bind_next_steps(const res_data_t& res_data, const std::shared_ptr<shared_data_t>& shared_data, tuple_arg_datas_t& tuple_arg_datas, pool::more_tasks_t& ready_tasks)
 		{
-			bind_next_steps_recursive<1>(res_data, shared_data, tuple_arg_datas);
+			bind_next_steps_recursive<1>(res_data, shared_data, tuple_arg_datas, ready_tasks);
 		}
 
 		struct one
@@ -0,0 +1,177 @@
+#pragma once
+
+
+#include <chrono>
+#include <thread>
+#include <cstddef>
+#include <algorithm>
+
+#if defined(_MSC_VER) && (defined(_M_IX86) || defined(_M_X64))
+#   include <intrin.h>
+#endif
+
+
+namespace async
+{
+
+	/** \brief What the work thread of pool does, when the queue is empty.
+	 *
+	 * \details The thread spins (with the \a pause instruction) up to the adaptive budget, then yields \a yields_count times,
+	 *          then parks on the condition variable. A spinning thread is not idle for the producers, so the task added
+	 *          during spinning does not pay the wake up of the parked thread.
+	 *
+	 * \details The budget of each thread is adapted to the average time it waited for the next task: it is twice the average,
+	 *          but not more than \a spin_max; if the average is longer than \a spin_max, the thread parks at once.
+	 *
+	 * \details \a idle_policy::park() (default) does not spin at all. On the single CPU the threads do not spin either:
+	 *          the producer could not run while they spin.
+	 */
+	struct idle_policy
+	{
+		std::chrono::nanoseconds spin_max; // Upper bound of the spin budget, zero - do not spin
+		std::size_t yields_count;          // After the spinning, before the parking
+
+		[[nodiscard]] static constexpr idle_policy park() noexcept
+		{
+			return idle_policy{ std::chrono::nanoseconds::zero(), 0 };
+		}
+
+		[[nodiscard]] static constexpr idle_policy low_latency() noexcept
+		{
+			return idle_policy{ std::chrono::microseconds{ 50 }, 16 };
+		}
+
+		[[nodiscard]] constexpr bool spinning() const noexcept
+		{
+			return (spin_max > std::chrono::nanoseconds::zero());
+		}
+	};
+
+} // namespace async
+
+
+namespace async::details
+{
+
+	inline void cpu_relax() noexcept
+	{
+#if defined(_MSC_VER) && (defined(_M_IX86) || defined(_M_X64))
+		_mm_pause();
+#elif defined(__i386__) || defined(__x86_64__)
+		__builtin_ia32_pause();
+#elif defined(__aarch64__) || defined(__arm__)
+		__asm__ __volatile__("yield");
+#endif
+	}
+
+	/** \brief Spinning of one work thread by \a idle_policy (the object is owned by the thread).
+	 */
+	class idle_spinner
+	{
+	public:
+
+		using clock_t = std::chrono::steady_clock;
+
+		static constexpr std::size_t pauses_between_checks{ 16 };
+
+	public:
+
+		explicit idle_spinner(const idle_policy& policy, unsigned hardware_threads_count = std::thread::hardware_concurrency()) noexcept
+			: m_policy{ policy }
+			, m_enabled{ policy.spinning() && hardware_threads_count != 1 }
+			, m_budget{ policy.spin_max }
+			, m_wait_average{ std::chrono::nanoseconds::zero() }
+			, m_idle_since{}
+			, m_idle{ false }
+		{}
+
+	public:
+
+		[[nodiscard]] bool enabled() const noexcept
+		{
+			return m_enabled;
+		}
+
+		/** \brief The current spin budget: zero or from \a spin_max / 16 to \a spin_max.
+		 */
+		[[nodiscard]] std::chrono::nanoseconds budget() const noexcept
+		{
+			return m_budget;
+		}
+
+		/** \brief Spin until \a ready() or up to the budget.
+		 *
+		 * \return If \a ready() returned \a true, otherwise \a false (the thread should park, then call \a wake_up).
+		 */
+		template<class _Ready>
+		[[nodiscard]] bool spin(_Ready&& ready)
+		{
+			if (!m_enabled)
+				return false;
+
+			m_idle_since = clock_t::now();
+			m_idle = true;
+
+			if (m_budget > std::chrono::nanoseconds::zero())
+			{
+				const clock_t::time_point spin_until{ m_idle_since + m_budget };
+
+				do
+				{
+					for (std::size_t index = 0; index < pauses_between_checks; ++index)
+						cpu_relax();
+
+					if (ready())
+					{
+						wake_up();
+						return true;
+					}
+				}
+				while (clock_t::now() < spin_until);
+
+				for (std::size_t index = 0; index < m_policy.yields_count; ++index)
+				{
+					std::this_thread::yield();
+
+					if (ready())
+					{
+						wake_up();
+						return true;
+					}
+				}
+			}
+
+			return false;
+		}
+
+		/** \brief The thread got the task after \a spin: adapt the budget to the time of waiting.
+		 */
+		void wake_up() noexcept
+		{
+			if (!m_idle)
+				return;
+
+			m_idle = false;
+
+			const std::chrono::nanoseconds wait_time{ std::chrono::duration_cast<std::chrono::nanoseconds>(clock_t::now() - m_idle_since) };
+
+			m_wait_average = (m_wait_average * 7 + wait_time) / 8;
+
+			m_budget = (m_wait_average * 2 <= m_policy.spin_max)
+				? std::max(m_wait_average * 2, m_policy.spin_max / 16)
+				: std::chrono::nanoseconds::zero();
+		}
+
+	private:
+
+		const idle_policy m_policy;
+		const bool m_enabled;
+
+		std::chrono::nanoseconds m_budget;
+		std::chrono::nanoseconds m_wait_average;
+
+		clock_t::time_point m_idle_since;
+		bool m_idle;
+	};
+
+} // namespace async::details
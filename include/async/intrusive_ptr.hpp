@@ -0,0 +1,227 @@
+#pragma once
+
+
+#include <atomic>
+#include <thread>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+
+
+namespace async::details
+{
+	/** \brief Pointer to the object with the reference counter inside (see \a intrusive_ptr_add_ref and \a intrusive_ptr_release).
+	 *
+	 * \details Unlike \a std::shared_ptr there is no control block: the object and its counter are one allocation,
+	 *          and the copy of the pointer is one atomic increment of the counter.
+	 *
+	 * \details \a exchange and \a atomic_copy are safe against the concurrent \a exchange and \a atomic_copy of the same pointer
+	 *          (\a std::atomic_exchange of \a std::shared_ptr takes a spin lock from the global table).
+	 *          The other operations are not atomic, as those of \a std::shared_ptr.
+	 */
+	template<class _Type>
+	class intrusive_ptr
+	{
+	public:
+
+		intrusive_ptr() noexcept
+			: m_ptr{ nullptr }
+		{}
+
+		intrusive_ptr(std::nullptr_t) noexcept
+			: m_ptr{ nullptr }
+		{}
+
+		intrusive_ptr(const intrusive_ptr& other) noexcept
+			: m_ptr{ other.get() }
+		{
+			if (_Type* const ptr = get())
+				intrusive_ptr_add_ref(ptr);
+		}
+
+		intrusive_ptr(intrusive_ptr&& other) noexcept
+			: m_ptr{ other.detach() }
+		{}
+
+		~intrusive_ptr()
+		{
+			reset();
+		}
+
+		intrusive_ptr& operator=(const intrusive_ptr& other) noexcept
+		{
+			intrusive_ptr(other).swap(*this);
+			return *this;
+		}
+
+		intrusive_ptr& operator=(intrusive_ptr&& other) noexcept
+		{
+			intrusive_ptr(std::move(other)).swap(*this);
+			return *this;
+		}
+
+		intrusive_ptr& operator=(std::nullptr_t) noexcept
+		{
+			reset();
+			return *this;
+		}
+
+		/** \brief Take the ownership of the object, whose counter already includes this pointer.
+		 */
+		[[nodiscard]] static intrusive_ptr adopt(_Type* ptr) noexcept
+		{
+			intrusive_ptr result{};
+			result.m_ptr.store(ptr, std::memory_order_relaxed);
+			return result;
+		}
+
+	public:
+
+		[[nodiscard]] _Type* get() const noexcept
+		{
+			return m_ptr.load(std::memory_order_relaxed);
+		}
+
+		_Type* operator->() const noexcept
+		{
+			assert(get());
+			return get();
+		}
+
+		_Type& operator*() const noexcept
+		{
+			assert(get());
+			return *get();
+		}
+
+		explicit operator bool() const noexcept
+		{
+			return (get() != nullptr);
+		}
+
+		void reset() noexcept
+		{
+			if (_Type* const ptr = detach())
+				intrusive_ptr_release(ptr);
+		}
+
+		void swap(intrusive_ptr& other) noexcept
+		{
+			_Type* const ptr{ get() };
+			m_ptr.store(other.get(), std::memory_order_relaxed);
+			other.m_ptr.store(ptr, std::memory_order_relaxed);
+		}
+
+		/** \brief Atomic replacement of the pointer, returns the previous one.
+		 *
+		 * \details Waits only for \a atomic_copy, which holds the pointer for the increment of the counter.
+		 */
+		intrusive_ptr exchange(intrusive_ptr desired) noexcept
+		{
+			_Type* const next{ desired.detach() };
+			_Type* ptr{ m_ptr.load(std::memory_order_relaxed) };
+
+			for (;;)
+			{
+				if (is_copying(ptr))
+				{
+					std::this_thread::yield();
+					ptr = m_ptr.load(std::memory_order_relaxed);
+				}
+				else
+				if (m_ptr.compare_exchange_weak(ptr, next, std::memory_order_acq_rel, std::memory_order_relaxed))
+				{
+					return adopt(ptr);
+				}
+			}
+		}
+
+		/** \brief Atomic copy of the pointer: the object is not released by the concurrent \a exchange before the counter is incremented.
+		 *
+		 * \details The pointer is marked by the low bit (the objects are aligned) while the counter is incremented,
+		 *          \a exchange does not replace the marked pointer.
+		 */
+		[[nodiscard]] intrusive_ptr atomic_copy() const noexcept
+		{
+			static_assert(alignof(_Type) > copying_bit, "The low bit of the pointer marks the copying");
+
+			_Type* ptr{ m_ptr.load(std::memory_order_relaxed) };
+
+			for (;;)
+			{
+				if (!ptr)
+					return {};
+
+				if (is_copying(ptr))
+				{
+					std::this_thread::yield();
+					ptr = m_ptr.load(std::memory_order_relaxed);
+				}
+				else
+				if (m_ptr.compare_exchange_weak(ptr, mark_copying(ptr), std::memory_order_acquire, std::memory_order_relaxed))
+				{
+					break;
+				}
+			}
+
+			intrusive_ptr_add_ref(ptr);
+
+			// Nobody replaces the marked pointer
+			m_ptr.store(ptr, std::memory_order_release);
+
+			return adopt(ptr);
+		}
+
+	private:
+
+		static constexpr std::uintptr_t copying_bit{ 1 };
+
+		[[nodiscard]] static bool is_copying(_Type* ptr) noexcept
+		{
+			return ((reinterpret_cast<std::uintptr_t>(ptr) & copying_bit) != 0);
+		}
+
+		[[nodiscard]] static _Type* mark_copying(_Type* ptr) noexcept
+		{
+			return reinterpret_cast<_Type*>(reinterpret_cast<std::uintptr_t>(ptr) | copying_bit);
+		}
+
+		_Type* detach() noexcept
+		{
+			_Type* const ptr{ get() };
+			m_ptr.store(nullptr, std::memory_order_relaxed);
+			return ptr;
+		}
+
+	private:
+
+		mutable std::atomic<_Type*> m_ptr; // mutable: atomic_copy marks it for a moment
+	};
+
+
+	template<class _Type>
+	[[nodiscard]] inline bool operator==(const intrusive_ptr<_Type>& left, const intrusive_ptr<_Type>& right) noexcept
+	{
+		return (left.get() == right.get());
+	}
+
+	template<class _Type>
+	[[nodiscard]] inline bool operator!=(const intrusive_ptr<_Type>& left, const intrusive_ptr<_Type>& right) noexcept
+	{
+		return (left.get() != right.get());
+	}
+
+	template<class _Type>
+	[[nodiscard]] inline bool operator==(const intrusive_ptr<_Type>& ptr, std::nullptr_t) noexcept
+	{
+		return !ptr;
+	}
+
+	template<class _Type>
+	[[nodiscard]] inline bool operator!=(const intrusive_ptr<_Type>& ptr, std::nullptr_t) noexcept
+	{
+		return static_cast<bool>(ptr);
+	}
+
+} // namespace async::details
@@ -0,0 +1,352 @@
+#pragma once
+
+
+#include <array>
+#include <deque>
+#include <mutex>
+#include <atomic>
+#include <string>
+#include <vector>
+#include <cassert>
+#include <cstdint>
+#include <utility>
+#include <shared_mutex>
+#include <string_view>
+#include <type_traits>
+#include <unordered_map>
+
+#include <async/intrusive_ptr.hpp>
+
+
+namespace async
+{
+	/** \brief Table of the labels of the contexts of log: every label gets the small number once and forever.
+	 *
+	 * \details The labels are the names of the call sites, so the table is small and the number of the label is
+	 *          found by the cache of the thread (no lock and no shared memory); the table itself is locked only
+	 *          on the first meeting of the label by the thread.
+	 *
+	 * \details The labels are never removed: the dynamic text in the labels (numbers, identifiers) grows the table.
+	 */
+	class log_labels
+	{
+	public:
+
+		using id_t = std::uint32_t;
+
+		static constexpr id_t empty_id{ 0 };
+
+	public:
+
+		[[nodiscard]] static log_labels& instance()
+		{
+			static log_labels labels{};
+			return labels;
+		}
+
+		log_labels(log_labels&& other) = delete;
+		log_labels(const log_labels& other) = delete;
+
+		log_labels& operator=(log_labels&& other) = delete;
+		log_labels& operator=(const log_labels& other) = delete;
+
+	public:
+
+		[[nodiscard]] id_t intern(std::wstring_view label)
+		{
+			if (label.empty())
+				return empty_id;
+
+			// The keys are the texts of the table: they are never moved and never removed
+			thread_local std::unordered_map<std::wstring_view, id_t> cache{};
+
+			if (const auto found = cache.find(label); found != cache.end())
+				return found->second;
+
+			const auto [text, id] = intern_shared(label);
+			cache.emplace(text, id);
+			return id;
+		}
+
+		[[nodiscard]] std::wstring_view text(id_t id) const
+		{
+			const std::shared_lock lock{ m_mutex };
+
+			assert(id < m_texts.size());
+			return m_texts[id];
+		}
+
+		[[nodiscard]] std::size_t size() const
+		{
+			const std::shared_lock lock{ m_mutex };
+			return m_texts.size();
+		}
+
+	private:
+
+		log_labels()
+			: m_mutex{}
+			, m_texts(1) // The text of empty_id
+			, m_ids{}
+		{}
+
+		[[nodiscard]] std::pair<std::wstring_view, id_t> intern_shared(std::wstring_view label)
+		{
+			{
+				const std::shared_lock lock{ m_mutex };
+
+				if (const auto found = m_ids.find(label); found != m_ids.end())
+					return *found;
+			}
+
+			const std::unique_lock lock{ m_mutex };
+
+			// The other thread could add the label between the locks
+			if (const auto found = m_ids.find(label); found != m_ids.end())
+				return *found;
+
+			const id_t id{ static_cast<id_t>(m_texts.size()) };
+			const std::wstring_view text{ m_texts.emplace_back(label) };
+			m_ids.emplace(text, id);
+
+			return { text, id };
+		}
+
+	private:
+
+		mutable std::shared_mutex m_mutex;
+		std::deque<std::wstring> m_texts;
+		std::unordered_map<std::wstring_view, id_t> m_ids;
+	};
+
+
+	/** \brief Context of log of the chain of promises: the list of the steps from the last one to the first one.
+	 *
+	 * \details The step is the number of its label (see \a log_labels) and the flags of its details, the steps
+	 *          are shared by the chains with the common beginning. So the next step of the chain is one small
+	 *          allocation instead of the copy of the text, and the text (e.g. "a/b/c{scss|fnly}") is made
+	 *          only by the logger, which really writes it (see \a append_to).
+	 *
+	 * \details The steps are immutable after they are shared: \a add_details of the shared step makes its copy.
+	 */
+	class interned_log_ctx
+	{
+	public:
+
+		static constexpr wchar_t node_separator{ L'/' };
+		static constexpr wchar_t node_replace_separator{ L'\\' };
+
+		/** \brief Names of the details in the order of the text.
+		 */
+		static constexpr std::array<std::wstring_view, 12> details_names{
+			std::wstring_view{ L"task" },
+			std::wstring_view{ L"delay" },
+			std::wstring_view{ L"every" },
+			std::wstring_view{ L"all" },
+			std::wstring_view{ L"sync" },
+			std::wstring_view{ L"coro" },
+			std::wstring_view{ L"scss" },
+			std::wstring_view{ L"scss-skip" },
+			std::wstring_view{ L"rjct" },
+			std::wstring_view{ L"rjct-skip" },
+			std::wstring_view{ L"prom" },
+			std::wstring_view{ L"fnly" }
+		};
+
+		using details_t = std::uint16_t;
+
+		static_assert(details_names.size() <= 8 * sizeof(details_t));
+
+	public:
+
+		interned_log_ctx() noexcept
+			: m_node{}
+		{}
+
+		template<class _Text, class = std::enable_if_t<std::is_convertible_v<const _Text&, std::wstring_view>>>
+		interned_log_ctx(const _Text& label)
+			: m_node{}
+		{
+			const std::wstring_view label_view{ label };
+
+			if (!label_view.empty())
+				m_node = node_t::make(nullptr, intern_label(label_view), 0);
+		}
+
+	public:
+
+		[[nodiscard]] bool empty() const noexcept
+		{
+			return !m_node;
+		}
+
+		void swap(interned_log_ctx& other) noexcept
+		{
+			m_node.swap(other.m_node);
+		}
+
+		/** \brief Number of the label of the last step (see \a log_labels::text).
+		 */
+		[[nodiscard]] log_labels::id_t label_id() const noexcept
+		{
+			return (m_node ? m_node->label_id : log_labels::empty_id);
+		}
+
+		[[nodiscard]] details_t details_flags() const noexcept
+		{
+			return (m_node ? m_node->details_flags : 0);
+		}
+
+		[[nodiscard]] static details_t details_flag(std::wstring_view details_view) noexcept
+		{
+			for (std::size_t index = 0; index < details_names.size(); ++index)
+			{
+				if (details_names[index] == details_view)
+					return static_cast<details_t>(1u << index);
+			}
+
+			assert(false && "Unknown details of the context of log");
+			return 0;
+		}
+
+		/** \brief Add the steps of \a next_ctx after the last step (the empty \a next_ctx is the step with the empty label).
+		 */
+		void append(const interned_log_ctx& next_ctx)
+		{
+			if (next_ctx.empty())
+				m_node = node_t::make(m_node.get(), log_labels::empty_id, 0);
+			else
+				append_nodes(next_ctx.m_node.get());
+		}
+
+		void add_details(std::wstring_view details_view)
+		{
+			const details_t flag{ details_flag(details_view) };
+
+			if (!m_node)
+				m_node = node_t::make(nullptr, log_labels::empty_id, flag);
+			else
+			if (m_node->refs_count.load(std::memory_order_acquire) != 1)
+				m_node = node_t::make(m_node->parent, m_node->label_id, m_node->details_flags | flag);
+			else
+				m_node->details_flags |= flag;
+		}
+
+		void append_to(std::wstring& str) const
+		{
+			std::vector<const node_t*> nodes{};
+
+			for (const node_t* node = m_node.get(); node; node = node->parent)
+				nodes.push_back(node);
+
+			const log_labels& labels{ log_labels::instance() };
+
+			for (auto node_it = nodes.rbegin(); node_it != nodes.rend(); ++node_it)
+			{
+				const node_t& node{ **node_it };
+
+				if (node_it != nodes.rbegin())
+					str += node_separator;
+
+				if (node.label_id != log_labels::empty_id)
+					str += labels.text(node.label_id);
+
+				if (node.details_flags != 0)
+				{
+					wchar_t delimiter{ L'{' };
+
+					for (std::size_t index = 0; index < details_names.size(); ++index)
+					{
+						if (node.details_flags & (1u << index))
+						{
+							str += delimiter;
+							str += details_names[index];
+							delimiter = L'|';
+						}
+					}
+
+					str += L'}';
+				}
+			}
+		}
+
+		[[nodiscard]] std::wstring str() const
+		{
+			std::wstring result{};
+			append_to(result);
+			return result;
+		}
+
+	private:
+
+		struct node_t
+		{
+			std::atomic<std::size_t> refs_count;
+			node_t* const parent; // Owns one reference
+			const log_labels::id_t label_id;
+			details_t details_flags;
+
+			node_t(node_t* parent, log_labels::id_t label_id, details_t details_flags) noexcept
+				: refs_count{ 1 }
+				, parent{ parent }
+				, label_id{ label_id }
+				, details_flags{ details_flags }
+			{
+				if (parent)
+					intrusive_ptr_add_ref(parent);
+			}
+
+			[[nodiscard]] static details::intrusive_ptr<node_t> make(node_t* parent, log_labels::id_t label_id, details_t details_flags)
+			{
+				return details::intrusive_ptr<node_t>::adopt(new node_t{ parent, label_id, details_flags });
+			}
+
+			friend void intrusive_ptr_add_ref(node_t* node) noexcept
+			{
+				node->refs_count.fetch_add(1, std::memory_order_relaxed);
+			}
+
+			friend void intrusive_ptr_release(node_t* node) noexcept
+			{
+				// Not recursive: the chain of the long loop of promises may have any length
+				while (node && node->refs_count.fetch_sub(1, std::memory_order_acq_rel) == 1)
+				{
+					node_t* const parent{ node->parent };
+					delete node;
+					node = parent;
+				}
+			}
+		};
+
+	private:
+
+		[[nodiscard]] static log_labels::id_t intern_label(std::wstring_view label_view)
+		{
+			if (label_view.find(node_separator) == std::wstring_view::npos)
+				return log_labels::instance().intern(label_view);
+
+			std::wstring label{ label_view };
+
+			for (wchar_t& ch : label)
+			{
+				if (ch == node_separator)
+					ch = node_replace_separator;
+			}
+
+			return log_labels::instance().intern(label);
+		}
+
+		void append_nodes(const node_t* node)
+		{
+			if (node->parent)
+				append_nodes(node->parent);
+
+			m_node = node_t::make(m_node.get(), node->label_id, node->details_flags);
+		}
+
+	private:
+
+		details::intrusive_ptr<node_t> m_node;
+	};
+
+} // namespace async
@@ -4,16 +4,21 @@
 #include <tuple>
 #include <cwchar>
 #include <string>
+#include <cstdint>
 #include <exception>
 #include <string_view>
+#include <type_traits>
 
-#include <async\config.hpp>
+#include <async/config.hpp>
+#include <async/log_labels.hpp>
 
 
 namespace async
 {
     using namespace std::literals::string_literals;
     using namespace std::literals::string_view_literals;
+
+    class pool;
     
     class ASYNC_LIB_API logger
     {
@@ -29,8 +34,55 @@ namespace async
         virtual void exception(std::exception_ptr except, std::wstring_view failed_action) noexcept = 0;
         virtual void enter_to_scope(std::wstring_view scope_name) noexcept = 0;
         virtual void leave_scope(std::wstring_view scope_name) noexcept = 0;
+
+    public: // Tracing of the tasks of pool (see \a logger_trace), by default the tasks are not traced
+
+        /** \brief The task is added in the queue of \a pool_impl.
+         *
+         * \return The identifier of the task for \a task_dequeued and \a task_finished, or 0 if the task is not traced.
+         */
+        virtual std::uint64_t task_enqueued(const pool& pool_impl) noexcept
+        {
+            (void)pool_impl;
+            return 0;
+        }
+
+        /** \brief The thread of pool took the traced task from the queue and starts it.
+         */
+        virtual void task_dequeued(std::uint64_t task_id) noexcept
+        {
+            (void)task_id;
+        }
+
+        virtual void task_finished(std::uint64_t task_id) noexcept
+        {
+            (void)task_id;
+        }
     };
 
+    /** \brief Context of log with \a ASYNC_LIB_NO_LOGGING: it takes no memory and all operations with it do nothing.
+     */
+    struct no_log_ctx
+    {
+        constexpr no_log_ctx() noexcept = default;
+
+        template<class _Text, class = std::enable_if_t<std::is_convertible_v<const _Text&, std::wstring_view>>>
+        constexpr no_log_ctx(const _Text&) noexcept
+        {}
+
+        constexpr void swap(no_log_ctx&) noexcept
+        {}
+
+        [[nodiscard]] constexpr bool empty() const noexcept
+        {
+            return true;
+        }
+    };
+
+    /** \brief Context of log in the public API and in the state of promise (the text is made only for the logger).
+     */
+    using log_ctx_t = std::conditional_t<logging_enabled, interned_log_ctx, no_log_ctx>;
+
 } // namespace async
 
 
@@ -45,14 +97,18 @@ namespace async // impl
         template<> constexpr std::size_t max_dec_unsigned_chars_count<8>{ 20 };
         template<class number_t> constexpr std::size_t max_dec_chars_count{ max_dec_unsigned_chars_count<sizeof(number_t)> + (std::is_signed_v<number_t> ? 1 : 0) };
 
+        template<class> constexpr bool unsupported_arg_v{ false };
+
         template<class number_t> constexpr const wchar_t* format{ L"" };
         template<> constexpr const wchar_t* format<  signed char>     { L"%hhi" };
         template<> constexpr const wchar_t* format<  signed short>    { L"%hi"  };
         template<> constexpr const wchar_t* format<  signed int>      { L"%i"   };
+        template<> constexpr const wchar_t* format<  signed long>     { L"%li"  };
         template<> constexpr const wchar_t* format<  signed long long>{ L"%lli" };
         template<> constexpr const wchar_t* format<unsigned char>     { L"%hhu" };
         template<> constexpr const wchar_t* format<unsigned short>    { L"%hu"  };
         template<> constexpr const wchar_t* format<unsigned int>      { L"%u"   };
+        template<> constexpr const wchar_t* format<unsigned long>     { L"%lu"  };
         template<> constexpr const wchar_t* format<unsigned long long>{ L"%llu" };
 
         template<class arg_t>
@@ -66,7 +122,7 @@ namespace async // impl
                 || std::is_same_v<decay_arg_t, std::string>
                 || std::is_same_v<decay_arg_t, std::string_view>)
             {
-                static_assert(false, "The ANSI chars not supported!");
+                static_assert(unsupported_arg_v<arg_t>, "The ANSI chars not supported!");
             }
             else
             if constexpr (std::is_same_v<decay_arg_t, bool>)
@@ -95,13 +151,18 @@ namespace async // impl
                 str.append(arg);
             }
             else
+            if constexpr (std::is_same_v<decay_arg_t, interned_log_ctx>)
+            {
+                arg.append_to(str);
+            }
+            else
             if constexpr (std::is_pointer_v<decay_arg_t>)
             {
                 constexpr std::size_t hex_chars_count{ 2 * sizeof(arg) };
                 const std::size_t old_size{ str.size() };
                 str.resize(old_size + hex_chars_count);
 
-                [[maybe_unused]] const std::size_t write_chars_count = std::swprintf(std::next(str.data(), old_size), (hex_chars_count + 1/*null-terminated*/), L"%p", arg);
+                [[maybe_unused]] const std::size_t write_chars_count = std::swprintf(std::next(str.data(), old_size), (hex_chars_count + 1/*null-terminated*/), L"%0*llX", static_cast<int>(hex_chars_count), static_cast<unsigned long long>(reinterpret_cast<std::uintptr_t>(arg)));
                 assert(write_chars_count == hex_chars_count);
             }
             else
@@ -117,7 +178,7 @@ namespace async // impl
             }
             else
             {
-                static_assert(false, "Not supported type the argument");
+                static_assert(unsupported_arg_v<arg_t>, "Not supported type the argument");
             }
         }
         
@@ -156,15 +217,18 @@ namespace async // impl
     >
     inline void log_msg(logger* log, args_t&&... args) noexcept(args_api::one_arg__str_or_view)
     {
-        if (log)
+        if constexpr (logging_enabled)
         {
-            if constexpr (args_api::one_arg__str_or_view)
-            {
-                log->message(std::forward<args_t>(args)...);
-            }
-            else
+            if (log)
             {
-                log->message(log_details::make_string(std::forward<args_t>(args)...));
+                if constexpr (args_api::one_arg__str_or_view)
+                {
+                    log->message(std::forward<args_t>(args)...);
+                }
+                else
+                {
+                    log->message(log_details::make_string(std::forward<args_t>(args)...));
+                }
             }
         }
     }
@@ -175,19 +239,35 @@ namespace async // impl
     >
     inline void log_except(logger* log, std::exception_ptr except, args_t&&... args) noexcept(args_api::one_arg__str_or_view)
     {
-        if (log)
+        if constexpr (logging_enabled)
         {
-            if constexpr (args_api::one_arg__str_or_view)
+            if (log)
             {
-                log->exception(except, std::forward<args_t>(args)...);
-            }
-            else
-            {
-                log->exception(except, log_details::make_string(std::forward<args_t>(args)...));
+                if constexpr (args_api::one_arg__str_or_view)
+                {
+                    log->exception(except, std::forward<args_t>(args)...);
+                }
+                else
+                {
+                    log->exception(except, log_details::make_string(std::forward<args_t>(args)...));
+                }
             }
         }
     }
 
+#ifdef ASYNC_LIB_NO_LOGGING
+
+    class log_scope
+    {
+    public:
+
+        template<class... args_t>
+        inline log_scope(logger*, args_t&&...) noexcept
+        {}
+    };
+
+#else
+
     class log_scope
     {
     public:
@@ -235,4 +315,6 @@ namespace async // impl
         std::wstring m_name;
     };
 
+#endif // ASYNC_LIB_NO_LOGGING
+
 } // namespace async
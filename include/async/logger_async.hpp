@@ -0,0 +1,169 @@
+#pragma once
+
+#include <mutex>
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <thread>
+#include <vector>
+#include <cstdint>
+#include <iostream>
+#include <condition_variable>
+
+#include <async/logger.hpp>
+
+
+namespace async
+{
+
+    /** \brief Logger, which writes to the stream from its own thread (the format is the same as of \a logger_wostream).
+     *
+     * \details The calls of the logger only copy the text with the raw time (\a std::chrono::steady_clock)
+     *          to the lock-free ring buffer of the calling thread. The thread of the logger formats the records
+     *          of all buffers and writes them, with one flush of the stream for every pass.
+     *
+     * \details If the buffer of the thread is full the record is dropped (\a overflow_policy::drop, see \a dropped_count)
+     *          or the thread waits for the free space (\a overflow_policy::block). The records of one thread
+     *          are written in their order, the records of different threads are not ordered.
+     *
+     * \details All records made before \a flush or before the destructor are written by them.
+     */
+    class ASYNC_LIB_API logger_async : public logger
+    {
+
+    public:
+
+        enum class overflow_policy
+        {
+            drop,
+            block,
+        };
+
+        static constexpr std::size_t default_buffer_size{ 64 * 1024 };
+
+    public:
+
+        /** \param buffer_size The size (in bytes) of the buffer of every thread, it is rounded up to the power of two.
+         */
+        logger_async(std::wostream& stream, overflow_policy overflow = overflow_policy::block, std::size_t buffer_size = default_buffer_size);
+
+        virtual ~logger_async() override;
+
+        logger_async(logger_async&& other) = delete;
+        logger_async(const logger_async& other) = delete;
+
+        logger_async& operator=(logger_async&& other) = delete;
+        logger_async& operator=(const logger_async& other) = delete;
+
+    public:
+
+        virtual void message(std::wstring_view text) noexcept override;
+
+        virtual void exception(std::exception_ptr except, std::wstring_view failed_action) noexcept override;
+
+        virtual void enter_to_scope(std::wstring_view scope_name) noexcept override;
+
+        virtual void leave_scope(std::wstring_view scope_name) noexcept override;
+
+    public:
+
+        /** \brief Wait until all records, made before the call, are written to the stream.
+         */
+        void flush();
+
+        /** \brief Number of the records dropped because of the full buffer (\a overflow_policy::drop).
+         */
+        std::size_t dropped_count() const noexcept;
+
+    private:
+
+        enum class record_kind : std::uint16_t
+        {
+            padding, // The rest of the buffer till its end is not used
+            message,
+            exception,
+            enter_to_scope,
+            enter_to_scope_except,
+            leave_scope,
+            leave_scope_except,
+        };
+
+        struct record_t
+        {
+            std::int64_t time;       // std::chrono::steady_clock::duration::rep
+            std::uint32_t chars;     // Count of the chars of the text after the record
+            record_kind kind;
+            std::uint16_t scope_level;
+        };
+
+        static constexpr std::size_t record_align{ sizeof(record_t) };
+
+        /** \brief Buffer of one thread: one writing thread (the owner) and one reading thread (of the logger).
+         */
+        struct ring_t
+        {
+            explicit ring_t(std::size_t size);
+
+            alignas(64) std::atomic<std::uint64_t> head; // Written by the owner
+            alignas(64) std::atomic<std::uint64_t> tail; // Written by the thread of the logger
+            alignas(64) std::atomic<bool> owned;         // The owner thread is alive
+            const std::size_t size;
+            const std::unique_ptr<std::byte[]> data;
+        };
+
+    private:
+
+        static std::uint64_t next_id() noexcept;
+
+        static std::uint16_t& this_thread_scope_level() noexcept;
+
+        static constexpr std::size_t record_bytes(std::size_t chars) noexcept
+        {
+            return (sizeof(record_t) + chars * sizeof(wchar_t) + record_align - 1) / record_align * record_align;
+        }
+
+        void record(record_kind kind, std::wstring_view text) noexcept;
+
+        ring_t& this_thread_ring();
+
+        std::shared_ptr<ring_t> take_ring();
+
+        void writer_loop() noexcept;
+
+        bool write_ring(ring_t& ring);
+
+        void write_record(const record_t& record, std::wstring_view text);
+
+        std::size_t print_head(std::int64_t time, std::size_t scope_level);
+
+        std::wostream& print_multiline(std::size_t head_size, std::wstring_view text);
+
+    private:
+
+        std::wostream& m_str_ref;
+        const overflow_policy m_overflow;
+        const std::size_t m_buffer_size;
+        const std::uint64_t m_id;
+        const std::chrono::steady_clock::time_point m_start_steady;
+        const std::chrono::system_clock::time_point m_start_system;
+
+        std::atomic<std::size_t> m_dropped_count;
+
+        std::mutex m_mutex;
+        std::condition_variable m_writer_cv;
+        std::condition_variable m_flush_cv;
+        std::vector<std::shared_ptr<ring_t>> m_rings;
+        bool m_rings_changed;
+        std::uint64_t m_flush_requested;
+        std::uint64_t m_flush_completed;
+        bool m_stop;
+
+        std::thread m_writer;
+    };
+
+} // namespace async
+
+
+#ifdef ASYNC_LIB_HEADERS_ONLY
+#   include <async/logger_async_impl.hpp>
+#endif
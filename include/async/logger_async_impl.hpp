@@ -0,0 +1,384 @@
+
+#include <ctime>
+#include <cassert>
+#include <cstring>
+#include <iterator>
+#include <algorithm>
+
+#include <async/logger_async.hpp>
+
+
+namespace async
+{
+
+    ASYNC_INLINE logger_async::ring_t::ring_t(std::size_t size)
+        : head{ 0 }
+        , tail{ 0 }
+        , owned{ true }
+        , size{ size }
+        , data{ std::make_unique<std::byte[]>(size) }
+    {}
+
+    ASYNC_INLINE logger_async::logger_async(std::wostream& stream, overflow_policy overflow, std::size_t buffer_size)
+        : logger{}
+        , m_str_ref{ stream }
+        , m_overflow{ overflow }
+        , m_buffer_size{ [buffer_size] { std::size_t size{ 1024 }; while (size < buffer_size) size <<= 1; return size; }() }
+        , m_id{ next_id() }
+        , m_start_steady{ std::chrono::steady_clock::now() }
+        , m_start_system{ std::chrono::system_clock::now() }
+        , m_dropped_count{ 0 }
+        , m_mutex{}
+        , m_writer_cv{}
+        , m_flush_cv{}
+        , m_rings{}
+        , m_rings_changed{ false }
+        , m_flush_requested{ 0 }
+        , m_flush_completed{ 0 }
+        , m_stop{ false }
+        , m_writer{}
+    {
+        m_writer = std::thread{ [this] { writer_loop(); } };
+    }
+
+    ASYNC_INLINE logger_async::~logger_async()
+    {
+        {
+            const std::lock_guard lock{ m_mutex };
+            m_stop = true;
+        }
+
+        m_writer_cv.notify_one();
+        m_writer.join();
+    }
+
+    ASYNC_INLINE void logger_async::message(std::wstring_view text) noexcept
+    {
+        record(record_kind::message, text);
+    }
+
+    ASYNC_INLINE void logger_async::exception(std::exception_ptr except, std::wstring_view failed_action) noexcept
+    {
+        (void)except;
+        record(record_kind::exception, failed_action);
+    }
+
+    ASYNC_INLINE void logger_async::enter_to_scope(std::wstring_view scope_name) noexcept
+    {
+        record((!std::uncaught_exceptions() ? record_kind::enter_to_scope : record_kind::enter_to_scope_except), scope_name);
+        this_thread_scope_level() += 1;
+    }
+
+    ASYNC_INLINE void logger_async::leave_scope(std::wstring_view scope_name) noexcept
+    {
+        this_thread_scope_level() -= 1;
+        record((!std::uncaught_exceptions() ? record_kind::leave_scope : record_kind::leave_scope_except), scope_name);
+    }
+
+    ASYNC_INLINE void logger_async::flush()
+    {
+        std::unique_lock lock{ m_mutex };
+
+        const std::uint64_t flush_number{ ++m_flush_requested };
+        m_writer_cv.notify_one();
+
+        m_flush_cv.wait(lock, [this, flush_number] { return (m_flush_completed >= flush_number); });
+    }
+
+    ASYNC_INLINE std::size_t logger_async::dropped_count() const noexcept
+    {
+        return m_dropped_count.load(std::memory_order_relaxed);
+    }
+
+    ASYNC_INLINE std::uint64_t logger_async::next_id() noexcept
+    {
+        static std::atomic<std::uint64_t> s_last_id{ 0 };
+        return s_last_id.fetch_add(1, std::memory_order_relaxed) + 1;
+    }
+
+    ASYNC_INLINE std::uint16_t& logger_async::this_thread_scope_level() noexcept
+    {
+        thread_local std::uint16_t scope_level{ 0 };
+        return scope_level;
+    }
+
+    ASYNC_INLINE void logger_async::record(record_kind kind, std::wstring_view text) noexcept
+    {
+        try
+        {
+            ring_t& ring{ this_thread_ring() };
+
+            // The text longer than a half of the buffer is cut
+            text = text.substr(0, (ring.size / 2 - sizeof(record_t)) / sizeof(wchar_t));
+
+            const std::size_t bytes{ record_bytes(text.size()) };
+            const std::uint64_t head{ ring.head.load(std::memory_order_relaxed) };
+            const std::size_t offset{ static_cast<std::size_t>(head & (ring.size - 1)) };
+            const std::size_t padding{ (ring.size - offset < bytes) ? (ring.size - offset) : 0 };
+
+            while (ring.size - (head - ring.tail.load(std::memory_order_acquire)) < padding + bytes)
+            {
+                if (m_overflow == overflow_policy::drop)
+                {
+                    m_dropped_count.fetch_add(1, std::memory_order_relaxed);
+                    return;
+                }
+
+                m_writer_cv.notify_one();
+                std::this_thread::yield();
+            }
+
+            std::byte* const data{ ring.data.get() };
+
+            if (padding)
+            {
+                const record_t padding_record{ 0, 0, record_kind::padding, 0 };
+                std::memcpy(data + offset, &padding_record, sizeof(record_t));
+            }
+
+            const record_t new_record{
+                std::chrono::steady_clock::now().time_since_epoch().count(),
+                static_cast<std::uint32_t>(text.size()),
+                kind,
+                this_thread_scope_level() };
+
+            std::byte* const record_data{ data + ((offset + padding) & (ring.size - 1)) };
+            std::memcpy(record_data, &new_record, sizeof(record_t));
+            std::memcpy(record_data + sizeof(record_t), text.data(), text.size() * sizeof(wchar_t));
+
+            ring.head.store(head + padding + bytes, std::memory_order_release);
+        }
+        catch (...) {}
+    }
+
+    ASYNC_INLINE logger_async::ring_t& logger_async::this_thread_ring()
+    {
+        // The buffer is returned to the logger when the thread ends (or uses another logger)
+        struct this_thread_ring_t
+        {
+            std::uint64_t logger_id{ 0 };
+            std::shared_ptr<ring_t> ring{};
+
+            ~this_thread_ring_t()
+            {
+                release();
+            }
+
+            void release() noexcept
+            {
+                if (ring)
+                {
+                    ring->owned.store(false, std::memory_order_release);
+                    ring.reset();
+                }
+            }
+        };
+
+        thread_local this_thread_ring_t this_thread{};
+
+        if (this_thread.logger_id != m_id)
+        {
+            this_thread.release();
+            this_thread.ring = take_ring();
+            this_thread.logger_id = m_id;
+        }
+
+        return *this_thread.ring;
+    }
+
+    ASYNC_INLINE std::shared_ptr<logger_async::ring_t> logger_async::take_ring()
+    {
+        const std::lock_guard lock{ m_mutex };
+
+        for (const std::shared_ptr<ring_t>& ring : m_rings)
+        {
+            bool owned{ false };
+            if (ring->owned.compare_exchange_strong(owned, true, std::memory_order_acquire, std::memory_order_relaxed))
+                return ring;
+        }
+
+        m_rings.push_back(std::make_shared<ring_t>(m_buffer_size));
+        m_rings_changed = true;
+
+        return m_rings.back();
+    }
+
+    ASYNC_INLINE void logger_async::writer_loop() noexcept
+    {
+        constexpr std::chrono::milliseconds sleep_time{ 10 };
+
+        std::vector<std::shared_ptr<ring_t>> rings{};
+
+        for (;;)
+        {
+            std::uint64_t flush_requested{ 0 };
+            bool stop{ false };
+
+            {
+                const std::lock_guard lock{ m_mutex };
+
+                if (m_rings_changed)
+                {
+                    rings = m_rings;
+                    m_rings_changed = false;
+                }
+
+                flush_requested = m_flush_requested;
+                stop = m_stop;
+            }
+
+            bool written{ false };
+
+            for (const std::shared_ptr<ring_t>& ring : rings)
+                written = write_ring(*ring) || written;
+
+            try
+            {
+                if (written)
+                    m_str_ref.flush();
+            }
+            catch (...) {}
+
+            std::unique_lock lock{ m_mutex };
+
+            if (m_flush_completed != flush_requested)
+            {
+                m_flush_completed = flush_requested;
+                m_flush_cv.notify_all();
+            }
+
+            // After the stop the buffers are written until they are empty
+            if (written)
+                continue;
+
+            if (stop)
+                break;
+
+            if (!m_stop && !m_rings_changed && m_flush_requested == flush_requested)
+                m_writer_cv.wait_for(lock, sleep_time);
+        }
+    }
+
+    ASYNC_INLINE bool logger_async::write_ring(ring_t& ring)
+    {
+        const std::uint64_t head{ ring.head.load(std::memory_order_acquire) };
+        std::uint64_t tail{ ring.tail.load(std::memory_order_relaxed) };
+
+        if (tail == head)
+            return false;
+
+        const std::byte* const data{ ring.data.get() };
+
+        while (tail != head)
+        {
+            const std::size_t offset{ static_cast<std::size_t>(tail & (ring.size - 1)) };
+
+            record_t record{};
+            std::memcpy(&record, data + offset, sizeof(record_t));
+
+            if (record.kind == record_kind::padding)
+            {
+                tail += ring.size - offset;
+            }
+            else
+            {
+                try
+                {
+                    write_record(record, std::wstring_view{ reinterpret_cast<const wchar_t*>(data + offset + sizeof(record_t)), record.chars });
+                }
+                catch (...) {}
+
+                tail += record_bytes(record.chars);
+            }
+
+            ring.tail.store(tail, std::memory_order_release);
+        }
+
+        return true;
+    }
+
+    ASYNC_INLINE void logger_async::write_record(const record_t& record, std::wstring_view text)
+    {
+        const std::size_t head_size{ print_head(record.time, record.scope_level) };
+
+        switch (record.kind)
+        {
+        case record_kind::message:
+            print_multiline(head_size, text) << L'\n';
+            break;
+
+        case record_kind::exception:
+            m_str_ref << L"[except]"sv << text << L'\n';
+            break;
+
+        case record_kind::enter_to_scope:
+        case record_kind::enter_to_scope_except:
+            m_str_ref << ((record.kind == record_kind::enter_to_scope) ? L"--->"sv : L"exc>"sv) << text << L'\n';
+            break;
+
+        case record_kind::leave_scope:
+        case record_kind::leave_scope_except:
+            m_str_ref << ((record.kind == record_kind::leave_scope) ? L"<---"sv : L"<exc"sv) << text << L'\n';
+            break;
+
+        default:
+            assert(false && "Unknown kind of the record");
+            break;
+        }
+    }
+
+    ASYNC_INLINE std::size_t logger_async::print_head(std::int64_t time, std::size_t scope_level)
+    {
+        const std::chrono::steady_clock::duration since_start{ std::chrono::steady_clock::duration{ time } - m_start_steady.time_since_epoch() };
+
+        const std::time_t t(std::chrono::system_clock::to_time_t(m_start_system + std::chrono::duration_cast<std::chrono::system_clock::duration>(since_start)));
+        const std::tm tm(*std::localtime(&t));
+
+        wchar_t buffer[22] = { L'\0' };
+        const std::size_t head_size = std::swprintf(
+            buffer, std::size(buffer),
+            L"[%.2d.%.2d.%.2d] [%.2d:%.2d:%.2d]",
+            tm.tm_year % 100,
+            tm.tm_mon + 1,
+            tm.tm_mday,
+            tm.tm_hour,
+            tm.tm_min,
+            tm.tm_sec % 60);
+
+        m_str_ref << buffer;
+
+        const std::size_t space_size{ 4 * scope_level + 1 };
+        const std::streamsize save_width = m_str_ref.width(space_size);
+        m_str_ref << L' ';
+        m_str_ref.width(save_width);
+        return head_size + space_size;
+    }
+
+    ASYNC_INLINE std::wostream& logger_async::print_multiline(std::size_t head_size, std::wstring_view text)
+    {
+        constexpr std::wstring_view new_line_markers{ L"\r\n"sv };
+
+        std::size_t pos{ 0 };
+        std::size_t end_pos{ text.find_first_of(new_line_markers, pos) };
+
+        while (end_pos != text.npos)
+        {
+            m_str_ref << text.substr(pos, end_pos - pos);
+            pos = text.find_first_not_of(new_line_markers, end_pos + 1);
+            if (pos == text.npos)
+                break;
+
+            end_pos = text.find_first_of(new_line_markers, pos + 1);
+
+            m_str_ref << L'\n';
+            m_str_ref.width(head_size);
+            m_str_ref << L' ';
+        }
+
+        if (pos != text.npos)
+            m_str_ref << text.substr(pos);
+
+        return m_str_ref;
+    }
+
+} // namespace async
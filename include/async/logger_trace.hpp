@@ -0,0 +1,143 @@
+#pragma once
+
+#include <map>
+#include <mutex>
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <ostream>
+
+#include <async/logger.hpp>
+
+
+namespace async
+{
+
+    /** \brief Logger, which records the life of the tasks of pools for the trace viewer (chrome://tracing or ui.perfetto.dev).
+     *
+     * \details For every task, added in the queue of the pool by the promises or by \a manager, it records
+     *          the enqueue, the dequeue (the start in the thread of pool) and the finish. The scopes of log
+     *          (the steps of the chains with their contexts of log) are the nested slices of the task,
+     *          the messages and the exceptions are the instant events.
+     *
+     * \details \a write makes the JSON of the Chrome Trace Event Format: the slices of the tasks on the threads
+     *          (thread of pool is named by the pool and its number in the pool), the asynchronous slices "queue"
+     *          from the enqueue to the dequeue, and the flow arrows from the task, which added the task
+     *          in the queue (e.g. resolved the promise), to the added task.
+     *
+     * \details Every thread records the events to its own list (under its own mutex, which is locked only by \a write),
+     *          the events are kept until the destruction of the logger. The destructor writes the trace (the pool
+     *          owns its logger, so it is destroyed after the threads of pool). All messages are also passed to \a text_log.
+     */
+    class ASYNC_LIB_API logger_trace : public logger
+    {
+
+    public:
+
+        explicit logger_trace(std::ostream& stream, std::unique_ptr<logger> text_log = nullptr);
+
+        virtual ~logger_trace() override;
+
+        logger_trace(logger_trace&& other) = delete;
+        logger_trace(const logger_trace& other) = delete;
+
+        logger_trace& operator=(logger_trace&& other) = delete;
+        logger_trace& operator=(const logger_trace& other) = delete;
+
+    public:
+
+        virtual void message(std::wstring_view text) noexcept override;
+
+        virtual void exception(std::exception_ptr except, std::wstring_view failed_action) noexcept override;
+
+        virtual void enter_to_scope(std::wstring_view scope_name) noexcept override;
+
+        virtual void leave_scope(std::wstring_view scope_name) noexcept override;
+
+        virtual std::uint64_t task_enqueued(const pool& pool_impl) noexcept override;
+
+        virtual void task_dequeued(std::uint64_t task_id) noexcept override;
+
+        virtual void task_finished(std::uint64_t task_id) noexcept override;
+
+    public:
+
+        /** \brief Write the events recorded until now to the stream: the JSON of the Chrome Trace Event Format (UTF-8).
+         *
+         * \details The pool is named by \a pool::name (the pool without the name is "pool N").
+         */
+        void write() const;
+
+    private:
+
+        enum class event_kind : std::uint8_t
+        {
+            enqueue,
+            dequeue,
+            finish,
+            enter_to_scope,
+            leave_scope,
+            message,
+            exception,
+        };
+
+        struct event_t
+        {
+            std::int64_t time;      // std::chrono::steady_clock::duration::rep
+            event_kind kind;
+            std::uint64_t task_id;
+            std::uint64_t from_task_id; // enqueue: the task of the thread, which adds the task in the queue
+            const pool* pool_ptr;       // enqueue: the pool of the task
+            std::wstring text;
+        };
+
+        /** \brief Events of one thread.
+         */
+        struct thread_events_t
+        {
+            mutable std::mutex mutex;
+            std::size_t thread_number;
+            const pool* pool_ptr;           // The pool of the thread (see pool::current_ctx)
+            std::size_t pool_thread_number;
+            const pool* named_pool;         // The last pool, whose name is known by the logger (used only by the thread)
+            std::vector<std::uint64_t> running_tasks;
+            std::vector<event_t> events;
+        };
+
+    private:
+
+        static std::uint64_t next_id() noexcept;
+
+        thread_events_t& this_thread_events();
+
+        void add_event(event_kind kind, std::uint64_t task_id, const pool* pool_ptr, std::wstring_view text) noexcept;
+
+        void add_pool_name(const pool* pool_ptr);
+
+        static void append_json(std::string& json, std::wstring_view text);
+
+        void append_time(std::string& json, std::int64_t time) const;
+
+    private:
+
+        std::ostream& m_stream;
+        const std::unique_ptr<logger> m_text_log;
+        const std::uint64_t m_id;
+        const std::chrono::steady_clock::time_point m_start;
+
+        std::atomic<std::uint64_t> m_last_task_id;
+
+        mutable std::mutex m_mutex;
+        std::vector<std::unique_ptr<thread_events_t>> m_threads;
+        std::map<const pool*, std::wstring> m_pool_names;
+    };
+
+} // namespace async
+
+
+#ifdef ASYNC_LIB_HEADERS_ONLY
+#   include <async/logger_trace_impl.hpp>
+#endif
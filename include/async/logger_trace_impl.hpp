@@ -0,0 +1,374 @@
+
+#include <map>
+#include <set>
+#include <cstdio>
+#include <cassert>
+#include <iterator>
+
+#include <async/pool.hpp>
+#include <async/logger_trace.hpp>
+
+
+namespace async
+{
+
+    ASYNC_INLINE logger_trace::logger_trace(std::ostream& stream, std::unique_ptr<logger> text_log)
+        : logger{}
+        , m_stream{ stream }
+        , m_text_log{ std::move(text_log) }
+        , m_id{ next_id() }
+        , m_start{ std::chrono::steady_clock::now() }
+        , m_last_task_id{ 0 }
+        , m_mutex{}
+        , m_threads{}
+        , m_pool_names{}
+    {}
+
+    ASYNC_INLINE logger_trace::~logger_trace()
+    {
+        try
+        {
+            write();
+        }
+        catch (...) {}
+    }
+
+    ASYNC_INLINE void logger_trace::message(std::wstring_view text) noexcept
+    {
+        add_event(event_kind::message, 0, nullptr, text);
+
+        if (m_text_log)
+            m_text_log->message(text);
+    }
+
+    ASYNC_INLINE void logger_trace::exception(std::exception_ptr except, std::wstring_view failed_action) noexcept
+    {
+        add_event(event_kind::exception, 0, nullptr, failed_action);
+
+        if (m_text_log)
+            m_text_log->exception(except, failed_action);
+    }
+
+    ASYNC_INLINE void logger_trace::enter_to_scope(std::wstring_view scope_name) noexcept
+    {
+        add_event(event_kind::enter_to_scope, 0, nullptr, scope_name);
+
+        if (m_text_log)
+            m_text_log->enter_to_scope(scope_name);
+    }
+
+    ASYNC_INLINE void logger_trace::leave_scope(std::wstring_view scope_name) noexcept
+    {
+        add_event(event_kind::leave_scope, 0, nullptr, scope_name);
+
+        if (m_text_log)
+            m_text_log->leave_scope(scope_name);
+    }
+
+    ASYNC_INLINE std::uint64_t logger_trace::task_enqueued(const pool& pool_impl) noexcept
+    {
+        const std::uint64_t task_id{ m_last_task_id.fetch_add(1, std::memory_order_relaxed) + 1 };
+        add_event(event_kind::enqueue, task_id, &pool_impl, {});
+        return task_id;
+    }
+
+    ASYNC_INLINE void logger_trace::task_dequeued(std::uint64_t task_id) noexcept
+    {
+        add_event(event_kind::dequeue, task_id, nullptr, {});
+    }
+
+    ASYNC_INLINE void logger_trace::task_finished(std::uint64_t task_id) noexcept
+    {
+        add_event(event_kind::finish, task_id, nullptr, {});
+    }
+
+    ASYNC_INLINE void logger_trace::write() const
+    {
+        const std::lock_guard lock{ m_mutex };
+
+        // The locks of the threads are taken one by one: the events of the thread are written as one part
+
+        std::map<const pool*, std::wstring> pool_names{ m_pool_names };
+        std::set<std::uint64_t> flows{};
+
+        const auto pool_name = [&pool_names](const pool* pool_ptr) -> const std::wstring&
+        {
+            std::wstring& name{ pool_names[pool_ptr] };
+            if (name.empty())
+                name = L"pool "s + std::to_wstring(pool_names.size());
+
+            return name;
+        };
+
+        for (const std::unique_ptr<thread_events_t>& thread_events : m_threads)
+        {
+            const std::lock_guard thread_lock{ thread_events->mutex };
+
+            for (const event_t& event : thread_events->events)
+            {
+                if (event.kind == event_kind::enqueue && event.from_task_id != 0)
+                    flows.insert(event.task_id);
+            }
+        }
+
+        std::string json{ "{\"traceEvents\":[\n{\"ph\":\"M\",\"pid\":1,\"name\":\"process_name\",\"args\":{\"name\":\"async\"}}" };
+
+        for (const std::unique_ptr<thread_events_t>& thread_events : m_threads)
+        {
+            const std::lock_guard thread_lock{ thread_events->mutex };
+
+            const std::string tid{ std::to_string(thread_events->thread_number) };
+
+            json += ",\n{\"ph\":\"M\",\"pid\":1,\"tid\":";
+            json += tid;
+            json += ",\"name\":\"thread_name\",\"args\":{\"name\":\"";
+            if (thread_events->pool_ptr)
+                append_json(json, pool_name(thread_events->pool_ptr) + L" #"s + std::to_wstring(thread_events->pool_thread_number));
+            else
+                append_json(json, L"thread "s + std::to_wstring(thread_events->thread_number));
+            json += "\"}}";
+
+            for (const event_t& event : thread_events->events)
+            {
+                const auto append_head = [this, &json, &tid, &event](const char* phase)
+                {
+                    json += ",\n{\"ph\":\"";
+                    json += phase;
+                    json += "\",\"pid\":1,\"tid\":";
+                    json += tid;
+                    json += ",\"ts\":";
+                    append_time(json, event.time);
+                };
+
+                switch (event.kind)
+                {
+                case event_kind::enqueue:
+                    append_head("b");
+                    json += ",\"cat\":\"queue\",\"name\":\"queue\",\"id\":";
+                    json += std::to_string(event.task_id);
+                    json += ",\"args\":{\"pool\":\"";
+                    append_json(json, pool_name(event.pool_ptr));
+                    json += "\"}}";
+
+                    if (event.from_task_id != 0)
+                    {
+                        append_head("s");
+                        json += ",\"cat\":\"flow\",\"name\":\"next\",\"id\":";
+                        json += std::to_string(event.task_id);
+                        json += "}";
+                    }
+                    break;
+
+                case event_kind::dequeue:
+                    append_head("e");
+                    json += ",\"cat\":\"queue\",\"name\":\"queue\",\"id\":";
+                    json += std::to_string(event.task_id);
+                    json += "}";
+
+                    append_head("B");
+                    json += ",\"cat\":\"task\",\"name\":\"task\",\"args\":{\"task\":";
+                    json += std::to_string(event.task_id);
+                    json += "}}";
+
+                    if (flows.count(event.task_id))
+                    {
+                        append_head("f");
+                        json += ",\"bp\":\"e\",\"cat\":\"flow\",\"name\":\"next\",\"id\":";
+                        json += std::to_string(event.task_id);
+                        json += "}";
+                    }
+                    break;
+
+                case event_kind::finish:
+                    append_head("E");
+                    json += ",\"cat\":\"task\",\"name\":\"task\"}";
+                    break;
+
+                case event_kind::enter_to_scope:
+                case event_kind::leave_scope:
+                    append_head((event.kind == event_kind::enter_to_scope) ? "B" : "E");
+                    json += ",\"cat\":\"scope\",\"name\":\"";
+                    append_json(json, event.text);
+                    json += "\"}";
+                    break;
+
+                case event_kind::message:
+                case event_kind::exception:
+                    append_head("i");
+                    json += ",\"s\":\"t\",\"cat\":\"";
+                    json += ((event.kind == event_kind::message) ? "message" : "except");
+                    json += "\",\"name\":\"";
+                    append_json(json, event.text);
+                    json += "\"}";
+                    break;
+
+                default:
+                    assert(false && "Unknown kind of the event");
+                    break;
+                }
+            }
+        }
+
+        json += "\n],\"displayTimeUnit\":\"ms\"}\n";
+
+        m_stream.write(json.data(), static_cast<std::streamsize>(json.size()));
+        m_stream.flush();
+    }
+
+    ASYNC_INLINE std::uint64_t logger_trace::next_id() noexcept
+    {
+        static std::atomic<std::uint64_t> s_last_id{ 0 };
+        return s_last_id.fetch_add(1, std::memory_order_relaxed) + 1;
+    }
+
+    ASYNC_INLINE logger_trace::thread_events_t& logger_trace::this_thread_events()
+    {
+        // The events of the thread are kept by the logger: the pointers are found by the identifiers of the loggers,
+        // which are never reused, so the thread keeps its number and its running tasks while it alternates the loggers
+        struct this_thread_events_t
+        {
+            std::uint64_t last_logger_id{ 0 };
+            thread_events_t* last_events{ nullptr };
+            std::map<std::uint64_t, thread_events_t*> events_of_loggers;
+        };
+
+        thread_local this_thread_events_t this_thread{};
+
+        if (this_thread.last_logger_id == m_id)
+            return *this_thread.last_events;
+
+        thread_events_t*& events_of_logger{ this_thread.events_of_loggers[m_id] };
+
+        if (!events_of_logger)
+        {
+            std::unique_ptr<thread_events_t> events{ std::make_unique<thread_events_t>() };
+
+            const pool::ctx_t pool_ctx{ pool::current_ctx() };
+            events->pool_ptr = std::get<pool*>(pool_ctx);
+            events->pool_thread_number = std::get<std::size_t>(pool_ctx);
+            events->named_pool = nullptr;
+
+            add_pool_name(events->pool_ptr);
+
+            const std::lock_guard lock{ m_mutex };
+
+            events->thread_number = m_threads.size();
+            m_threads.push_back(std::move(events));
+
+            events_of_logger = m_threads.back().get();
+        }
+
+        this_thread.last_logger_id = m_id;
+        this_thread.last_events = events_of_logger;
+
+        return *events_of_logger;
+    }
+
+    ASYNC_INLINE void logger_trace::add_event(event_kind kind, std::uint64_t task_id, const pool* pool_ptr, std::wstring_view text) noexcept
+    {
+        try
+        {
+            thread_events_t& thread_events{ this_thread_events() };
+
+            if (pool_ptr && pool_ptr != thread_events.named_pool)
+            {
+                add_pool_name(pool_ptr);
+                thread_events.named_pool = pool_ptr;
+            }
+
+            const std::lock_guard lock{ thread_events.mutex };
+
+            std::uint64_t from_task_id{ 0 };
+
+            if (kind == event_kind::enqueue && !thread_events.running_tasks.empty())
+                from_task_id = thread_events.running_tasks.back();
+            else
+            if (kind == event_kind::dequeue)
+                thread_events.running_tasks.push_back(task_id);
+            else
+            if (kind == event_kind::finish && !thread_events.running_tasks.empty())
+                thread_events.running_tasks.pop_back();
+
+            thread_events.events.push_back(event_t{ std::chrono::steady_clock::now().time_since_epoch().count(), kind, task_id, from_task_id, pool_ptr, std::wstring{ text } });
+        }
+        catch (...) {}
+    }
+
+    ASYNC_INLINE void logger_trace::add_pool_name(const pool* pool_ptr)
+    {
+        if (pool_ptr && !pool_ptr->name().empty())
+        {
+            const std::lock_guard lock{ m_mutex };
+            m_pool_names[pool_ptr] = pool_ptr->name();
+        }
+    }
+
+    ASYNC_INLINE void logger_trace::append_json(std::string& json, std::wstring_view text)
+    {
+        // UTF-8 (wchar_t is UTF-16 on Windows and UTF-32 on the others) with the escapes of JSON
+
+        for (std::size_t index = 0; index < text.size(); ++index)
+        {
+            std::uint32_t code{ static_cast<std::uint32_t>(text[index]) };
+
+            if (code >= 0xD800 && code <= 0xDBFF && index + 1 < text.size())
+            {
+                const std::uint32_t low{ static_cast<std::uint32_t>(text[index + 1]) };
+                if (low >= 0xDC00 && low <= 0xDFFF)
+                {
+                    code = 0x10000 + ((code - 0xD800) << 10) + (low - 0xDC00);
+                    index += 1;
+                }
+            }
+
+            if (code == '"' || code == '\\')
+            {
+                json += '\\';
+                json += static_cast<char>(code);
+            }
+            else
+            if (code < 0x20)
+            {
+                char buffer[8] = { '\0' };
+                std::snprintf(buffer, std::size(buffer), "\\u%04x", static_cast<unsigned int>(code));
+                json += buffer;
+            }
+            else
+            if (code < 0x80)
+            {
+                json += static_cast<char>(code);
+            }
+            else
+            if (code < 0x800)
+            {
+                json += static_cast<char>(0xC0 | (code >> 6));
+                json += static_cast<char>(0x80 | (code & 0x3F));
+            }
+            else
+            if (code < 0x10000)
+            {
+                json += static_cast<char>(0xE0 | (code >> 12));
+                json += static_cast<char>(0x80 | ((code >> 6) & 0x3F));
+                json += static_cast<char>(0x80 | (code & 0x3F));
+            }
+            else
+            {
+                json += static_cast<char>(0xF0 | (code >> 18));
+                json += static_cast<char>(0x80 | ((code >> 12) & 0x3F));
+                json += static_cast<char>(0x80 | ((code >> 6) & 0x3F));
+                json += static_cast<char>(0x80 | (code & 0x3F));
+            }
+        }
+    }
+
+    ASYNC_INLINE void logger_trace::append_time(std::string& json, std::int64_t time) const
+    {
+        // Microseconds from the creation of the logger
+        const std::chrono::duration<double, std::micro> since_start{ std::chrono::steady_clock::duration{ time } - m_start.time_since_epoch() };
+
+        char buffer[32] = { '\0' };
+        std::snprintf(buffer, std::size(buffer), "%.3f", since_start.count());
+        json += buffer;
+    }
+
+} // namespace async
@@ -3,7 +3,7 @@
 
 #include <iostream>
 
-#include <async\logger.hpp>
+#include <async/logger.hpp>
 
 
 namespace async
@@ -41,5 +41,5 @@ namespace async
 
 
 #ifdef ASYNC_LIB_HEADERS_ONLY
-#   include <async\logger_wostream_impl.hpp>
+#   include <async/logger_wostream_impl.hpp>
 #endif
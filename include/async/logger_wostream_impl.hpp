@@ -3,7 +3,7 @@
 #include <thread>
 #include <cassert>
 
-#include <async\logger_wostream.hpp>
+#include <async/logger_wostream.hpp>
 
 
 namespace async
@@ -1,7 +1,10 @@
 
 #pragma once
 
-#include <async\promise.hpp>
+#include <atomic>
+
+#include <async/promise.hpp>
+#include <async/timer_wheel.hpp>
 
 
 namespace async
@@ -21,6 +24,9 @@ namespace async
 		template<class _Result>
 		friend class promise;
 
+		template<class _Value>
+		friend class details::coroutine_promise_base;
+
 		template<class _PoolImpl, class... _PoolArgs>
 		friend manager make_manager(_PoolArgs&&... pool_args);
 
@@ -28,6 +34,7 @@ namespace async
 
 		manager(std::nullptr_t = nullptr);
 		manager(std::unique_ptr<pool> uniq_pool_impl);
+		manager(std::unique_ptr<pool> uniq_pool_impl, std::pmr::memory_resource* resource);
 		manager(manager&& other);
 		~manager();
 
@@ -38,37 +45,47 @@ namespace async
 	public:
 
 		template<class _Value>
-		promise<_Value> resolve(std::wstring log_ctx, _Value value);
+		promise<_Value> resolve(log_ctx_t log_ctx, _Value value);
 
-		promise<void> resolve(std::wstring log_ctx);
+		promise<void> resolve(log_ctx_t log_ctx);
 
 		template<class _Value, class... _Args>
-		promise<_Value> resolve_emplace(std::wstring log_ctx, _Args&&... args);
+		promise<_Value> resolve_emplace(log_ctx_t log_ctx, _Args&&... args);
 
 		template<class _Value>  promise<_Value>  resolve(promise<_Value> value);
 
-		template<class _Value>  promise<_Value>  reject(std::wstring log_ctx, std::exception_ptr except);
+		template<class _Value>  promise<_Value>  reject(log_ctx_t log_ctx, std::exception_ptr except);
+
+		template<class _Result> promise<_Result> task(log_ctx_t log_ctx, task_t<_Result> tsk, pool::priority_t priority = pool::priority_t::normal);
+
+		promise<void> task(log_ctx_t log_ctx, task_t<void> tsk, pool::priority_t priority = pool::priority_t::normal);
+
+		promise<void> delay(log_ctx_t log_ctx, std::chrono::microseconds duration);
 
-		template<class _Result> promise<_Result> task(std::wstring log_ctx, task_t<_Result> tsk);
+		template<class _Result> promise<_Result> schedule_at(log_ctx_t log_ctx, std::chrono::steady_clock::time_point time, task_t<_Result> tsk, pool::priority_t priority = pool::priority_t::normal);
 
-		promise<void> task(std::wstring log_ctx, task_t<void> tsk);
+		promise<void> schedule_at(log_ctx_t log_ctx, std::chrono::steady_clock::time_point time, task_t<void> tsk, pool::priority_t priority = pool::priority_t::normal);
+
+		timer every(log_ctx_t log_ctx, std::chrono::microseconds period, task_t<void> tsk, pool::priority_t priority = pool::priority_t::normal);
 
 		template<class _Value>
-		promise<_Value> task_here_and_now(std::wstring log_ctx, const std::function<void(typename promise<_Value>::send async_send)>& functor);
+		promise<_Value> task_here_and_now(log_ctx_t log_ctx, const std::function<void(typename promise<_Value>::send async_send)>& functor);
 
-		promise<void> task_here_and_now(std::wstring log_ctx, const std::function<void(typename promise<void>::send async_send)>& functor);
+		promise<void> task_here_and_now(log_ctx_t log_ctx, const std::function<void(typename promise<void>::send async_send)>& functor);
 
 		template<
 			template<class _Item, class _Alloc = std::allocator<_Item>> class _Container,
 			class _Result
 		>
-		promise<_Container<_Result>> all(std::wstring log_ctx, _Container<promise<_Result>> prmises);
+		promise<_Container<_Result>> all(log_ctx_t log_ctx, _Container<promise<_Result>> prmises);
 
 		template<class... _Results>
-		promise<std::tuple<_Results...>> all(std::wstring log_ctx, promise<_Results>... prmises);
+		promise<std::tuple<_Results...>> all(log_ctx_t log_ctx, promise<_Results>... prmises);
 
 	public:
 
+		promise<void> delay(std::chrono::microseconds duration);
+
 		template<class _Value>
 		promise<_Value> task_here_and_now(const std::function<void(typename promise<_Value>::send async_send)>& functor);
 
@@ -96,6 +113,20 @@ namespace async
 		std::size_t busy_threads_count() const;
 		std::size_t max_threads_count() const;
 
+		/** \brief Counters of the pool without the locks (see \a pool::stats).
+		 */
+		pool_stats stats() const;
+
+		pool::exec_t continuations_exec() const;
+		void set_continuations_exec(pool::exec_t exec);
+
+		/** \brief Memory resource of the promises, the closures of the next steps and the shared state of \a all (see \a pool::memory_resource).
+		 *
+		 * \details The resource must outlive the manager and all its promises, for example \a async::pool_resource.
+		 */
+		std::pmr::memory_resource* memory_resource() const;
+		void set_memory_resource(std::pmr::memory_resource* resource);
+
 	private:
 
 		template<class _Value>
@@ -110,9 +141,13 @@ namespace async
 		const pool& check_and_ref_pool() const;
 		pool_ptr check_and_get_pool() const;
 
+		details::timer_wheel& check_and_ref_timers();
+
 	private:
 
 		pool_ptr m_pool;
+		std::atomic<details::timer_wheel*> m_timers_ptr{ nullptr }; // It is created at the first timer, the owner is m_timers
+		std::shared_ptr<details::timer_wheel> m_timers;              // It is set once by the thread, which has created the wheel
 	};
 
 } // namespace async
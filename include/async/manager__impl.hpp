@@ -1,10 +1,10 @@
 
 #pragma once
 
-#include <async\logger.hpp>
-#include <async\manager.hpp>
-#include <async\promise_errc.hpp>
-#include <async\details__impl.hpp>
+#include <async/logger.hpp>
+#include <async/manager.hpp>
+#include <async/promise_errc.hpp>
+#include <async/details__impl.hpp>
 
 
 namespace async
@@ -50,6 +50,12 @@ namespace async
 		: m_pool{ std::move(uniq_pool_impl) }
 	{}
 
+	inline manager::manager(std::unique_ptr<pool> uniq_pool_impl, std::pmr::memory_resource* resource)
+		: manager{ std::move(uniq_pool_impl) }
+	{
+		set_memory_resource(resource);
+	}
+
 	inline manager::manager(manager&& other)
 		: m_pool{ nullptr }
 	{
@@ -58,6 +64,9 @@ namespace async
 
 	inline manager::~manager()
 	{
+		if (m_timers)
+			m_timers->stop();
+
 		if (m_pool)
 			m_pool->stop_threads_and_wait_them_complete();
 	}
@@ -71,6 +80,11 @@ namespace async
 	inline void manager::swap(manager& other)
 	{
 		m_pool.swap(other.m_pool);
+		m_timers.swap(other.m_timers);
+
+		details::timer_wheel* const timers_ptr{ m_timers_ptr.load(std::memory_order_relaxed) };
+		m_timers_ptr.store(other.m_timers_ptr.load(std::memory_order_relaxed), std::memory_order_relaxed);
+		other.m_timers_ptr.store(timers_ptr, std::memory_order_relaxed);
 	}
 
 	inline void manager::resume_threads()
@@ -108,6 +122,31 @@ namespace async
 		return check_and_ref_pool().max_threads_count();
 	}
 
+	[[nodiscard]] inline pool_stats manager::stats() const
+	{
+		return check_and_ref_pool().stats();
+	}
+
+	[[nodiscard]] inline pool::exec_t manager::continuations_exec() const
+	{
+		return check_and_ref_pool().continuations_exec();
+	}
+
+	inline void manager::set_continuations_exec(pool::exec_t exec)
+	{
+		check_and_ref_pool().set_continuations_exec(exec);
+	}
+
+	[[nodiscard]] inline std::pmr::memory_resource* manager::memory_resource() const
+	{
+		return check_and_ref_pool().memory_resource();
+	}
+
+	inline void manager::set_memory_resource(std::pmr::memory_resource* resource)
+	{
+		check_and_ref_pool().set_memory_resource(resource);
+	}
+
 	[[nodiscard]] inline pool& manager::check_and_ref_pool()
 	{
 		if (pool* const result = m_pool.get())
@@ -132,8 +171,27 @@ namespace async
 		throw promise_error{ promise_errc::no_state };
 	}
 
+	[[nodiscard]] inline details::timer_wheel& manager::check_and_ref_timers()
+	{
+		// The wheel is created once: its pointer is published by the atomic pointer, the shared owner is set only by the winner
+		details::timer_wheel* timers{ m_timers_ptr.load(std::memory_order_acquire) };
+
+		if (!timers)
+		{
+			std::shared_ptr<details::timer_wheel> new_timers{ std::make_shared<details::timer_wheel>(check_and_get_pool()) };
+
+			if (m_timers_ptr.compare_exchange_strong(timers, new_timers.get(), std::memory_order_acq_rel, std::memory_order_acquire))
+			{
+				timers = new_timers.get();
+				m_timers = std::move(new_timers);
+			}
+		}
+
+		return *timers;
+	}
+
 	template<class _Value>
-	inline promise<_Value> manager::resolve(std::wstring log_ctx, _Value value)
+	inline promise<_Value> manager::resolve(log_ctx_t log_ctx, _Value value)
 	{
 		promise<_Value> res_promise{ check_and_get_pool() };
 		res_promise.m_data->result.value.set_value(std::move(value));
@@ -148,13 +206,13 @@ namespace async
             // trace
             log_msg(log, L'[', res_promise.m_data->log_ctx, L"] Resolve"sv);
 
-            details::add_details_log_ctx(res_promise.m_data->log_ctx, L"scss"sv);
+            details::add_details_log_ctx(log, res_promise.m_data->log_ctx, L"scss"sv);
         }
 
 		return res_promise;
 	}
 
-	inline promise<void> manager::resolve(std::wstring log_ctx)
+	inline promise<void> manager::resolve(log_ctx_t log_ctx)
 	{
 		promise<void> res_promise{ check_and_get_pool() };
 		res_promise.m_data->result.value.set_value();
@@ -176,7 +234,7 @@ namespace async
 	}
 
 	template<class _Value, class... _Args>
-	inline promise<_Value> manager::resolve_emplace(std::wstring log_ctx, _Args&&... args)
+	inline promise<_Value> manager::resolve_emplace(log_ctx_t log_ctx, _Args&&... args)
 	{
 		promise<_Value> res_promise{ check_and_get_pool() };
 		res_promise.m_data->result.value.emplace_value(std::forward<_Args>(args)...);
@@ -191,7 +249,7 @@ namespace async
             // trace
             log_msg(log, L'[', res_promise.m_data->log_ctx, L"] Resolve"sv);
 
-            details::add_details_log_ctx(res_promise.m_data->log_ctx, L"scss"sv);
+            details::add_details_log_ctx(log, res_promise.m_data->log_ctx, L"scss"sv);
         }
 
 		return res_promise;
@@ -207,7 +265,7 @@ namespace async
 
 		const prom_data_ptr<_Value> arg_data{ value.take_data() };
 
-		promise<_Value> res_promise{ std::move(res_pool) };
+		promise<_Value> res_promise{ std::move(res_pool), arg_data->result.priority };
 
 		details::api<_Value>::bind_next_step(
 			pool::unknown_ctx,
@@ -227,7 +285,7 @@ namespace async
 	}
 
 	template<class _Value>
-	inline promise<_Value> manager::reject(std::wstring log_ctx, std::exception_ptr except)
+	inline promise<_Value> manager::reject(log_ctx_t log_ctx, std::exception_ptr except)
 	{
 		promise<_Value> res_promise{ check_and_get_pool() };
 		res_promise.m_data->result.value.set_except(except);
@@ -242,16 +300,16 @@ namespace async
             // trace
             log_msg(log, L'[', res_promise.m_data->log_ctx, L"] Reject"sv);
 
-            details::add_details_log_ctx(res_promise.m_data->log_ctx, L"rjct"sv);
+            details::add_details_log_ctx(log, res_promise.m_data->log_ctx, L"rjct"sv);
         }
 
 		return res_promise;
 	}
 
 	template<class _Result>
-	inline promise<_Result> manager::task(std::wstring log_ctx, task_t<_Result> tsk_v)
+	inline promise<_Result> manager::task(log_ctx_t log_ctx, task_t<_Result> tsk_v, pool::priority_t priority)
 	{
-		promise<_Result> res_promise{ check_and_get_pool() };
+		promise<_Result> res_promise{ check_and_get_pool(), priority };
 
 		const prom_data_ptr<_Result>& res_data{ res_promise.m_data };
 		
@@ -261,26 +319,95 @@ namespace async
 		details::add_task_in_pool(
 			pool::unknown_ctx,
 			*res_data->pool,
-			[res_data, tsk_v = std::move(tsk_v)](pool::ctx_t this_ctx)
+			res_data->pool->make_task([res_data, tsk_v = std::move(tsk_v)](pool::ctx_t this_ctx)
 		{
 			details::api<_Result>::set_result(std::move(this_ctx), res_data, details::api<_Result>::apply_task(res_data->pool->log(), res_data->log_ctx, tsk_v));
-		});
+		}), priority);
 
 		return res_promise;
 	}
 
-	inline promise<void> manager::task(std::wstring log_ctx, task_t<void> tsk)
+	inline promise<void> manager::task(log_ctx_t log_ctx, task_t<void> tsk, pool::priority_t priority)
+	{
+		return this->task<void>(std::move(log_ctx), std::move(tsk), priority);
+	}
+
+	inline promise<void> manager::delay(std::chrono::microseconds duration)
 	{
-		return this->task<void>(std::move(log_ctx), std::move(tsk));
+		return this->delay(log_ctx_t{}, duration);
+	}
+	inline promise<void> manager::delay(log_ctx_t log_ctx, std::chrono::microseconds duration)
+	{
+		promise<void> res_promise{ check_and_get_pool() };
+
+		const prom_data_ptr<void>& res_data{ res_promise.m_data };
+
+		if (logger* const log = m_pool->log())
+			res_data->log_ctx = details::normalize_log_ctx(log, std::move(log_ctx), L"delay"sv);
+
+		check_and_ref_timers().arm(
+			std::chrono::steady_clock::now() + duration,
+			[armed_data = details::armed_prom_data<void>{ res_data }](pool::ctx_t this_ctx) mutable
+		{
+			value_or_promise_t<void> result{};
+			result.set_value();
+
+			details::api<void>::set_result(std::move(this_ctx), armed_data.take(), std::move(result));
+		}, res_data->result.priority);
+
+		return res_promise;
+	}
+
+	template<class _Result>
+	inline promise<_Result> manager::schedule_at(log_ctx_t log_ctx, std::chrono::steady_clock::time_point time, task_t<_Result> tsk_v, pool::priority_t priority)
+	{
+		promise<_Result> res_promise{ check_and_get_pool(), priority };
+
+		const prom_data_ptr<_Result>& res_data{ res_promise.m_data };
+
+		if (logger* const log = m_pool->log())
+			res_data->log_ctx = details::normalize_log_ctx(log, std::move(log_ctx), L"task"sv);
+
+		check_and_ref_timers().arm(
+			time,
+			res_data->pool->make_task([armed_data = details::armed_prom_data<_Result>{ res_data }, tsk_v = std::move(tsk_v)](pool::ctx_t this_ctx) mutable
+		{
+			const prom_data_ptr<_Result> data{ armed_data.take() };
+
+			details::api<_Result>::set_result(std::move(this_ctx), data, details::api<_Result>::apply_task(data->pool->log(), data->log_ctx, tsk_v));
+		}), priority);
+
+		return res_promise;
+	}
+
+	inline promise<void> manager::schedule_at(log_ctx_t log_ctx, std::chrono::steady_clock::time_point time, task_t<void> tsk, pool::priority_t priority)
+	{
+		return this->schedule_at<void>(std::move(log_ctx), time, std::move(tsk), priority);
+	}
+
+	inline timer manager::every(log_ctx_t log_ctx, std::chrono::microseconds period, task_t<void> tsk_v, pool::priority_t priority)
+	{
+		pool_ptr res_pool{ check_and_get_pool() };
+
+		if (logger* const log = res_pool->log())
+			log_ctx = details::normalize_log_ctx(log, std::move(log_ctx), L"every"sv);
+
+		return check_and_ref_timers().arm_periodic(
+			period,
+			[res_pool = std::move(res_pool), log_ctx = std::move(log_ctx), tsk_v = std::move(tsk_v)](pool::ctx_t)
+		{
+			// The exception of the periodic task is only logged
+			details::api<void>::apply_task(res_pool->log(), log_ctx, tsk_v);
+		}, priority);
 	}
 
 	template<class _Value>
 	inline promise<_Value> manager::task_here_and_now(const std::function<void(typename promise<_Value>::send async_send)>& functor)
 	{
-		return this->task_here_and_now(std::wstring{}, functor);
+		return this->task_here_and_now(log_ctx_t{}, functor);
 	}
 	template<class _Value>
-	inline promise<_Value> manager::task_here_and_now(std::wstring log_ctx, const std::function<void(typename promise<_Value>::send async_send)>& functor)
+	inline promise<_Value> manager::task_here_and_now(log_ctx_t log_ctx, const std::function<void(typename promise<_Value>::send async_send)>& functor)
 	{
 		promise<_Value> res_promise{ check_and_get_pool() };
 
@@ -308,9 +435,9 @@ namespace async
 
 	inline promise<void> manager::task_here_and_now(const std::function<void(typename promise<void>::send async_send)>& functor)
 	{
-		return this->task_here_and_now<void>(std::wstring{}, functor);
+		return this->task_here_and_now<void>(log_ctx_t{}, functor);
 	}
-	inline promise<void> manager::task_here_and_now(std::wstring log_ctx, const std::function<void(typename promise<void>::send async_send)>& functor)
+	inline promise<void> manager::task_here_and_now(log_ctx_t log_ctx, const std::function<void(typename promise<void>::send async_send)>& functor)
 	{
 		return this->task_here_and_now<void>(std::move(log_ctx), functor);
 	}
@@ -321,16 +448,16 @@ namespace async
 	>
 	inline promise<_Container<_Result>> manager::all(_Container<promise<_Result>> promises)
 	{
-		return this->all(std::wstring{}, promises...);
+		return this->all(log_ctx_t{}, std::move(promises));
 	}
 	template<
 		template<class _Item, class _Alloc = std::allocator<_Item>> class _Container,
 		class _Result
 	>
-	inline promise<_Container<_Result>> manager::all(std::wstring log_ctx, _Container<promise<_Result>> promises)
+	inline promise<_Container<_Result>> manager::all(log_ctx_t log_ctx, _Container<promise<_Result>> promises)
 	{
-        if (m_pool->get())
-		    log_ctx = details::normalize_log_ctx(std::move(log_ctx), L"all"sv);
+        if (logger* const log = m_pool->log())
+		    log_ctx = details::normalize_log_ctx(log, std::move(log_ctx), L"all"sv);
 
 		if (std::empty(promises))
 		{
@@ -400,23 +527,32 @@ namespace async
 
 			value_or_promise_t<_Container<_Result>> res_values;
 		};
-		const std::shared_ptr<shared_data_t> shared_data{ std::make_shared<shared_data_t>() };
+		const std::shared_ptr<shared_data_t> shared_data{ res_data->pool->template allocate_shared<shared_data_t>() };
 		shared_data->res_values.emplace_value().resize(promises_count);
 		shared_data->state = promises_count;
 
 		assert(shared_data->state == shared_data->res_values.get_value().size());
 		assert(1 < shared_data->state && shared_data->state < state__except);
 
+		// The steps of the already resolved promises are collected in one batch, if they are executed in the resulting pool
+		// with the priority of the result
+		pool::more_tasks_t ready_tasks{};
+		ready_tasks.reserve(promises_count);
+
 		std::size_t number{ 0 };
 		for (const prom_data_ptr<_Result>& item_data : data_chain)
 		{
 			number += 1;
 
+			const bool is_same_pool_and_priority{ item_data->pool == res_data->pool && item_data->result.priority == res_data->result.priority };
+
+			pool::more_tasks_t* const item_ready_tasks{ is_same_pool_and_priority ? &ready_tasks : nullptr };
+
 			details::api<_Result>::bind_next_step(
 				pool::unknown_ctx,
 				item_data->result,
 				*item_data->pool,
-				[res_data, number, state__except, item_data, shared_data](pool::ctx_t pool_ctx)
+				[res_data, number, promises_count, state__except, item_data, shared_data](pool::ctx_t pool_ctx)
 			{
 				assert(shared_data->res_values.has_value());
 				assert(number <= shared_data->res_values.get_value().size());
@@ -483,19 +619,22 @@ namespace async
 
 						details::api<_Container<_Result>>::set_result(std::move(pool_ctx), res_data, std::move(shared_data->res_values));
 					}
-			});
+			}, item_ready_tasks);
 		}
 
+		if (!ready_tasks.empty())
+			res_data->pool->add_tasks(pool::unknown_ctx, ready_tasks.data(), ready_tasks.size(), res_data->result.priority);
+
 		return res_promise;
 	}
 
 	template<class... _Results>
 	inline promise<std::tuple<_Results...>> manager::all(promise<_Results>... promises)
 	{
-		return this->all(std::wstring{}, promises...);
+		return this->all(log_ctx_t{}, std::move(promises)...);
 	}
 	template<class... _Results>
-	inline promise<std::tuple<_Results...>> manager::all(std::wstring log_ctx, promise<_Results>... promises)
+	inline promise<std::tuple<_Results...>> manager::all(log_ctx_t log_ctx, promise<_Results>... promises)
 	{
 		using api_all = details::api_all<_Results...>;
 		using res_data_t = typename api_all::res_data_t;
@@ -507,8 +646,8 @@ namespace async
 
 		const res_data_t res_data{ res_promise.m_data };
 
-        if (m_pool->log())
-		    res_data->log_ctx = details::normalize_log_ctx(std::move(log_ctx), L"all"sv);
+        if (logger* const log = m_pool->log())
+		    res_data->log_ctx = details::normalize_log_ctx(log, std::move(log_ctx), L"all"sv);
 
 		if constexpr (api_all::size == 1)
 		{
@@ -556,11 +695,17 @@ namespace async
 				}
 			}
 
-			const std::shared_ptr<shared_data_t> shared_data{ std::make_shared<shared_data_t>() };
+			const std::shared_ptr<shared_data_t> shared_data{ res_data->pool->template allocate_shared<shared_data_t>() };
 			shared_data->res_values.emplace_value();
 			shared_data->state = api_all::size;
 
-			api_all::bind_next_steps(res_data, shared_data, tuple_arg_datas);
+			pool::more_tasks_t ready_tasks{};
+			ready_tasks.reserve(api_all::size);
+
+			api_all::bind_next_steps(res_data, shared_data, tuple_arg_datas, ready_tasks);
+
+			if (!ready_tasks.empty())
+				res_data->pool->add_tasks(pool::unknown_ctx, ready_tasks.data(), ready_tasks.size(), res_data->result.priority);
 		}
 
 		return res_promise;
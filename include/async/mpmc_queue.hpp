@@ -0,0 +1,224 @@
+#pragma once
+
+
+#include <new>
+#include <mutex>
+#include <deque>
+#include <atomic>
+#include <memory>
+#include <cassert>
+#include <cstdint>
+#include <utility>
+#include <type_traits>
+
+
+namespace async::details
+{
+	/** \brief Multi-producer multi-consumer FIFO queue.
+	 *
+	 * \details The fast path is the bounded lock-free ring of D. Vyukov: every cell has a sequence number,
+	 *          a producer (consumer) claims a cell with one CAS on the tail (head) index and publishes it through the sequence.
+	 *
+	 * \details \a try_push is strictly bounded by the capacity of the ring. \a push never fails: when the ring is full
+	 *          the item goes to the overflow deque guarded by a mutex, and while the overflow is not empty the new items
+	 *          follow it there, so the order of the items is kept. The overflow is the cold path for bursts
+	 *          deeper than the ring; in the steady state the producers and consumers touch only the ring.
+	 */
+	template<class _Item>
+	class mpmc_queue
+	{
+		static_assert(std::is_nothrow_move_constructible_v<_Item>);
+
+	public:
+
+		mpmc_queue()
+			: mpmc_queue(capacity_default)
+		{}
+
+		explicit mpmc_queue(std::size_t capacity)
+			: m_head{ 0 }
+			, m_tail{ 0 }
+			, m_mask{ round_up_pow2(capacity) - 1 }
+			, m_cells{ std::make_unique<cell_t[]>(m_mask + 1) }
+			, m_overflow{}
+		{
+			for (std::size_t index = 0; index <= m_mask; ++index)
+				m_cells[index].sequence.store(index, std::memory_order_relaxed);
+
+			m_overflow.size.store(0, std::memory_order_relaxed);
+		}
+
+		~mpmc_queue()
+		{
+			_Item item{};
+			while (try_pop_ring(item));
+		}
+
+		mpmc_queue(mpmc_queue&& other) = delete;
+		mpmc_queue(const mpmc_queue& other) = delete;
+
+		mpmc_queue& operator=(mpmc_queue&& other) = delete;
+		mpmc_queue& operator=(const mpmc_queue& other) = delete;
+
+	public:
+
+		[[nodiscard]] bool try_push(_Item& item) noexcept
+		{
+			return try_push_ring(item);
+		}
+
+		void push(_Item item)
+		{
+			if (m_overflow.size.load(std::memory_order_acquire) == 0 && try_push_ring(item))
+				return;
+
+			const std::lock_guard<std::mutex> lk{ m_overflow.access };
+
+			m_overflow.queue.push_back(std::move(item));
+			m_overflow.size.fetch_add(1, std::memory_order_release);
+		}
+
+		[[nodiscard]] bool try_pop(_Item& item)
+		{
+			if (try_pop_ring(item))
+				return true;
+
+			if (m_overflow.size.load(std::memory_order_acquire) == 0)
+				return false;
+
+			const std::lock_guard<std::mutex> lk{ m_overflow.access };
+
+			if (m_overflow.queue.empty())
+				return false;
+
+			item = std::move(m_overflow.queue.front());
+			m_overflow.queue.pop_front();
+			m_overflow.size.fetch_sub(1, std::memory_order_release);
+
+			return true;
+		}
+
+		[[nodiscard]] std::size_t size_approx() const noexcept
+		{
+			const std::size_t tail{ m_tail.load(std::memory_order_relaxed) };
+			const std::size_t head{ m_head.load(std::memory_order_relaxed) };
+
+			return (tail > head ? tail - head : 0) + m_overflow.size.load(std::memory_order_relaxed);
+		}
+
+		[[nodiscard]] bool empty_approx() const noexcept
+		{
+			return (size_approx() == 0);
+		}
+
+		[[nodiscard]] std::size_t capacity() const noexcept
+		{
+			return (m_mask + 1);
+		}
+
+	private:
+
+		bool try_push_ring(_Item& item) noexcept
+		{
+			std::size_t tail{ m_tail.load(std::memory_order_relaxed) };
+
+			for (;;)
+			{
+				cell_t& cell{ m_cells[tail & m_mask] };
+
+				const std::size_t sequence{ cell.sequence.load(std::memory_order_acquire) };
+				const std::intptr_t diff{ static_cast<std::intptr_t>(sequence) - static_cast<std::intptr_t>(tail) };
+
+				if (diff == 0)
+				{
+					if (m_tail.compare_exchange_weak(tail, tail + 1, std::memory_order_relaxed))
+					{
+						::new (static_cast<void*>(&cell.storage)) _Item(std::move(item));
+						cell.sequence.store(tail + 1, std::memory_order_release);
+						return true;
+					}
+				}
+				else
+				if (diff < 0)
+				{
+					return false; // Full
+				}
+				else
+				{
+					tail = m_tail.load(std::memory_order_relaxed);
+				}
+			}
+		}
+
+		bool try_pop_ring(_Item& item)
+		{
+			std::size_t head{ m_head.load(std::memory_order_relaxed) };
+
+			for (;;)
+			{
+				cell_t& cell{ m_cells[head & m_mask] };
+
+				const std::size_t sequence{ cell.sequence.load(std::memory_order_acquire) };
+				const std::intptr_t diff{ static_cast<std::intptr_t>(sequence) - static_cast<std::intptr_t>(head + 1) };
+
+				if (diff == 0)
+				{
+					if (m_head.compare_exchange_weak(head, head + 1, std::memory_order_relaxed))
+					{
+						_Item* const stored_item{ std::launder(reinterpret_cast<_Item*>(&cell.storage)) };
+
+						item = std::move(*stored_item);
+						stored_item->~_Item();
+
+						cell.sequence.store(head + m_mask + 1, std::memory_order_release);
+						return true;
+					}
+				}
+				else
+				if (diff < 0)
+				{
+					return false; // Empty
+				}
+				else
+				{
+					head = m_head.load(std::memory_order_relaxed);
+				}
+			}
+		}
+
+		static std::size_t round_up_pow2(std::size_t capacity) noexcept
+		{
+			std::size_t result{ capacity_min };
+			while (result < capacity)
+				result <<= 1;
+
+			return result;
+		}
+
+	private:
+
+		struct cell_t
+		{
+			std::atomic<std::size_t> sequence;
+			std::aligned_storage_t<sizeof(_Item), alignof(_Item)> storage;
+		};
+
+		static constexpr std::size_t capacity_min{ 2 };
+		static constexpr std::size_t capacity_default{ 1024 };
+
+		alignas(64) std::atomic<std::size_t> m_head;
+		alignas(64) std::atomic<std::size_t> m_tail;
+
+		alignas(64) const std::size_t m_mask;
+		const std::unique_ptr<cell_t[]> m_cells;
+
+		struct
+		{
+			std::mutex access;
+			std::deque<_Item> queue;
+			std::atomic<std::size_t> size;
+
+		} m_overflow;
+	};
+
+} // namespace async::details
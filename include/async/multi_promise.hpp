@@ -1,8 +1,8 @@
 
 #pragma once
 
-#include <async\promise_types.hpp>
-#include <async\value.hpp>
+#include <async/promise_types.hpp>
+#include <async/value.hpp>
 
 
 namespace async::details
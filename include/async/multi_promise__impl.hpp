@@ -1,8 +1,8 @@
 
 #pragma once
 
-#include <async\multi_promise.hpp>
-#include <async\details__impl.hpp>
+#include <async/multi_promise.hpp>
+#include <async/details__impl.hpp>
 
 
 namespace async
@@ -0,0 +1,43 @@
+#pragma once
+
+#include <vector>
+#include <cstddef>
+
+#include <async/config.hpp>
+
+
+namespace async
+{
+
+	/** \brief NUMA node: the logical processors with the common local memory.
+	 */
+	struct numa_node
+	{
+		std::size_t id;                 // Number of the node in the system
+		std::vector<std::size_t> cpus;  // Numbers of the logical processors of the node
+	};
+
+
+	/** \brief Get the NUMA nodes of the system.
+	 *
+	 * \details Linux: \a /sys/devices/system/node, Windows: \a GetNumaHighestNodeNumber and \a GetNumaNodeProcessorMaskEx.
+	 *          If the topology is unknown (or the system is not NUMA) the result is one node with all logical processors.
+	 *
+	 * \return The nodes with at least one processor, never empty.
+	 */
+	ASYNC_LIB_API std::vector<numa_node> numa_topology();
+
+	/** \brief Bind the current thread to the logical processors of the node.
+	 *
+	 * \details On Windows the processors of node must be in one processor group (as they are for a real NUMA node).
+	 *
+	 * \return If the thread is bound \a true, otherwise \a false (the platform is not supported or the system call failed).
+	 */
+	ASYNC_LIB_API bool bind_this_thread_to_numa_node(const numa_node& node) noexcept;
+
+} // namespace async
+
+
+#ifdef ASYNC_LIB_HEADERS_ONLY
+#   include <async/numa_topology_impl.hpp>
+#endif
@@ -0,0 +1,172 @@
+
+#include <string>
+#include <thread>
+#include <cctype>
+#include <fstream>
+#include <algorithm>
+
+#include <async/numa_topology.hpp>
+
+#if defined(_WIN32)
+#   ifndef NOMINMAX
+#       define NOMINMAX
+#   endif
+#   ifndef WIN32_LEAN_AND_MEAN
+#       define WIN32_LEAN_AND_MEAN
+#   endif
+#   include <windows.h>
+#elif defined(__linux__)
+#   include <sched.h>
+#   include <pthread.h>
+#endif
+
+
+namespace async
+{
+	namespace details
+	{
+		inline std::vector<std::size_t> parse_numbers_list(const std::string& text)
+		{
+			// Format of the lists in /sys: "0-3,8,10-11"
+
+			std::vector<std::size_t> result;
+
+			std::size_t pos{ 0 };
+			while (pos < text.size())
+			{
+				if (!std::isdigit(static_cast<unsigned char>(text[pos])))
+				{
+					pos += 1;
+					continue;
+				}
+
+				std::size_t parsed{ 0 };
+				const std::size_t first{ std::stoul(text.substr(pos), &parsed) };
+				pos += parsed;
+
+				std::size_t last{ first };
+				if (pos < text.size() && text[pos] == '-')
+				{
+					pos += 1;
+					last = std::stoul(text.substr(pos), &parsed);
+					pos += parsed;
+				}
+
+				for (std::size_t number = first; number <= last; ++number)
+					result.push_back(number);
+			}
+
+			return result;
+		}
+
+		inline numa_node numa_node_of_all_cpus()
+		{
+			numa_node node{ 0, {} };
+
+			const std::size_t cpus_count{ std::max<std::size_t>(1, std::thread::hardware_concurrency()) };
+			for (std::size_t cpu = 0; cpu < cpus_count; ++cpu)
+				node.cpus.push_back(cpu);
+
+			return node;
+		}
+
+	} // namespace details
+
+
+	ASYNC_INLINE std::vector<numa_node> numa_topology()
+	{
+		std::vector<numa_node> result;
+
+		try
+		{
+#if defined(_WIN32)
+			ULONG highest_node_number{ 0 };
+			if (::GetNumaHighestNodeNumber(&highest_node_number))
+			{
+				for (ULONG node_number = 0; node_number <= highest_node_number; ++node_number)
+				{
+					GROUP_AFFINITY affinity{};
+					if (!::GetNumaNodeProcessorMaskEx(static_cast<USHORT>(node_number), &affinity) || affinity.Mask == 0)
+						continue;
+
+					numa_node node{ static_cast<std::size_t>(node_number), {} };
+
+					for (std::size_t bit = 0; bit < 8 * sizeof(KAFFINITY); ++bit)
+					{
+						if ((affinity.Mask & (static_cast<KAFFINITY>(1) << bit)) != 0)
+							node.cpus.push_back(static_cast<std::size_t>(affinity.Group) * 8 * sizeof(KAFFINITY) + bit);
+					}
+
+					result.push_back(std::move(node));
+				}
+			}
+#elif defined(__linux__)
+			const std::string nodes_path{ "/sys/devices/system/node/" };
+
+			std::ifstream online_stream{ nodes_path + "online" };
+
+			std::string online_list;
+			if (std::getline(online_stream, online_list))
+			{
+				for (const std::size_t node_number : details::parse_numbers_list(online_list))
+				{
+					std::ifstream cpus_stream{ nodes_path + "node" + std::to_string(node_number) + "/cpulist" };
+
+					std::string cpus_list;
+					if (!std::getline(cpus_stream, cpus_list))
+						continue;
+
+					numa_node node{ node_number, details::parse_numbers_list(cpus_list) };
+
+					if (!node.cpus.empty())
+						result.push_back(std::move(node));
+				}
+			}
+#endif
+		}
+		catch (...)
+		{
+			result.clear();
+		}
+
+		if (result.empty())
+			result.push_back(details::numa_node_of_all_cpus());
+
+		return result;
+	}
+
+	ASYNC_INLINE bool bind_this_thread_to_numa_node(const numa_node& node) noexcept
+	{
+		if (node.cpus.empty())
+			return false;
+
+#if defined(_WIN32)
+		constexpr std::size_t group_size{ 8 * sizeof(KAFFINITY) };
+
+		GROUP_AFFINITY affinity{};
+		affinity.Group = static_cast<WORD>(node.cpus.front() / group_size);
+
+		for (const std::size_t cpu : node.cpus)
+		{
+			if (cpu / group_size == affinity.Group)
+				affinity.Mask |= (static_cast<KAFFINITY>(1) << (cpu % group_size));
+		}
+
+		return (::SetThreadGroupAffinity(::GetCurrentThread(), &affinity, nullptr) != FALSE);
+#elif defined(__linux__)
+		cpu_set_t cpus_set;
+		CPU_ZERO(&cpus_set);
+
+		for (const std::size_t cpu : node.cpus)
+		{
+			if (cpu < CPU_SETSIZE)
+				CPU_SET(cpu, &cpus_set);
+		}
+
+		return (::pthread_setaffinity_np(::pthread_self(), sizeof(cpus_set), &cpus_set) == 0);
+#else
+		return false;
+#endif
+	}
+
+} // namespace async
@@ -1,15 +1,23 @@
 
 #pragma once
 
-#include <list>
+#include <array>
 #include <tuple>
 #include <deque>
 #include <vector>
 #include <chrono>
 #include <memory>
+#include <atomic>
 #include <variant>
 #include <cassert>
-#include <functional>
+#include <string_view>
+#include <type_traits>
+#include <memory_resource>
+
+#include <async/pool_stats.hpp>
+#include <async/mpmc_queue.hpp>
+#include <async/priority_lanes.hpp>
+#include <async/unique_task.hpp>
 
 
 namespace async
@@ -32,12 +40,40 @@ namespace async
 
 		/** \brief      .
 		 */
-		using task_t = std::function<void(ctx_t)>;
+		using task_t = unique_task<void(ctx_t)>;
 
-		using more_tasks_t = std::list<pool::task_t>;
+		using more_tasks_t = std::vector<pool::task_t>;
 
 		using task_variant_t = std::variant<task_t, more_tasks_t>;
 
+		/** \brief  .
+		 *
+		 * \details         .     
+		 *            ,       (. \a details::lanes_aging).
+		 */
+		enum class priority_t : std::size_t
+		{
+			critical = 0, //    
+			normal,       //  
+			background    //  
+		};
+
+		static constexpr std::size_t priorities_count{ 3 };
+
+		/** \brief      (then, success, reject, finaly).
+		 *
+		 * \details \a inline_exec -     ,     (   
+		 *             ),   .     .   
+		 *              \a pool::inline_exec_depth_max,     .
+		 */
+		enum class exec_t
+		{
+			queued = 0, //  :   
+			inline_exec
+		};
+
+		static constexpr std::size_t inline_exec_depth_max{ 16 };
+
 	public:
 
 		/** \brief    .
@@ -53,8 +89,23 @@ namespace async
 		 *
 		 * \param [in] task     -   .         ,
 		 *                                 .
+		 *
+		 * \param [in] priority -  .
 		 */
-		virtual void add_task(ctx_t this_ctx, task_t task) = 0;
+		virtual void add_task(ctx_t this_ctx, task_t task, priority_t priority = priority_t::normal) = 0;
+
+		/** \brief     .
+		 *
+		 * \details   \a pool::add_task    :      \a this_ctx,
+		 *           -   \a pool::unknown_ctx.        
+		 *                  ,    .
+		 *
+		 * \param [in] this_ctx -    (. \a pool::add_task).
+		 * \param [in] tasks    -   ,       ().
+		 * \param [in] count    -    .
+		 * \param [in] priority -    .
+		 */
+		virtual void add_tasks(ctx_t this_ctx, task_t* tasks, std::size_t count, priority_t priority = priority_t::normal);
 
 		/** \brief    .
 		 * 
@@ -127,10 +178,71 @@ namespace async
 		 */
 		virtual std::size_t max_threads_count() const = 0;
 
+		/** \brief       (. \a pool_stats).
+		 *
+		 * \details           ,   
+		 *            (   ).     .
+		 */
+		virtual pool_stats stats() const { return {}; }
+
     public:
 
         virtual logger* log() const noexcept { return nullptr; }
 
+        virtual std::wstring_view name() const noexcept { return {}; }
+
+	public:
+
+		/** \brief      (     , . \a promise::set_exec).
+		 */
+		exec_t continuations_exec() const noexcept
+		{
+			return m_continuations_exec.load(std::memory_order_relaxed);
+		}
+
+		void set_continuations_exec(exec_t exec) noexcept
+		{
+			m_continuations_exec.store(exec, std::memory_order_relaxed);
+		}
+
+	public:
+
+		/** \brief     ,       \a manager::all.
+		 *
+		 * \details   - \a std::pmr::get_default_resource()     (. \a async::pool_resource).
+		 *             ,    ,       ,
+		 *                    ( \a std::pmr).
+		 */
+		std::pmr::memory_resource* memory_resource() const noexcept
+		{
+			return m_memory_resource.load(std::memory_order_relaxed);
+		}
+
+		void set_memory_resource(std::pmr::memory_resource* resource) noexcept
+		{
+			assert(resource);
+			m_memory_resource.store(resource, std::memory_order_relaxed);
+		}
+
+		/** \brief  ,   (     \a task_t)   \a pool::memory_resource.
+		 */
+		template<class _Functor>
+		task_t make_task(_Functor&& functor) const
+		{
+			if constexpr (std::is_same_v<std::decay_t<_Functor>, task_t>)
+				return std::forward<_Functor>(functor);
+			else
+				return task_t{ std::allocator_arg, memory_resource(), std::forward<_Functor>(functor) };
+		}
+
+		/** \brief    (\a std::allocate_shared)  \a pool::memory_resource.
+		 */
+		template<class _Type, class... _Args>
+		std::shared_ptr<_Type> allocate_shared(_Args&&... args) const
+		{
+			return std::allocate_shared<_Type>(std::pmr::polymorphic_allocator<_Type>{ memory_resource() }, std::forward<_Args>(args)...);
+		}
+
 	public:
 
 		virtual ~pool() = default;
@@ -140,24 +252,133 @@ namespace async
 		static constexpr ctx_t unknown_ctx{ nullptr, 0 };
 		static constexpr std::chrono::microseconds wait_time_zero{ 0 };
 
+		/** \brief    .
+		 *
+		 * \details    -       ,    - \a pool::unknown_ctx.
+		 *             thread_local ,      ,   O(1).
+		 */
+		static ctx_t current_ctx() noexcept
+		{
+			return this_thread_ctx();
+		}
+
 	protected:
 
 		struct tasks_t;
+		struct tasks_lockfree_t;
+
+		/** \brief         (. \a pool::current_ctx).
+		 */
+		class current_ctx_scope
+		{
+		public:
+
+			explicit current_ctx_scope(ctx_t pool_ctx) noexcept
+				: m_prev_ctx{ this_thread_ctx() }
+			{
+				this_thread_ctx() = pool_ctx;
+			}
+
+			~current_ctx_scope()
+			{
+				this_thread_ctx() = m_prev_ctx;
+			}
+
+			current_ctx_scope(const current_ctx_scope& other) = delete;
+			current_ctx_scope& operator=(const current_ctx_scope& other) = delete;
+
+		private:
+
+			const ctx_t m_prev_ctx;
+		};
+
+		/** \brief  :  \a pool::unknown_ctx -   .
+		 *
+		 * \details  ,       (  \a promise::send),
+		 *                     .
+		 */
+		static ctx_t known_ctx(ctx_t this_ctx) noexcept
+		{
+			return (std::get<pool*>(this_ctx) != nullptr) ? this_ctx : current_ctx();
+		}
+
+		/** \brief      ,    - \a details::pool_counters::external_thread.
+		 */
+		std::size_t own_thread_index(ctx_t this_ctx) const noexcept
+		{
+			return (std::get<pool*>(this_ctx) == this) ? std::get<std::size_t>(this_ctx) : details::pool_counters::external_thread;
+		}
+
+	private:
+
+		static ctx_t& this_thread_ctx() noexcept
+		{
+			static thread_local ctx_t ctx{ nullptr, 0 };
+			return ctx;
+		}
+
+	private:
+
+		std::atomic<exec_t> m_continuations_exec{ exec_t::queued };
+		std::atomic<std::pmr::memory_resource*> m_memory_resource{ std::pmr::get_default_resource() };
 	};
 
 
+	inline void pool::add_tasks(ctx_t this_ctx, task_t* tasks, std::size_t count, priority_t priority)
+	{
+		for (std::size_t index = 0; index < count; ++index)
+		{
+			add_task((index == 0 ? this_ctx : unknown_ctx), std::move(tasks[index]), priority);
+		}
+	}
+
+
 	struct pool::tasks_t
 	{
-		std::deque<task_t>  queue;
+		std::array<std::deque<task_t>, priorities_count> queues; //    
 		std::vector<task_t> out_of_queue_by_threads;
+		details::lanes_aging<priorities_count> aging;
 
 	public:
 
 		std::size_t queue_size() const noexcept;
 		bool queue_is_empty() const noexcept;
+		bool queue_is_empty_above(priority_t priority) const noexcept;
 
-		void add_task_in_queue(task_t task);
+		void add_task_in_queue(task_t task, priority_t priority);
 		task_t take_next_task(std::size_t thread_index);
+		bool try_take_next_task(std::size_t thread_index, task_t& task);
+
+		bool tasks_is_exists(std::size_t thread_index) const;
+		bool tasks_is_exists() const;
+
+		void set_task_out_of_queue(std::size_t thread_index, task_t task);
+		bool out_of_queue_is_exists(std::size_t thread_index) const;
+
+		void move_extra_tasks_in_begin_queue();
+	};
+
+
+	/** \brief    :  \a pool::tasks_t.
+	 *
+	 * \details     ,           
+	 *               ;         .
+	 *           \a out_of_queue_by_threads     (  ,    ).
+	 */
+	struct pool::tasks_lockfree_t
+	{
+		details::mpmc_lanes<task_t, priorities_count> queue;
+		std::vector<task_t> out_of_queue_by_threads;
+		std::atomic<std::size_t> out_of_queue_count{ 0 };
+
+	public:
+
+		std::size_t queue_size() const noexcept;
+		bool queue_is_empty() const noexcept;
+		bool queue_is_empty_above(priority_t priority) const noexcept;
+
+		void add_task_in_queue(task_t task, priority_t priority);
+		bool try_take_next_task(std::size_t thread_index, task_t& task);
 
 		bool tasks_is_exists(std::size_t thread_index) const;
 		bool tasks_is_exists() const;
@@ -178,18 +399,42 @@ namespace async
 
 	[[nodiscard]] inline std::size_t pool::tasks_t::queue_size() const noexcept
 	{
-		return queue.size();
+		std::size_t result{ 0 };
+
+		for (const std::deque<task_t>& queue : queues)
+			result += queue.size();
+
+		return result;
 	}
 	
 	[[nodiscard]] inline bool pool::tasks_t::queue_is_empty() const noexcept
 	{
-		return queue.empty();
+		for (const std::deque<task_t>& queue : queues)
+		{
+			if (!queue.empty())
+				return false;
+		}
+
+		return true;
+	}
+
+	[[nodiscard]] inline bool pool::tasks_t::queue_is_empty_above(priority_t priority) const noexcept
+	{
+		for (std::size_t lane = 0; lane < static_cast<std::size_t>(priority); ++lane)
+		{
+			if (!queues[lane].empty())
+				return false;
+		}
+
+		return true;
 	}
 	
-	inline void pool::tasks_t::add_task_in_queue(task_t tsk)
+	inline void pool::tasks_t::add_task_in_queue(task_t tsk, priority_t priority)
 	{
 		assert(tsk);
-		queue.push_back(std::move(tsk));
+		assert(static_cast<std::size_t>(priority) < priorities_count);
+
+		queues[static_cast<std::size_t>(priority)].push_back(std::move(tsk));
 	}
 	
 	[[nodiscard]] inline pool::task_t pool::tasks_t::take_next_task(std::size_t thread_index)
@@ -198,7 +443,7 @@ namespace async
 
 		task_t& task_out_of_queue{ out_of_queue_by_threads[thread_index] };
 
-		assert(!queue.empty() || task_out_of_queue);
+		assert(!queue_is_empty() || task_out_of_queue);
 
 		task_t result{ nullptr };
 
@@ -208,8 +453,19 @@ namespace async
 		}
 		else
 		{
-			result.swap(queue.front());
-			queue.pop_front();
+			[[maybe_unused]] const bool is_taken{ aging.try_take(
+				[this, &result](std::size_t lane)
+				{
+					if (queues[lane].empty())
+						return false;
+
+					result.swap(queues[lane].front());
+					queues[lane].pop_front();
+					return true;
+				},
+				[this](std::size_t lane) { return queues[lane].empty(); }) };
+
+			assert(is_taken);
 		}
 
 		assert(result);
@@ -218,6 +474,15 @@ namespace async
 		return result;
 	}
 	
+	[[nodiscard]] inline bool pool::tasks_t::try_take_next_task(std::size_t thread_index, task_t& tsk)
+	{
+		if (!tasks_is_exists(thread_index))
+			return false;
+
+		tsk = take_next_task(thread_index);
+		return true;
+	}
+	
 	[[nodiscard]] inline bool pool::tasks_t::tasks_is_exists(std::size_t thread_index) const
 	{
 		return !queue_is_empty() || out_of_queue_is_exists(thread_index);
@@ -254,10 +519,122 @@ namespace async
 
 	inline void pool::tasks_t::move_extra_tasks_in_begin_queue()
 	{
+		//          ,   
+
+		for (task_t& tsk : out_of_queue_by_threads)
+		{
+			if (tsk)
+				queues[static_cast<std::size_t>(priority_t::critical)].push_front(std::move(tsk));
+		}
+	}
+
+
+	[[nodiscard]] inline std::size_t pool::tasks_lockfree_t::queue_size() const noexcept
+	{
+		return queue.size_approx();
+	}
+
+	[[nodiscard]] inline bool pool::tasks_lockfree_t::queue_is_empty() const noexcept
+	{
+		return queue.empty_approx();
+	}
+
+	[[nodiscard]] inline bool pool::tasks_lockfree_t::queue_is_empty_above(priority_t priority) const noexcept
+	{
+		for (std::size_t lane = 0; lane < static_cast<std::size_t>(priority); ++lane)
+		{
+			if (!queue.empty_approx(lane))
+				return false;
+		}
+
+		return true;
+	}
+
+	inline void pool::tasks_lockfree_t::add_task_in_queue(task_t tsk, priority_t priority)
+	{
+		assert(tsk);
+		assert(static_cast<std::size_t>(priority) < priorities_count);
+
+		queue.push(std::move(tsk), static_cast<std::size_t>(priority));
+	}
+
+	[[nodiscard]] inline bool pool::tasks_lockfree_t::try_take_next_task(std::size_t thread_index, task_t& tsk)
+	{
+		assert(thread_index < out_of_queue_by_threads.size());
+		assert(!tsk);
+
+		task_t& task_out_of_queue{ out_of_queue_by_threads[thread_index] };
+
+		if (task_out_of_queue)
+		{
+			tsk.swap(task_out_of_queue);
+			out_of_queue_count.fetch_sub(1);
+		}
+		else
+		if (!queue.try_pop(tsk))
+		{
+			return false;
+		}
+
+		assert(tsk);
+		assert(!task_out_of_queue);
+
+		return true;
+	}
+
+	[[nodiscard]] inline bool pool::tasks_lockfree_t::tasks_is_exists(std::size_t thread_index) const
+	{
+		return !queue_is_empty() || out_of_queue_is_exists(thread_index);
+	}
+
+	[[nodiscard]] inline bool pool::tasks_lockfree_t::tasks_is_exists() const
+	{
+		return !queue_is_empty() || (out_of_queue_count.load() > 0);
+	}
+
+	inline void pool::tasks_lockfree_t::set_task_out_of_queue(std::size_t thread_index, task_t tsk)
+	{
+		assert(tsk);
+		assert(thread_index < out_of_queue_by_threads.size());
+		assert(!out_of_queue_by_threads[thread_index]);
+
+		tsk.swap(out_of_queue_by_threads[thread_index]);
+		out_of_queue_count.fetch_add(1);
+	}
+
+	[[nodiscard]] inline bool pool::tasks_lockfree_t::out_of_queue_is_exists(std::size_t thread_index) const
+	{
+		assert(thread_index < out_of_queue_by_threads.size());
+		return static_cast<bool>(out_of_queue_by_threads[thread_index]);
+	}
+
+	inline void pool::tasks_lockfree_t::move_extra_tasks_in_begin_queue()
+	{
+		// ,    :      ,   .
+		//          ,       
+
+		std::array<std::deque<task_t>, priorities_count> queue_tails;
+
+		for (std::size_t lane = 0; lane < priorities_count; ++lane)
+		{
+			for (task_t tsk{}; queue.try_pop(tsk, lane); tsk = nullptr)
+				queue_tails[lane].push_back(std::move(tsk));
+		}
+
 		for (task_t& tsk : out_of_queue_by_threads)
 		{
 			if (tsk)
-				queue.push_front(std::move(tsk));
+			{
+				queue.push(std::move(tsk), static_cast<std::size_t>(priority_t::critical));
+				tsk = nullptr;
+				out_of_queue_count.fetch_sub(1);
+			}
+		}
+
+		for (std::size_t lane = 0; lane < priorities_count; ++lane)
+		{
+			for (task_t& tsk : queue_tails[lane])
+				queue.push(std::move(tsk), lane);
 		}
 	}
 }
\ No newline at end of file
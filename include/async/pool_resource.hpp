@@ -0,0 +1,290 @@
+#pragma once
+
+
+#include <new>
+#include <array>
+#include <atomic>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <algorithm>
+#include <memory_resource>
+
+
+namespace async
+{
+	/** \brief Lock-free memory resource of small blocks for the state of promises (see \a manager::set_memory_resource).
+	 *
+	 * \details The blocks are grouped by the size classes, tuned for the shared state of promises, the closures
+	 *          of the next steps and the shared state of \a manager::all. Every class has its own free list:
+	 *          the lock-free stack of the indexes of blocks with the counter of changes in the head (against ABA),
+	 *          so \a allocate and \a deallocate of a released block are one CAS each.
+	 *
+	 * \details The blocks of a class are taken from the chunks of the upstream resource, every next chunk is twice bigger.
+	 *          The chunks are returned to the upstream only by the destructor, so the resource must outlive everything
+	 *          allocated from it (the usual rule of \a std::pmr).
+	 *
+	 * \details The blocks bigger than the largest class or with the alignment stricter than \a std::max_align_t
+	 *          are allocated by the upstream resource directly.
+	 */
+	class pool_resource : public std::pmr::memory_resource
+	{
+	public:
+
+		static constexpr std::array<std::size_t, 8> size_classes{ 32, 64, 96, 128, 192, 256, 384, 512 };
+
+		static constexpr std::size_t first_chunk_blocks{ 64 };
+		static constexpr std::size_t chunks_max{ 24 };
+
+	public:
+
+		explicit pool_resource(std::pmr::memory_resource* upstream = std::pmr::get_default_resource()) noexcept
+			: m_upstream{ upstream }
+			, m_classes{}
+		{
+			assert(m_upstream);
+		}
+
+		~pool_resource() override
+		{
+			for (std::size_t class_index = 0; class_index < size_classes.size(); ++class_index)
+			{
+				for (std::size_t chunk_index = 0; chunk_index < chunks_max; ++chunk_index)
+				{
+					if (std::byte* const chunk = m_classes[class_index].chunks[chunk_index].load(std::memory_order_relaxed))
+						m_upstream->deallocate(chunk, chunk_bytes(class_index, chunk_index), chunk_alignment);
+				}
+			}
+		}
+
+		pool_resource(pool_resource&& other) = delete;
+		pool_resource(const pool_resource& other) = delete;
+
+		pool_resource& operator=(pool_resource&& other) = delete;
+		pool_resource& operator=(const pool_resource& other) = delete;
+
+	public:
+
+		[[nodiscard]] std::pmr::memory_resource* upstream_resource() const noexcept
+		{
+			return m_upstream;
+		}
+
+		/** \brief Number of the blocks taken from the chunks (free and in use) of all size classes.
+		 */
+		[[nodiscard]] std::size_t blocks_count() const noexcept
+		{
+			std::size_t result{ 0 };
+
+			for (const size_class_t& size_class : m_classes)
+				result += std::min<std::size_t>(size_class.blocks_next.load(std::memory_order_relaxed), blocks_max);
+
+			return result;
+		}
+
+	protected:
+
+		void* do_allocate(std::size_t bytes, std::size_t alignment) override
+		{
+			const std::size_t class_index{ size_class_index(bytes, alignment) };
+
+			if (class_index == class_none)
+				return m_upstream->allocate(bytes, alignment);
+
+			size_class_t& size_class{ m_classes[class_index] };
+
+			std::uint64_t head{ size_class.free_head.load(std::memory_order_acquire) };
+
+			while (free_head_index(head) != index_none)
+			{
+				const std::uint32_t index{ free_head_index(head) };
+				const std::uint32_t next{ next_of(size_class, index).load(std::memory_order_relaxed) };
+
+				if (size_class.free_head.compare_exchange_weak(head, make_free_head(head, next), std::memory_order_acquire, std::memory_order_acquire))
+					return block_of(class_index, size_class, index);
+			}
+
+			return new_block(class_index, size_class);
+		}
+
+		void do_deallocate(void* ptr, std::size_t bytes, std::size_t alignment) override
+		{
+			const std::size_t class_index{ size_class_index(bytes, alignment) };
+
+			if (class_index == class_none)
+				return m_upstream->deallocate(ptr, bytes, alignment);
+
+			size_class_t& size_class{ m_classes[class_index] };
+
+			const std::uint32_t index{ index_of(class_index, size_class, static_cast<std::byte*>(ptr)) };
+			std::atomic<std::uint32_t>& next{ next_of(size_class, index) };
+
+			std::uint64_t head{ size_class.free_head.load(std::memory_order_relaxed) };
+
+			do
+			{
+				next.store(free_head_index(head), std::memory_order_relaxed);
+			}
+			while (!size_class.free_head.compare_exchange_weak(head, make_free_head(head, index), std::memory_order_release, std::memory_order_relaxed));
+		}
+
+		bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override
+		{
+			return (this == &other);
+		}
+
+	private:
+
+		static constexpr std::size_t class_none{ size_classes.size() };
+		static constexpr std::uint32_t index_none{ ~std::uint32_t{ 0 } };
+
+		static constexpr std::size_t chunk_alignment{ 64 };
+		static constexpr std::size_t blocks_max{ first_chunk_blocks * ((std::size_t{ 1 } << chunks_max) - 1) };
+
+		static_assert(blocks_max < index_none);
+
+		/** \brief Blocks of one size class: the chunk number \a n has \a first_chunk_blocks * 2^n blocks.
+		 *
+		 * \details The links of the free list are stored apart from the blocks (in the head of the chunk),
+		 *          so the stale read of the link by the losing \a allocate never touches the memory of the user.
+		 */
+		struct size_class_t
+		{
+			std::atomic<std::uint64_t> free_head{ make_free_head(0, index_none) }; // (changes << 32) | index
+			std::atomic<std::uint64_t> blocks_next{ 0 };                          // Blocks never taken from the chunks
+			std::array<std::atomic<std::byte*>, chunks_max> chunks{};
+		};
+
+	private:
+
+		[[nodiscard]] static constexpr std::size_t size_class_index(std::size_t bytes, std::size_t alignment) noexcept
+		{
+			if (alignment > alignof(std::max_align_t))
+				return class_none;
+
+			for (std::size_t class_index = 0; class_index < size_classes.size(); ++class_index)
+			{
+				if (bytes <= size_classes[class_index])
+					return class_index;
+			}
+
+			return class_none;
+		}
+
+		[[nodiscard]] static constexpr std::uint32_t free_head_index(std::uint64_t head) noexcept
+		{
+			return static_cast<std::uint32_t>(head);
+		}
+
+		[[nodiscard]] static constexpr std::uint64_t make_free_head(std::uint64_t prev_head, std::uint32_t index) noexcept
+		{
+			return (((prev_head >> 32) + 1) << 32) | index;
+		}
+
+		[[nodiscard]] static constexpr std::size_t chunk_blocks(std::size_t chunk_index) noexcept
+		{
+			return (first_chunk_blocks << chunk_index);
+		}
+
+		[[nodiscard]] static constexpr std::size_t chunk_first_index(std::size_t chunk_index) noexcept
+		{
+			return first_chunk_blocks * ((std::size_t{ 1 } << chunk_index) - 1);
+		}
+
+		[[nodiscard]] static constexpr std::size_t chunk_index_of(std::size_t index) noexcept
+		{
+			std::size_t chunk_index{ 0 };
+
+			for (std::size_t rest = index / first_chunk_blocks + 1; rest > 1; rest >>= 1)
+				++chunk_index;
+
+			return chunk_index;
+		}
+
+		[[nodiscard]] static constexpr std::size_t chunk_links_bytes(std::size_t chunk_index) noexcept
+		{
+			return (chunk_blocks(chunk_index) * sizeof(std::atomic<std::uint32_t>) + chunk_alignment - 1) / chunk_alignment * chunk_alignment;
+		}
+
+		[[nodiscard]] static constexpr std::size_t chunk_bytes(std::size_t class_index, std::size_t chunk_index) noexcept
+		{
+			return chunk_links_bytes(chunk_index) + chunk_blocks(chunk_index) * size_classes[class_index];
+		}
+
+		[[nodiscard]] static std::byte* chunk_of(const size_class_t& size_class, std::size_t chunk_index) noexcept
+		{
+			std::byte* const chunk{ size_class.chunks[chunk_index].load(std::memory_order_acquire) };
+			assert(chunk);
+			return chunk;
+		}
+
+		[[nodiscard]] static std::atomic<std::uint32_t>& next_of(const size_class_t& size_class, std::uint32_t index) noexcept
+		{
+			const std::size_t chunk_index{ chunk_index_of(index) };
+			std::byte* const chunk{ chunk_of(size_class, chunk_index) };
+
+			return reinterpret_cast<std::atomic<std::uint32_t>*>(chunk)[index - chunk_first_index(chunk_index)];
+		}
+
+		[[nodiscard]] static void* block_of(std::size_t class_index, const size_class_t& size_class, std::uint32_t index) noexcept
+		{
+			const std::size_t chunk_index{ chunk_index_of(index) };
+			std::byte* const chunk{ chunk_of(size_class, chunk_index) };
+
+			return chunk + chunk_links_bytes(chunk_index) + (index - chunk_first_index(chunk_index)) * size_classes[class_index];
+		}
+
+		[[nodiscard]] static std::uint32_t index_of(std::size_t class_index, const size_class_t& size_class, const std::byte* block) noexcept
+		{
+			for (std::size_t chunk_index = 0; chunk_index < chunks_max; ++chunk_index)
+			{
+				const std::byte* const chunk{ size_class.chunks[chunk_index].load(std::memory_order_acquire) };
+				if (!chunk)
+					continue;
+
+				const std::byte* const blocks{ chunk + chunk_links_bytes(chunk_index) };
+
+				if (blocks <= block && block < blocks + chunk_blocks(chunk_index) * size_classes[class_index])
+					return static_cast<std::uint32_t>(chunk_first_index(chunk_index) + static_cast<std::size_t>(block - blocks) / size_classes[class_index]);
+			}
+
+			assert(false && "The block is not allocated by this resource");
+			return index_none;
+		}
+
+		[[nodiscard]] void* new_block(std::size_t class_index, size_class_t& size_class)
+		{
+			const std::uint64_t index{ size_class.blocks_next.fetch_add(1, std::memory_order_relaxed) };
+
+			if (index >= blocks_max)
+				throw std::bad_alloc{};
+
+			const std::size_t chunk_index{ chunk_index_of(static_cast<std::size_t>(index)) };
+			std::atomic<std::byte*>& chunk{ size_class.chunks[chunk_index] };
+
+			if (!chunk.load(std::memory_order_acquire))
+			{
+				// Several threads may get the first blocks of the chunk at the same time: one chunk wins
+
+				const std::size_t bytes{ chunk_bytes(class_index, chunk_index) };
+
+				std::byte* const new_chunk{ static_cast<std::byte*>(m_upstream->allocate(bytes, chunk_alignment)) };
+
+				for (std::size_t link = 0; link < chunk_blocks(chunk_index); ++link)
+					::new (static_cast<void*>(new_chunk + link * sizeof(std::atomic<std::uint32_t>))) std::atomic<std::uint32_t>{ index_none };
+
+				std::byte* expected{ nullptr };
+				if (!chunk.compare_exchange_strong(expected, new_chunk, std::memory_order_acq_rel, std::memory_order_acquire))
+					m_upstream->deallocate(new_chunk, bytes, chunk_alignment);
+			}
+
+			return block_of(class_index, size_class, static_cast<std::uint32_t>(index));
+		}
+
+	private:
+
+		std::pmr::memory_resource* const m_upstream;
+		std::array<size_class_t, size_classes.size()> m_classes;
+	};
+
+} // namespace async
@@ -0,0 +1,334 @@
+#pragma once
+
+
+#include <limits>
+#include <memory>
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <cstdint>
+#include <cstddef>
+#include <algorithm>
+
+
+namespace async
+{
+
+	/** \brief Snapshot of the counters of pool (see \a pool::stats).
+	 *
+	 * \details The counters are cumulative from the creation of the pool, the rates (e.g. the throughput) are
+	 *          the differences of two snapshots divided by the time between them.
+	 */
+	struct pool_stats
+	{
+		std::uint64_t tasks_enqueued{ 0 };    // Added by add_task / add_tasks (also out of the queue)
+		std::uint64_t tasks_dequeued{ 0 };    // Taken by the threads of pool
+		std::uint64_t tasks_executed{ 0 };    // Finished (also with the exception)
+		std::uint64_t queue_depth{ 0 };       // Added and not taken yet
+		std::uint64_t out_of_queue_hits{ 0 }; // Added to the place out of the queue of the thread (UseThreadReservationAlgorithm)
+
+		std::uint64_t idle_count{ 0 };        // The thread found no task
+		std::uint64_t park_count{ 0 };        // The thread fell asleep on the condition variable
+		std::uint64_t wake_count{ 0 };        // The thread woke up after the sleep
+
+		std::chrono::nanoseconds wait_time{ 0 }; // Time of the tasks in the queue (of the tasks in the queue now - until now)
+		std::chrono::nanoseconds run_time{ 0 };  // Time of the execution of the tasks
+	};
+
+} // namespace async
+
+
+namespace async::details
+{
+
+	/** \brief Counters of pool: one slot for every thread of pool and a few slots for the other threads, which add the tasks.
+	 *
+	 * \details The slot is on its own cache lines and is changed by its thread only, so the work threads do not share
+	 *          the memory for the counters. The changes of the slot are framed by its version (seqlock): \a snapshot
+	 *          does not lock anything, it reads the slot again if it was changed during the reading.
+	 *
+	 * \details The other threads are spread over \a external_slots_count slots. Such a thread does not wait for the slot,
+	 *          which is being changed by another thread: it takes the next free one.
+	 *
+	 * \details The time in the queue is not measured for every task: the slots sum the times of the enqueues and of the dequeues,
+	 *          so the total time in the queue is the sum of the dequeues minus the sum of the enqueues plus the time until now
+	 *          of the tasks still in the queue. The enqueue is counted before the task is added in the queue.
+	 */
+	class pool_counters
+	{
+	public:
+
+		using clock_t = std::chrono::steady_clock;
+
+		static constexpr std::size_t external_thread{ static_cast<std::size_t>(-1) };
+		static constexpr std::size_t external_slots_count{ 8 };
+
+	public:
+
+		explicit pool_counters(std::size_t threads_count)
+			: m_start{ clock_t::now() }
+			, m_threads_count{ threads_count }
+			, m_slots{ std::make_unique<slot_t[]>(threads_count + external_slots_count) }
+		{}
+
+		pool_counters(pool_counters&& other) = delete;
+		pool_counters(const pool_counters& other) = delete;
+
+		pool_counters& operator=(pool_counters&& other) = delete;
+		pool_counters& operator=(const pool_counters& other) = delete;
+
+	public:
+
+		/** \param thread_index - The thread of pool, which adds the tasks, or \a external_thread.
+		 */
+		void enqueued(std::size_t thread_index, std::size_t count, bool out_of_queue = false) noexcept
+		{
+			if (count == 0)
+				return;
+
+			const std::uint64_t time{ now() };
+
+			change(thread_index, [time, count, out_of_queue](slot_t& slot)
+			{
+				add(slot.enqueued, count);
+				add(slot.enqueue_time, time * count);
+
+				if (out_of_queue)
+					add(slot.out_of_queue_hits, 1);
+			});
+		}
+
+		/** \return The start of the execution of the task for \a executed.
+		 */
+		[[nodiscard]] std::uint64_t dequeued(std::size_t thread_index) noexcept
+		{
+			const std::uint64_t time{ now() };
+
+			change(thread_index, [time](slot_t& slot)
+			{
+				add(slot.dequeued, 1);
+				add(slot.dequeue_time, time);
+			});
+
+			return time;
+		}
+
+		void executed(std::size_t thread_index, std::uint64_t start_time) noexcept
+		{
+			const std::uint64_t run_time{ now() - start_time };
+
+			change(thread_index, [run_time](slot_t& slot)
+			{
+				add(slot.executed, 1);
+				add(slot.run_time, run_time);
+			});
+		}
+
+		void idle(std::size_t thread_index) noexcept
+		{
+			change(thread_index, [](slot_t& slot) { add(slot.idle, 1); });
+		}
+
+		void parked(std::size_t thread_index) noexcept
+		{
+			change(thread_index, [](slot_t& slot) { add(slot.parked, 1); });
+		}
+
+		void woken(std::size_t thread_index) noexcept
+		{
+			change(thread_index, [](slot_t& slot) { add(slot.woken, 1); });
+		}
+
+		[[nodiscard]] pool_stats snapshot() const noexcept
+		{
+			// The dequeues are read before the enqueues: every task taken by a thread is already counted as added
+
+			pool_stats result{};
+			std::uint64_t dequeue_time{ 0 };
+			std::uint64_t enqueue_time{ 0 };
+			std::uint64_t run_time{ 0 };
+
+			for (std::size_t index = 0; index < m_threads_count + external_slots_count; ++index)
+			{
+				const values_t values{ read(m_slots[index]) };
+
+				result.tasks_dequeued += values.dequeued;
+				result.tasks_executed += values.executed;
+				result.idle_count += values.idle;
+				result.park_count += values.parked;
+				result.wake_count += values.woken;
+				dequeue_time += values.dequeue_time;
+				run_time += values.run_time;
+			}
+
+			for (std::size_t index = 0; index < m_threads_count + external_slots_count; ++index)
+			{
+				const values_t values{ read(m_slots[index]) };
+
+				result.tasks_enqueued += values.enqueued;
+				result.out_of_queue_hits += values.out_of_queue_hits;
+				enqueue_time += values.enqueue_time;
+			}
+
+			const std::uint64_t time{ now() };
+
+			result.queue_depth = (result.tasks_enqueued > result.tasks_dequeued) ? (result.tasks_enqueued - result.tasks_dequeued) : 0;
+
+			// The sums of the times overflow, but their difference does not (the arithmetic is modulo 2^64)
+			const std::uint64_t wait_time{ dequeue_time + time * result.queue_depth - enqueue_time };
+
+			result.wait_time = std::chrono::nanoseconds{ static_cast<std::int64_t>(std::min<std::uint64_t>(wait_time, std::numeric_limits<std::int64_t>::max())) };
+			result.run_time = std::chrono::nanoseconds{ static_cast<std::int64_t>(run_time) };
+
+			return result;
+		}
+
+	private:
+
+		struct alignas(64) slot_t
+		{
+			std::atomic<std::uint64_t> version{ 0 }; // Odd during the change
+
+			std::atomic<std::uint64_t> enqueued{ 0 };
+			std::atomic<std::uint64_t> enqueue_time{ 0 };
+			std::atomic<std::uint64_t> out_of_queue_hits{ 0 };
+			std::atomic<std::uint64_t> dequeued{ 0 };
+			std::atomic<std::uint64_t> dequeue_time{ 0 };
+			std::atomic<std::uint64_t> executed{ 0 };
+			std::atomic<std::uint64_t> run_time{ 0 };
+			std::atomic<std::uint64_t> idle{ 0 };
+			std::atomic<std::uint64_t> parked{ 0 };
+			std::atomic<std::uint64_t> woken{ 0 };
+		};
+
+		struct values_t
+		{
+			std::uint64_t enqueued;
+			std::uint64_t enqueue_time;
+			std::uint64_t out_of_queue_hits;
+			std::uint64_t dequeued;
+			std::uint64_t dequeue_time;
+			std::uint64_t executed;
+			std::uint64_t run_time;
+			std::uint64_t idle;
+			std::uint64_t parked;
+			std::uint64_t woken;
+		};
+
+	private:
+
+		std::uint64_t now() const noexcept
+		{
+			return static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(clock_t::now() - m_start).count());
+		}
+
+		static std::size_t external_slot_of_this_thread() noexcept
+		{
+			static std::atomic<std::size_t> next_slot{ 0 };
+			static thread_local const std::size_t slot_index{ next_slot.fetch_add(1, std::memory_order_relaxed) % external_slots_count };
+
+			return slot_index;
+		}
+
+		static void add(std::atomic<std::uint64_t>& counter, std::uint64_t value) noexcept
+		{
+			// Only the owner of the version changes the counter
+			counter.store(counter.load(std::memory_order_relaxed) + value, std::memory_order_relaxed);
+		}
+
+		template<class _Change>
+		void change(std::size_t thread_index, _Change&& change_slot) noexcept
+		{
+			if (thread_index < m_threads_count)
+			{
+				slot_t& slot{ m_slots[thread_index] };
+
+				// The slot of the thread of pool has one writer: the version is not waited for in practice
+				std::uint64_t version{ slot.version.load(std::memory_order_relaxed) };
+
+				while ((version & 1) || !slot.version.compare_exchange_weak(version, version + 1, std::memory_order_acquire, std::memory_order_relaxed))
+				{
+					if (version & 1)
+					{
+						std::this_thread::yield();
+						version = slot.version.load(std::memory_order_relaxed);
+					}
+				}
+
+				change_locked(slot, version, std::forward<_Change>(change_slot));
+				return;
+			}
+
+			// The slots of the other threads have many writers: the version is also their lock, the busy slot is skipped
+			const std::size_t first_index{ external_slot_of_this_thread() };
+
+			for (std::size_t index = first_index;;)
+			{
+				slot_t& slot{ m_slots[m_threads_count + index] };
+
+				std::uint64_t version{ slot.version.load(std::memory_order_relaxed) };
+
+				if (!(version & 1) && slot.version.compare_exchange_strong(version, version + 1, std::memory_order_acquire, std::memory_order_relaxed))
+				{
+					change_locked(slot, version, std::forward<_Change>(change_slot));
+					return;
+				}
+
+				index = (index + 1) % external_slots_count;
+
+				if (index == first_index)
+					std::this_thread::yield(); // All the slots are busy
+			}
+		}
+
+		template<class _Change>
+		static void change_locked(slot_t& slot, std::uint64_t version, _Change&& change_slot) noexcept
+		{
+			// Invoke with the odd version of the slot: version + 1
+
+			std::atomic_thread_fence(std::memory_order_release); // The readers see the odd version before the new values
+
+			change_slot(slot);
+
+			slot.version.store(version + 2, std::memory_order_release);
+		}
+
+		static values_t read(const slot_t& slot) noexcept
+		{
+			for (;;)
+			{
+				const std::uint64_t version{ slot.version.load(std::memory_order_acquire) };
+
+				if (version & 1)
+				{
+					std::this_thread::yield();
+					continue;
+				}
+
+				const values_t values{
+					slot.enqueued.load(std::memory_order_relaxed),
+					slot.enqueue_time.load(std::memory_order_relaxed),
+					slot.out_of_queue_hits.load(std::memory_order_relaxed),
+					slot.dequeued.load(std::memory_order_relaxed),
+					slot.dequeue_time.load(std::memory_order_relaxed),
+					slot.executed.load(std::memory_order_relaxed),
+					slot.run_time.load(std::memory_order_relaxed),
+					slot.idle.load(std::memory_order_relaxed),
+					slot.parked.load(std::memory_order_relaxed),
+					slot.woken.load(std::memory_order_relaxed) };
+
+				std::atomic_thread_fence(std::memory_order_acquire);
+
+				if (slot.version.load(std::memory_order_relaxed) == version)
+					return values;
+			}
+		}
+
+	private:
+
+		const clock_t::time_point m_start;
+		const std::size_t m_threads_count;
+		const std::unique_ptr<slot_t[]> m_slots; // The last external_slots_count - for the other threads
+	};
+
+} // namespace async::details
@@ -4,17 +4,20 @@
 
 #include <mutex>
 #include <tuple>
+#include <atomic>
 #include <thread>
 #include <variant>
 #include <cstdint>
 #include <optional>
 #include <algorithm>
+#include <type_traits>
 #include <functional>
 #include <condition_variable>
 
-#include <async\pool.hpp>
-#include <async\logger.hpp>
-#include <async\promise_errc.hpp>
+#include <async/pool.hpp>
+#include <async/logger.hpp>
+#include <async/idle_policy.hpp>
+#include <async/promise_errc.hpp>
 
 
 namespace async::pool_threads
@@ -26,9 +29,12 @@ namespace async::pool_threads
 	public:
 
 		static constexpr bool UseThreadReservationAlgorithm{ true };
+		static constexpr bool UseLockFreeQueue{ true }; // The mutex is used only to park and wake up threads
 
 	private:
 
+		using tasks_storage_t = std::conditional_t<UseLockFreeQueue, tasks_lockfree_t, tasks_t>;
+
 		struct data_t
 		{
 			mutable std::mutex access;
@@ -40,15 +46,17 @@ namespace async::pool_threads
 
 			} cv;
 
-            std::unique_ptr<logger> logger;
+            std::unique_ptr<async::logger> logger;
 			std::wstring pool_name;
 
 			std::size_t max_threads_count;
-			std::size_t idle_threads_count;
+			std::atomic<std::size_t> idle_threads_count; // Changed only under the mutex
+
+			tasks_storage_t tasks;
 
-			tasks_t tasks;
+			std::atomic<bool> stop_working; // Changed only under the mutex
 
-			bool stop_working;
+			idle_policy idle;
 
 			std::function<void(const std::function<void()>&)> threads_wrapper;
 		};
@@ -60,8 +68,9 @@ namespace async::pool_threads
 
 	public:
 
-        always(std::unique_ptr<logger> logger, std::wstring pool_name, std::size_t threads_count, std::function<void(const std::function<void()>&)> threads_wrapper)
+        always(std::unique_ptr<logger> logger, std::wstring pool_name, std::size_t threads_count, std::function<void(const std::function<void()>&)> threads_wrapper, idle_policy idle = idle_policy::park())
 			: m_data{}
+			, m_counters{ normalize_threads_count(threads_count) }
 			, m_threads{}
 		{
             if (logger)
@@ -74,6 +83,7 @@ namespace async::pool_threads
 			m_data.max_threads_count = normalize_threads_count(threads_count);
 			m_data.idle_threads_count = 0;
 			m_data.threads_wrapper = std::move(threads_wrapper);
+			m_data.idle = idle;
 			m_data.tasks.out_of_queue_by_threads.resize(m_data.max_threads_count);
 
 			m_threads.storage.resize(m_data.max_threads_count);
@@ -82,8 +92,8 @@ namespace async::pool_threads
 			start_threads_impl(un_lk_data);
 		}
 
-        always(std::size_t threads_count, std::function<void(const std::function<void()>&)> threads_wrapper)
-            : always(nullptr, std::wstring{}, threads_count, std::move(threads_wrapper))
+        always(std::size_t threads_count, std::function<void(const std::function<void()>&)> threads_wrapper, idle_policy idle = idle_policy::park())
+            : always(nullptr, std::wstring{}, threads_count, std::move(threads_wrapper), idle)
         {}
 
 		virtual ~always() // noexcept(false)
@@ -99,38 +109,63 @@ namespace async::pool_threads
 
 	public:
 
-		virtual void add_task(ctx_t this_ctx, task_t task) override
+		virtual void add_task(ctx_t this_ctx, task_t task, priority_t priority = priority_t::normal) override
 		{
-			const std::lock_guard<std::mutex> lk{ m_data.access };
+			this_ctx = known_ctx(this_ctx);
 
-			if (m_data.stop_working)
+			if constexpr (UseLockFreeQueue)
 			{
-				m_data.tasks.add_task_in_queue(std::move(task));
-				return;
+				if (!try_set_task_out_of_queue(this_ctx, task))
+				{
+					m_counters.enqueued(own_thread_index(this_ctx), 1);
+					m_data.tasks.add_task_in_queue(std::move(task), priority);
+					wake_up_idle_thread();
+				}
 			}
-
-			if constexpr (UseThreadReservationAlgorithm)
+			else
 			{
-				assert(m_data.max_threads_count == m_threads.storage.size());
+				const std::lock_guard<std::mutex> lk{ m_data.access };
 
-				if (m_data.max_threads_count > 1 &&                           //        
-					this == std::get<pool*>(this_ctx) &&                 //         
-					m_data.tasks.queue_size() <= stopped_threads_count())     //     ( )    
+				if (!try_set_task_out_of_queue(this_ctx, task))
 				{
-					[[maybe_unused]] std::size_t thread_index{ static_cast<std::size_t>(-1) };
-					assert(this_thread_of_pool(&thread_index));
-					assert(thread_index == std::get<std::size_t>(this_ctx));
-
-					// ...          
-					m_data.tasks.set_task_out_of_queue(std::get<std::size_t>(this_ctx), std::move(task));
-					return;
+					m_counters.enqueued(own_thread_index(this_ctx), 1);
+					m_data.tasks.add_task_in_queue(std::move(task), priority);
+					notify_idle_threads(1);
 				}
 			}
+		}
 
-			m_data.tasks.add_task_in_queue(std::move(task));
+		virtual void add_tasks(ctx_t this_ctx, task_t* tasks, std::size_t count, priority_t priority = priority_t::normal) override
+		{
+			if (count == 0)
+				return;
 
-			if (m_data.idle_threads_count > 0)
-				m_data.cv.queue_changed.notify_one();
+			this_ctx = known_ctx(this_ctx);
+
+			if constexpr (UseLockFreeQueue)
+			{
+				const std::size_t first_index{ try_set_task_out_of_queue(this_ctx, tasks[0]) ? std::size_t{ 1 } : std::size_t{ 0 } };
+
+				m_counters.enqueued(own_thread_index(this_ctx), count - first_index);
+
+				for (std::size_t index = first_index; index < count; ++index)
+					m_data.tasks.add_task_in_queue(std::move(tasks[index]), priority);
+
+				wake_up_idle_threads(count - first_index);
+			}
+			else
+			{
+				const std::lock_guard<std::mutex> lk{ m_data.access };
+
+				const std::size_t first_index{ try_set_task_out_of_queue(this_ctx, tasks[0]) ? std::size_t{ 1 } : std::size_t{ 0 } };
+
+				m_counters.enqueued(own_thread_index(this_ctx), count - first_index);
+
+				for (std::size_t index = first_index; index < count; ++index)
+					m_data.tasks.add_task_in_queue(std::move(tasks[index]), priority);
+
+				notify_idle_threads(count - first_index);
+			}
 		}
 
 		virtual bool wait_tasks_complete() override
@@ -192,7 +227,7 @@ namespace async::pool_threads
 			std::size_t idle_threads_count{ 0 };
 			{
 				const std::lock_guard<std::mutex> lk{ m_data.access };
-				idle_threads_count = (m_data.stop_working ? max_threads_count() : m_data.idle_threads_count);
+				idle_threads_count = (m_data.stop_working ? max_threads_count() : m_data.idle_threads_count.load());
 			}
 
 			assert(max_threads_count() >= idle_threads_count);
@@ -205,6 +240,11 @@ namespace async::pool_threads
 			return m_data.max_threads_count;
 		}
 
+		virtual pool_stats stats() const override
+		{
+			return m_counters.snapshot();
+		}
+
     public:
 
         virtual logger* log() const noexcept override
@@ -212,11 +252,81 @@ namespace async::pool_threads
             return m_data.logger.get();
         }
 
+        virtual std::wstring_view name() const noexcept override
+        {
+            return m_data.pool_name;
+        }
+
 	private:
 
-		std::size_t stopped_threads_count() const noexcept
+		bool try_set_task_out_of_queue(ctx_t this_ctx, task_t& task)
+		{
+			// Invoke under mutex: m_data.access (if the queue is not lock-free)
+
+			if constexpr (UseThreadReservationAlgorithm)
+			{
+				assert(m_data.max_threads_count == m_threads.storage.size());
+
+				if (m_data.max_threads_count > 1 &&                                           //        
+					!m_data.stop_working &&
+					this == std::get<pool*>(this_ctx) &&                                 //         
+					m_data.tasks.queue_is_empty() &&                                      //      
+					!m_data.tasks.out_of_queue_is_exists(std::get<std::size_t>(this_ctx))) //         
+				{
+					[[maybe_unused]] std::size_t thread_index{ static_cast<std::size_t>(-1) };
+					assert(this_thread_of_pool(&thread_index));
+					assert(thread_index == std::get<std::size_t>(this_ctx));
+
+					// ...          
+					m_counters.enqueued(std::get<std::size_t>(this_ctx), 1, true);
+					m_data.tasks.set_task_out_of_queue(std::get<std::size_t>(this_ctx), std::move(task));
+					return true;
+				}
+			}
+
+			return false;
+		}
+
+		void wake_up_idle_thread()
+		{
+			// Pairs with the fence in thread_main_impl before a thread is parked
+			std::atomic_thread_fence(std::memory_order_seq_cst);
+
+			if (m_data.idle_threads_count.load() > 0)
+			{
+				const std::lock_guard<std::mutex> lk{ m_data.access };
+				m_data.cv.queue_changed.notify_one();
+			}
+		}
+
+		void wake_up_idle_threads(std::size_t tasks_count)
+		{
+			// Pairs with the fence in thread_main_impl before a thread is parked
+			std::atomic_thread_fence(std::memory_order_seq_cst);
+
+			if (tasks_count > 0 && m_data.idle_threads_count.load() > 0)
+			{
+				const std::lock_guard<std::mutex> lk{ m_data.access };
+				notify_idle_threads(tasks_count);
+			}
+		}
+
+		void notify_idle_threads(std::size_t tasks_count)
 		{
-			return (m_data.stop_working ? max_threads_count() : 0);
+			// Invoke under mutex: m_data.access
+
+			const std::size_t idle_threads_count{ m_data.idle_threads_count.load() };
+
+			if (tasks_count >= idle_threads_count)
+			{
+				if (idle_threads_count > 0)
+					m_data.cv.queue_changed.notify_all();
+			}
+			else
+			{
+				for (std::size_t index = 0; index < tasks_count; ++index)
+					m_data.cv.queue_changed.notify_one();
+			}
 		}
 
 		static std::size_t normalize_threads_count(std::size_t threads_count)
@@ -230,6 +340,7 @@ namespace async::pool_threads
 			const always::data_t& data{ itself->m_data };
 
 			const std::size_t thread_number{ std::get<std::size_t>(pool_ctx) + 1 };
+			const current_ctx_scope current_ctx_guard{ pool_ctx };
 
             const log_scope log_scope_guard{ itself->log(), L'[', data.pool_name, L"] [work-thread] [number: "sv, thread_number, L']' };
 
@@ -263,9 +374,33 @@ namespace async::pool_threads
 
 			const std::size_t thread_index{ std::get<std::size_t>(pool_ctx) };
 
+			details::idle_spinner spinner{ data.idle };
+
+			if constexpr (UseLockFreeQueue)
+			{
+				// The objects of threads are assigned under this mutex (see start_threads_impl)
+				const std::lock_guard<std::mutex> lk{ data.access };
+			}
+
 			for (;;)
 			{
 				task_t tsk{};
+
+				if constexpr (UseLockFreeQueue)
+				{
+					if (!data.stop_working && !data.tasks.try_take_next_task(thread_index, tsk))
+					{
+						itself->m_counters.idle(thread_index);
+
+						// The spinning thread is not idle for the producers: they do not wake up it
+						(void)spinner.spin([&data, thread_index, &tsk]
+						{
+							return (data.stop_working || data.tasks.try_take_next_task(thread_index, tsk));
+						});
+					}
+				}
+
+				if (!tsk)
 				{
 					std::unique_lock<std::mutex> un_lk{ data.access };
 
@@ -274,21 +409,34 @@ namespace async::pool_threads
 						assert(!data.stop_working);
 						assert(!data.tasks.tasks_is_exists(thread_index));
 
+						if constexpr (!UseLockFreeQueue)
+							itself->m_counters.idle(thread_index);
+
+						itself->m_counters.parked(thread_index);
+
 						change_idle_threads_count(data, +1);
 						{
+							if constexpr (UseLockFreeQueue)
+								std::atomic_thread_fence(std::memory_order_seq_cst); // Pairs with the fence in wake_up_idle_thread
+
 							data.cv.queue_changed.wait(un_lk, std::bind(always::is_continue_work_thread, std::cref(data), thread_index));
 						}
 						change_idle_threads_count(data, -1);
+
+						itself->m_counters.woken(thread_index);
 					}
 
 					if (data.stop_working)
 						break;
 
-					assert(data.tasks.tasks_is_exists(thread_index));
+					if (!data.tasks.try_take_next_task(thread_index, tsk))
+						continue; // The slot of the lock-free queue is taken by a producer, but the task is not published yet
 
-					tsk = data.tasks.take_next_task(thread_index);
+					spinner.wake_up();
 				}
 
+				const std::uint64_t start_time{ itself->m_counters.dequeued(thread_index) };
+
 				try
 				{
 					tsk(std::as_const(pool_ctx));
@@ -297,6 +445,8 @@ namespace async::pool_threads
 				{
 					log_except(itself->log(), std::current_exception(), L"Processing async task finished with error"sv);
 				}
+
+				itself->m_counters.executed(thread_index, start_time);
 			}
 		}
 
@@ -461,33 +611,25 @@ namespace async::pool_threads
 			m_data.cv.queue_changed.notify_all();
 		}
 
-		bool this_thread_of_pool(std::size_t* thread_index) const
+		bool this_thread_of_pool(std::size_t* thread_index) const noexcept
 		{
-			assert(!m_threads.storage.empty());
-
-			const std::thread::id this_thread_id{ std::this_thread::get_id() };
-
-			std::size_t thrd_index{ 0 };
-			for (const std::thread& thread : m_threads.storage)
-			{
-				if (this_thread_id == thread.get_id())
-				{
-					if (thread_index)
-						*thread_index = thrd_index;
+			const ctx_t this_thread_ctx{ current_ctx() };
 
-					return true;
-				}
+			if (this != std::get<pool*>(this_thread_ctx))
+				return false;
 
-				thrd_index += 1;
-			}
+			if (thread_index)
+				*thread_index = std::get<std::size_t>(this_thread_ctx);
 
-			return false;
+			return true;
 		}
 
 	private:
 
 		data_t m_data;
 
+		details::pool_counters m_counters;
+
 		struct
 		{
 			std::mutex access;
@@ -0,0 +1,654 @@
+#pragma once
+
+
+#include <mutex>
+#include <tuple>
+#include <chrono>
+#include <thread>
+#include <vector>
+#include <cstdint>
+#include <optional>
+#include <algorithm>
+#include <functional>
+#include <condition_variable>
+
+#include <async/pool.hpp>
+#include <async/logger.hpp>
+#include <async/promise_errc.hpp>
+#include <async/threads_bitset.hpp>
+
+
+namespace async::pool_threads
+{
+
+	/** \brief Pool with the permanent core of threads and the burst threads on demand.
+	 *
+	 * \details The first \a min_threads_count threads (core) are started with the pool and live until it is stopped,
+	 *          like the threads of \a pool_threads::always. When there are more tasks in the queue than idle threads,
+	 *          the pool starts more threads (burst) up to \a max_threads_count; a burst thread retires, when it had
+	 *          no task during \a keep_alive.
+	 *
+	 * \details A retired thread is not joined under the mutex of pool: it is joined by the next started burst thread
+	 *          (or when the pool is stopped). A burst thread is not started under the mutex either: its slot is reserved
+	 *          under the mutex and is rolled back, when the thread is failed to start.
+	 */
+	class hybrid : public async::pool
+	{
+	public:
+
+		static constexpr bool UseThreadReservationAlgorithm{ true };
+
+	private:
+
+		struct data_t
+		{
+			mutable std::mutex access;
+
+			struct
+			{
+				std::condition_variable queue_changed;
+				std::condition_variable state_threads_changed;
+
+			} cv;
+
+			std::unique_ptr<async::logger> logger;
+			std::wstring pool_name;
+
+			std::size_t min_threads_count;
+			std::size_t idle_threads_count;
+			std::size_t coming_threads_count; // Reserved, but not yet taking the tasks: they take off the queue pressure
+
+			tasks_t tasks;
+
+			details::threads_bitset stopped_threads;
+			details::threads_bitset starting_threads; // Reserved under the mutex, the objects of threads are not assigned yet (see start_thread)
+			std::vector<std::thread> retired_threads; // Finished burst threads, are joined out of the mutex
+
+			bool stop_working;
+
+			std::chrono::microseconds keep_alive;
+			std::function<void(const std::function<void()>&)> threads_wrapper;
+		};
+
+	public:
+
+		static constexpr std::size_t threads_limits_min{ 1 };
+		static constexpr std::size_t threads_limits_max{ 1024 };
+
+		static std::chrono::microseconds keep_alive_default() noexcept
+		{
+			using namespace std::chrono_literals;
+			return 30s;
+		}
+
+	public:
+
+		hybrid(std::unique_ptr<logger> logger, std::wstring pool_name, std::size_t min_threads_count, std::size_t max_threads_count, std::chrono::microseconds keep_alive, std::function<void(const std::function<void()>&)> threads_wrapper)
+			: m_data{}
+			, m_counters{ normalize_threads_count(max_threads_count) }
+			, m_threads(normalize_threads_count(max_threads_count))
+		{
+			if (logger)
+			{
+				m_data.logger = std::move(logger);
+				m_data.pool_name = (pool_name.empty() ? L"pool-threads-hybrid"s : std::move(pool_name));
+			}
+
+			m_data.stop_working = true;
+			m_data.min_threads_count = std::min(min_threads_count, m_threads.size());
+			m_data.idle_threads_count = 0;
+			m_data.coming_threads_count = 0;
+			m_data.stopped_threads = details::threads_bitset(m_threads.size(), true);
+			m_data.starting_threads = details::threads_bitset(m_threads.size(), false);
+			m_data.keep_alive = keep_alive;
+			m_data.threads_wrapper = std::move(threads_wrapper);
+			m_data.tasks.out_of_queue_by_threads.resize(m_threads.size());
+
+			resume_threads();
+		}
+
+		hybrid(std::size_t min_threads_count, std::size_t max_threads_count, std::chrono::microseconds keep_alive, std::function<void(const std::function<void()>&)> threads_wrapper)
+			: hybrid(nullptr, std::wstring{}, min_threads_count, max_threads_count, keep_alive, std::move(threads_wrapper))
+		{}
+
+		virtual ~hybrid() // noexcept(false)
+		{
+			stop_threads_and_wait_them_complete();
+		}
+
+		hybrid(hybrid&& other) = delete;
+		hybrid(const hybrid& other) = delete;
+
+		hybrid& operator=(hybrid&& other) = delete;
+		hybrid& operator=(const hybrid& other) = delete;
+
+	public:
+
+		virtual void add_task(ctx_t this_ctx, task_t task, priority_t priority = priority_t::normal) override
+		{
+			this_ctx = known_ctx(this_ctx);
+
+			std::vector<std::size_t> reserved_threads;
+			{
+				const std::lock_guard<std::mutex> lk{ m_data.access };
+
+				if (try_set_task_out_of_queue(this_ctx, task))
+					return;
+
+				m_counters.enqueued(own_thread_index(this_ctx), 1);
+				m_data.tasks.add_task_in_queue(std::move(task), priority);
+
+				if (!m_data.stop_working)
+					reserved_threads = wake_up_or_reserve_threads(1);
+			}
+
+			start_threads(reserved_threads);
+		}
+
+		virtual void add_tasks(ctx_t this_ctx, task_t* tasks, std::size_t count, priority_t priority = priority_t::normal) override
+		{
+			if (count == 0)
+				return;
+
+			this_ctx = known_ctx(this_ctx);
+
+			std::vector<std::size_t> reserved_threads;
+			{
+				const std::lock_guard<std::mutex> lk{ m_data.access };
+
+				const std::size_t first_index{ try_set_task_out_of_queue(this_ctx, tasks[0]) ? std::size_t{ 1 } : std::size_t{ 0 } };
+
+				m_counters.enqueued(own_thread_index(this_ctx), count - first_index);
+
+				for (std::size_t index = first_index; index < count; ++index)
+					m_data.tasks.add_task_in_queue(std::move(tasks[index]), priority);
+
+				if (!m_data.stop_working && count > first_index)
+					reserved_threads = wake_up_or_reserve_threads(count - first_index);
+			}
+
+			start_threads(reserved_threads);
+		}
+
+		virtual bool wait_tasks_complete() override
+		{
+			std::unique_lock<std::mutex> un_lk{ m_data.access };
+
+			return wait_tasks_complete_for_impl(std::nullopt, un_lk);
+		}
+
+		virtual bool wait_tasks_complete_for(std::chrono::microseconds wait_time) override
+		{
+			std::unique_lock<std::mutex> un_lk{ m_data.access };
+
+			if (wait_time == wait_time_zero)
+				return m_data.stop_working ? !m_data.tasks.tasks_is_exists() : is_all_running_threads_idle_and_no_tasks(m_data);
+
+			return wait_tasks_complete_for_impl(wait_time, un_lk);
+		}
+
+		virtual void resume_threads() override
+		{
+			const std::lock_guard<std::mutex> lk_threads{ m_threads_access };
+
+			std::vector<std::size_t> reserved_threads;
+			{
+				const std::lock_guard<std::mutex> lk{ m_data.access };
+
+				if (m_data.stop_working)
+				{
+					m_data.stop_working = false;
+
+					m_data.tasks.move_extra_tasks_in_begin_queue();
+
+					for (std::size_t thread_index = 0; thread_index < m_data.min_threads_count; ++thread_index)
+					{
+						if (m_data.stopped_threads.test(thread_index))
+						{
+							reserve_thread(thread_index);
+							reserved_threads.push_back(thread_index);
+						}
+					}
+
+					if (!m_data.tasks.queue_is_empty())
+					{
+						const std::vector<std::size_t> burst_threads{ wake_up_or_reserve_threads(m_data.tasks.queue_size()) };
+						reserved_threads.insert(reserved_threads.end(), burst_threads.begin(), burst_threads.end());
+					}
+				}
+			}
+
+			start_threads(reserved_threads);
+		}
+
+		virtual void stop_threads() override
+		{
+			const std::lock_guard<std::mutex> lk{ m_data.access };
+
+			if (!m_data.stop_working)
+			{
+				m_data.stop_working = true;
+				m_data.cv.queue_changed.notify_all();
+			}
+		}
+
+		virtual void stop_threads_and_wait_them_complete() override
+		{
+			const std::lock_guard<std::mutex> lk_threads{ m_threads_access };
+
+			std::vector<std::thread> threads;
+			{
+				std::unique_lock<std::mutex> un_lk{ m_data.access };
+
+				m_data.stop_working = true;
+				m_data.cv.queue_changed.notify_all();
+
+				// The threads, which are being started by add_task, are joined too
+				m_data.cv.state_threads_changed.wait(un_lk, [this] { return m_data.starting_threads.none(); });
+
+				threads.swap(m_data.retired_threads);
+
+				for (std::thread& thread : m_threads)
+				{
+					if (thread.joinable())
+						threads.push_back(std::move(thread));
+				}
+			}
+
+			join_threads(threads);
+		}
+
+		virtual std::size_t busy_threads_count() const override
+		{
+			const std::lock_guard<std::mutex> lk{ m_data.access };
+
+			assert(running_threads_count_impl(m_data) >= m_data.idle_threads_count);
+			return (running_threads_count_impl(m_data) - m_data.idle_threads_count);
+		}
+
+		virtual std::size_t max_threads_count() const override
+		{
+			return m_threads.size();
+		}
+
+		virtual pool_stats stats() const override
+		{
+			return m_counters.snapshot();
+		}
+
+	public:
+
+		virtual logger* log() const noexcept override
+		{
+			return m_data.logger.get();
+		}
+
+		virtual std::wstring_view name() const noexcept override
+		{
+			return m_data.pool_name;
+		}
+
+	public:
+
+		std::size_t min_threads_count() const noexcept
+		{
+			return m_data.min_threads_count;
+		}
+
+		std::size_t running_threads_count() const
+		{
+			const std::lock_guard<std::mutex> lk{ m_data.access };
+			return running_threads_count_impl(m_data);
+		}
+
+	private:
+
+		bool try_set_task_out_of_queue(ctx_t this_ctx, task_t& task)
+		{
+			// Invoke under mutex: m_data.access
+
+			if constexpr (UseThreadReservationAlgorithm)
+			{
+				if (!m_data.stop_working &&
+					m_threads.size() > 1 &&
+					this == std::get<pool*>(this_ctx) &&
+					m_data.tasks.queue_is_empty() &&
+					!m_data.tasks.out_of_queue_is_exists(std::get<std::size_t>(this_ctx)))
+				{
+					[[maybe_unused]] std::size_t thread_index{ static_cast<std::size_t>(-1) };
+					assert(this_thread_of_pool(&thread_index));
+					assert(thread_index == std::get<std::size_t>(this_ctx));
+
+					// The current thread takes this task next, out of the queue
+					m_counters.enqueued(std::get<std::size_t>(this_ctx), 1, true);
+					m_data.tasks.set_task_out_of_queue(std::get<std::size_t>(this_ctx), std::move(task));
+					return true;
+				}
+			}
+
+			return false;
+		}
+
+		/** \brief Wakes up the idle threads and reserves the slots of the burst threads, which are started by \a start_threads out of the mutex.
+		 */
+		[[nodiscard]] std::vector<std::size_t> wake_up_or_reserve_threads(std::size_t tasks_count)
+		{
+			// Invoke under mutex: m_data.access
+
+			assert(!m_data.stop_working);
+
+			const std::size_t idle_threads_count{ m_data.idle_threads_count };
+
+			if (tasks_count >= idle_threads_count)
+			{
+				if (idle_threads_count > 0)
+					m_data.cv.queue_changed.notify_all();
+			}
+			else
+			{
+				for (std::size_t index = 0; index < tasks_count; ++index)
+					m_data.cv.queue_changed.notify_one();
+			}
+
+			// The queue pressure: more tasks than idle threads and threads, which are coming already (reserved before), the burst threads are started
+			const std::size_t queue_size{ m_data.tasks.queue_size() };
+			const std::size_t ready_threads_count{ idle_threads_count + m_data.coming_threads_count };
+
+			std::vector<std::size_t> reserved_threads;
+
+			for (std::size_t count = (queue_size > ready_threads_count ? queue_size - ready_threads_count : 0); count > 0; --count)
+			{
+				const std::size_t thread_index{ m_data.stopped_threads.find_first() };
+
+				if (thread_index == details::threads_bitset::npos)
+					break;
+
+				reserve_thread(thread_index);
+				reserved_threads.push_back(thread_index);
+			}
+
+			return reserved_threads;
+		}
+
+		void reserve_thread(std::size_t thread_index)
+		{
+			// Invoke under mutex: m_data.access
+
+			assert(thread_index < m_threads.size());
+			assert(m_data.stopped_threads.test(thread_index));
+			assert(!m_data.starting_threads.test(thread_index));
+
+			std::thread& thread{ m_threads[thread_index] };
+
+			if (thread.joinable())
+				m_data.retired_threads.push_back(std::move(thread));
+
+			m_data.stopped_threads.reset(thread_index);
+			m_data.starting_threads.set(thread_index);
+			m_data.coming_threads_count += 1;
+		}
+
+		void start_threads(const std::vector<std::size_t>& thread_indexes)
+		{
+			// Invoke out of mutex: m_data.access
+
+			for (const std::size_t thread_index : thread_indexes)
+				start_thread(thread_index);
+		}
+
+		void start_thread(std::size_t thread_index)
+		{
+			// Invoke out of mutex: m_data.access, the slot is reserved by reserve_thread
+
+			std::thread thread;
+
+			for (std::size_t attempt = 1, attempt_count = 5; attempt <= attempt_count && !thread.joinable(); ++attempt)
+			{
+				try
+				{
+					thread = std::thread(&hybrid::thread_main, ctx_t{ this, thread_index });
+				}
+				catch (...)
+				{
+					log_except(m_data.logger.get(), std::current_exception(), L"Start the thread of pool is failed [number: "sv, (thread_index + 1), L']');
+
+					if (attempt < attempt_count)
+						std::this_thread::yield();
+				}
+			}
+
+			const std::lock_guard<std::mutex> lk{ m_data.access };
+
+			assert(m_data.starting_threads.test(thread_index));
+			m_data.starting_threads.reset(thread_index);
+
+			if (thread.joinable())
+			{
+				m_threads[thread_index] = std::move(thread);
+			}
+			else
+			{
+				// The slot is rolled back
+				m_data.stopped_threads.set(thread_index);
+				m_data.coming_threads_count -= 1;
+			}
+
+			m_data.cv.state_threads_changed.notify_all();
+		}
+
+		void join_threads(std::vector<std::thread>& threads) noexcept
+		{
+			for (std::thread& thread : threads)
+			{
+				try
+				{
+					thread.join();
+				}
+				catch (...)
+				{
+					log_except(m_data.logger.get(), std::current_exception(), L"Finish the thread of pool is failed"sv);
+				}
+			}
+
+			threads.clear();
+		}
+
+		static std::size_t normalize_threads_count(std::size_t threads_count)
+		{
+			return std::max<std::size_t>(threads_limits_min, std::min<std::size_t>(threads_count, threads_limits_max));
+		}
+
+		static void thread_main(ctx_t pool_ctx)
+		{
+			const hybrid* const itself{ static_cast<hybrid*>(std::get<pool*>(pool_ctx)) };
+			const hybrid::data_t& data{ itself->m_data };
+
+			const std::size_t thread_number{ std::get<std::size_t>(pool_ctx) + 1 };
+			const current_ctx_scope current_ctx_guard{ pool_ctx };
+
+			const log_scope log_scope_guard{ itself->log(), L'[', data.pool_name, L"] [work-thread] [number: "sv, thread_number, L']' };
+
+			assert(1 <= thread_number && thread_number <= threads_limits_max);
+
+			if (data.threads_wrapper)
+			{
+				try
+				{
+					std::optional<log_scope> log_scope_guard_opt{ std::in_place, itself->log(), L"[init-thread-wrapper]"sv };
+					data.threads_wrapper([&]
+					{
+						log_scope_guard_opt.reset();
+						thread_main_impl(pool_ctx);
+						log_scope_guard_opt.emplace(itself->log(), L"[uninit-thread-wrapper]"sv);
+					});
+				}
+				catch (...)
+				{
+					log_except(itself->log(), std::current_exception(), L"Work thread processing async task finished with error"sv);
+				}
+			}
+			else
+				thread_main_impl(pool_ctx);
+		}
+
+		static void thread_main_impl(ctx_t pool_ctx)
+		{
+			hybrid* const itself{ static_cast<hybrid*>(std::get<pool*>(pool_ctx)) };
+			hybrid::data_t& data{ itself->m_data };
+
+			const std::size_t thread_index{ std::get<std::size_t>(pool_ctx) };
+			const bool core_thread{ thread_index < data.min_threads_count };
+
+			{
+				// The object of this thread is assigned under the mutex after the start (see start_thread)
+				std::vector<std::thread> retired_threads;
+				{
+					std::unique_lock<std::mutex> un_lk{ data.access };
+
+					data.cv.state_threads_changed.wait(un_lk, [&data, thread_index] { return !data.starting_threads.test(thread_index); });
+
+					assert(data.coming_threads_count > 0);
+					data.coming_threads_count -= 1;
+
+					if (!core_thread)
+						retired_threads.swap(data.retired_threads);
+				}
+
+				itself->join_threads(retired_threads);
+			}
+
+			for (;;)
+			{
+				task_t tsk{};
+				{
+					std::unique_lock<std::mutex> un_lk{ data.access };
+
+					if (!is_continue_work_thread(data, thread_index))
+					{
+						bool waited{ true };
+
+						itself->m_counters.idle(thread_index);
+						itself->m_counters.parked(thread_index);
+
+						data.idle_threads_count += 1;
+						{
+							if (is_all_running_threads_idle_and_no_tasks(data))
+								data.cv.state_threads_changed.notify_all();
+
+							const auto is_continue{ [&data, thread_index] { return is_continue_work_thread(data, thread_index); } };
+
+							if (core_thread)
+								data.cv.queue_changed.wait(un_lk, is_continue);
+							else
+								waited = data.cv.queue_changed.wait_for(un_lk, data.keep_alive, is_continue);
+						}
+						data.idle_threads_count -= 1;
+
+						itself->m_counters.woken(thread_index);
+
+						if (!waited)
+						{
+							// The burst thread had no task during keep-alive
+
+							assert(!core_thread);
+							retire_thread(data, thread_index);
+							break;
+						}
+					}
+
+					if (data.stop_working)
+					{
+						retire_thread(data, thread_index);
+						break;
+					}
+
+					tsk = data.tasks.take_next_task(thread_index);
+				}
+
+				const std::uint64_t start_time{ itself->m_counters.dequeued(thread_index) };
+
+				try
+				{
+					tsk(std::as_const(pool_ctx));
+				}
+				catch (...)
+				{
+					log_except(itself->log(), std::current_exception(), L"Processing async task finished with error"sv);
+				}
+
+				itself->m_counters.executed(thread_index, start_time);
+			}
+		}
+
+		static void retire_thread(data_t& data, std::size_t thread_index)
+		{
+			// Invoke under mutex: data.access
+
+			data.stopped_threads.set(thread_index);
+			data.cv.state_threads_changed.notify_all();
+		}
+
+		static bool is_continue_work_thread(const data_t& data, std::size_t thread_index)
+		{
+			return (data.stop_working || data.tasks.tasks_is_exists(thread_index));
+		}
+
+		static std::size_t running_threads_count_impl(const data_t& data) noexcept
+		{
+			return (data.stopped_threads.size() - data.stopped_threads.count());
+		}
+
+		static bool is_all_running_threads_idle_and_no_tasks(const data_t& data)
+		{
+			assert(data.idle_threads_count <= running_threads_count_impl(data));
+			return (data.idle_threads_count == running_threads_count_impl(data) && !data.tasks.tasks_is_exists());
+		}
+
+		bool wait_tasks_complete_for_impl(std::optional<std::chrono::microseconds> wait_time, std::unique_lock<std::mutex>& un_lk)
+		{
+			if (m_data.stop_working)
+				return !m_data.tasks.tasks_is_exists();
+
+			if (this_thread_of_pool(nullptr))
+				throw promise_error{ promise_errc::deadlock }; // Waiting for the thread pool to finished from the thread in this pool
+
+			const auto is_complete{ [this] { return (m_data.stop_working || is_all_running_threads_idle_and_no_tasks(m_data)); } };
+
+			if (!wait_time)
+			{
+				m_data.cv.state_threads_changed.wait(un_lk, is_complete);
+			}
+			else
+			if (!m_data.cv.state_threads_changed.wait_for(un_lk, *wait_time, is_complete))
+			{
+				log_msg(m_data.logger.get(), L"Did not wait for the completion of all flows..."sv);
+				return false;
+			}
+
+			return true;
+		}
+
+		bool this_thread_of_pool(std::size_t* thread_index) const noexcept
+		{
+			const ctx_t this_thread_ctx{ current_ctx() };
+
+			if (this != std::get<pool*>(this_thread_ctx))
+				return false;
+
+			if (thread_index)
+				*thread_index = std::get<std::size_t>(this_thread_ctx);
+
+			return true;
+		}
+
+	private:
+
+		data_t m_data;
+
+		details::pool_counters m_counters;
+
+		std::mutex m_threads_access; // Serializes resume_threads and stop_threads_and_wait_them_complete
+		std::vector<std::thread> m_threads;
+	};
+
+} // namespace async::pool_threads
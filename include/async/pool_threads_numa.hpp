@@ -0,0 +1,665 @@
+#pragma once
+
+
+#include <mutex>
+#include <tuple>
+#include <atomic>
+#include <thread>
+#include <vector>
+#include <utility>
+#include <memory>
+#include <optional>
+#include <algorithm>
+#include <functional>
+#include <condition_variable>
+
+#include <async/pool.hpp>
+#include <async/logger.hpp>
+#include <async/promise_errc.hpp>
+#include <async/priority_lanes.hpp>
+#include <async/numa_topology.hpp>
+
+
+namespace async::pool_threads
+{
+
+	/** \brief Pool with a group of threads and a task queue per NUMA node.
+	 *
+	 * \details The threads are distributed over the nodes in proportion to the processors of nodes and (if there are
+	 *          several nodes) are bound to the processors of their node. The task added from a thread of this pool goes to the queue
+	 *          of node of this thread, so the continuation runs near the memory of the promise which resolved it. The tasks added from outside
+	 *          (\a pool::unknown_ctx) are distributed over the nodes in turn. A thread takes the tasks of other nodes only when the queue
+	 *          of own node is empty. On a system with one node this is a pool with one lock-free queue.
+	 */
+	class numa : public async::pool
+	{
+	private:
+
+		struct node_t
+		{
+			numa_node topology;
+
+			details::mpmc_lanes<task_t, priorities_count> queue;
+			std::condition_variable queue_changed;
+
+			std::size_t idle_threads_count; // Under mutex: data_t::access
+		};
+
+		struct worker_t
+		{
+			std::size_t node_index;
+			std::thread thread;
+		};
+
+		struct data_t
+		{
+			mutable std::mutex access;
+
+			struct
+			{
+				std::condition_variable all_tasks_complete;
+
+			} cv;
+
+			std::vector<std::unique_ptr<node_t>> nodes;
+
+			std::unique_ptr<async::logger> logger;
+			std::wstring pool_name;
+
+			std::size_t max_threads_count;
+
+			std::atomic<std::size_t> next_node_index; // For the tasks added from outside
+			std::atomic<std::size_t> idle_threads_count;
+			std::atomic<std::size_t> pending_tasks_count; // In the queues and in the processing
+
+			std::atomic<bool> stop_working;
+
+			std::function<void(const std::function<void()>&)> threads_wrapper;
+		};
+
+	public:
+
+		static constexpr std::size_t threads_limits_min{ 1 };
+		static constexpr std::size_t threads_limits_max{ static_cast<std::size_t>(~0) };
+
+	public:
+
+		numa(std::unique_ptr<logger> logger, std::wstring pool_name, std::size_t threads_count, std::vector<numa_node> topology, std::function<void(const std::function<void()>&)> threads_wrapper)
+			: m_data{}
+			, m_counters{ normalize_threads_count(threads_count) }
+			, m_threads{}
+		{
+			if (logger)
+			{
+				m_data.logger = std::move(logger);
+				m_data.pool_name = (pool_name.empty() ? L"pool-threads-numa"s : std::move(pool_name));
+			}
+
+			m_data.stop_working = true;
+			m_data.max_threads_count = normalize_threads_count(threads_count);
+			m_data.next_node_index = 0;
+			m_data.idle_threads_count = 0;
+			m_data.pending_tasks_count = 0;
+			m_data.threads_wrapper = std::move(threads_wrapper);
+
+			if (topology.empty())
+				topology = numa_topology();
+
+			const std::vector<std::size_t> node_threads_count{ distribute_threads_over_nodes(topology, m_data.max_threads_count) };
+
+			for (std::size_t node_index = 0; node_index < topology.size(); ++node_index)
+			{
+				if (node_threads_count[node_index] == 0)
+					continue; // The nodes without threads are not used
+
+				m_data.nodes.push_back(std::make_unique<node_t>());
+				m_data.nodes.back()->topology = std::move(topology[node_index]);
+				m_data.nodes.back()->idle_threads_count = 0;
+
+				for (std::size_t index = 0; index < node_threads_count[node_index]; ++index)
+				{
+					m_threads.storage.push_back(std::make_unique<worker_t>());
+					m_threads.storage.back()->node_index = m_data.nodes.size() - 1;
+				}
+			}
+
+			const std::lock_guard<std::mutex> lk_threads{ m_threads.access };
+			start_threads_impl();
+		}
+
+		numa(std::unique_ptr<logger> logger, std::wstring pool_name, std::size_t threads_count, std::function<void(const std::function<void()>&)> threads_wrapper)
+			: numa(std::move(logger), std::move(pool_name), threads_count, numa_topology(), std::move(threads_wrapper))
+		{}
+
+		numa(std::size_t threads_count, std::function<void(const std::function<void()>&)> threads_wrapper)
+			: numa(nullptr, std::wstring{}, threads_count, numa_topology(), std::move(threads_wrapper))
+		{}
+
+		virtual ~numa() // noexcept(false)
+		{
+			stop_threads_and_wait_them_complete();
+		}
+
+		numa(numa&& other) = delete;
+		numa(const numa& other) = delete;
+
+		numa& operator=(numa&& other) = delete;
+		numa& operator=(const numa& other) = delete;
+
+	public:
+
+		virtual void add_task(ctx_t this_ctx, task_t task, priority_t priority = priority_t::normal) override
+		{
+			this_ctx = known_ctx(this_ctx);
+
+			assert(task);
+
+			node_t& node{ target_node(this_ctx) };
+
+			m_counters.enqueued(own_thread_index(this_ctx), 1);
+			m_data.pending_tasks_count.fetch_add(1);
+
+			try
+			{
+				node.queue.push(std::move(task), static_cast<std::size_t>(priority));
+			}
+			catch (...)
+			{
+				m_data.pending_tasks_count.fetch_sub(1);
+				throw;
+			}
+
+			wake_up_idle_threads(node, 1);
+		}
+
+		virtual void add_tasks(ctx_t this_ctx, task_t* tasks, std::size_t count, priority_t priority = priority_t::normal) override
+		{
+			if (count == 0)
+				return;
+
+			this_ctx = known_ctx(this_ctx);
+
+			// The whole batch goes into one node: the idle threads of other nodes take it from there
+			node_t& node{ target_node(this_ctx) };
+
+			m_counters.enqueued(own_thread_index(this_ctx), count);
+
+			for (std::size_t index = 0; index < count; ++index)
+			{
+				assert(tasks[index]);
+
+				m_data.pending_tasks_count.fetch_add(1);
+
+				try
+				{
+					node.queue.push(std::move(tasks[index]), static_cast<std::size_t>(priority));
+				}
+				catch (...)
+				{
+					m_data.pending_tasks_count.fetch_sub(1);
+					wake_up_idle_threads(node, index);
+					throw;
+				}
+			}
+
+			wake_up_idle_threads(node, count);
+		}
+
+		virtual bool wait_tasks_complete() override
+		{
+			std::unique_lock<std::mutex> un_lk_data{ m_data.access };
+
+			return m_data.stop_working
+				? (m_data.pending_tasks_count == 0)
+				: wait_tasks_complete_for_impl(wait_time_infinity, un_lk_data);
+		}
+
+		virtual bool wait_tasks_complete_for(std::chrono::microseconds wait_time) override
+		{
+			std::unique_lock<std::mutex> un_lk_data{ m_data.access };
+
+			if (m_data.stop_working || wait_time == wait_time_zero)
+				return (m_data.pending_tasks_count == 0);
+
+			return wait_tasks_complete_for_impl(wait_time, un_lk_data);
+		}
+
+		virtual void resume_threads() override
+		{
+			const std::lock_guard<std::mutex> lk_threads{ m_threads.access };
+
+			if (m_data.stop_working)
+			{
+				wait_threads_complete_impl();
+				start_threads_impl();
+			}
+		}
+
+		virtual void stop_threads() override
+		{
+			std::unique_lock<std::mutex> un_lk_data{ m_data.access };
+
+			if (!m_data.stop_working)
+				stop_threads_impl();
+		}
+
+		virtual void stop_threads_and_wait_them_complete() override
+		{
+			const std::lock_guard<std::mutex> lk_threads{ m_threads.access };
+			{
+				const std::lock_guard<std::mutex> lk_data{ m_data.access };
+
+				if (!m_data.stop_working)
+					stop_threads_impl();
+			}
+			wait_threads_complete_impl();
+		}
+
+		virtual std::size_t busy_threads_count() const override
+		{
+			if (m_data.stop_working)
+				return 0;
+
+			const std::size_t idle_threads_count{ std::min<std::size_t>(m_data.idle_threads_count, max_threads_count()) };
+
+			return (max_threads_count() - idle_threads_count);
+		}
+
+		virtual std::size_t max_threads_count() const override
+		{
+			assert(m_data.max_threads_count == m_threads.storage.size());
+			return m_data.max_threads_count;
+		}
+
+		virtual pool_stats stats() const override
+		{
+			return m_counters.snapshot();
+		}
+
+	public:
+
+		virtual logger* log() const noexcept override
+		{
+			return m_data.logger.get();
+		}
+
+		virtual std::wstring_view name() const noexcept override
+		{
+			return m_data.pool_name;
+		}
+
+	public:
+
+		/** \brief Number of the nodes with the threads of pool.
+		 */
+		std::size_t nodes_count() const noexcept
+		{
+			return m_data.nodes.size();
+		}
+
+	private:
+
+		static std::size_t normalize_threads_count(std::size_t threads_count)
+		{
+			return std::max<std::size_t>(threads_limits_min, std::min<std::size_t>(threads_count, threads_limits_max));
+		}
+
+		static std::vector<std::size_t> distribute_threads_over_nodes(const std::vector<numa_node>& topology, std::size_t threads_count)
+		{
+			// Result: count of threads for every node. Every thread is given to the node with the least threads per processor,
+			// so every node gets a thread while there are enough threads.
+
+			assert(!topology.empty());
+
+			std::vector<std::size_t> node_threads_count(topology.size(), 0);
+
+			for (std::size_t thread_index = 0; thread_index < threads_count; ++thread_index)
+			{
+				std::size_t best_node_index{ 0 };
+
+				for (std::size_t node_index = 1; node_index < topology.size(); ++node_index)
+				{
+					const std::size_t node_cpus_count{ std::max<std::size_t>(1, topology[node_index].cpus.size()) };
+					const std::size_t best_cpus_count{ std::max<std::size_t>(1, topology[best_node_index].cpus.size()) };
+
+					// node_threads / node_cpus < best_threads / best_cpus
+					if (node_threads_count[node_index] * best_cpus_count < node_threads_count[best_node_index] * node_cpus_count)
+						best_node_index = node_index;
+				}
+
+				node_threads_count[best_node_index] += 1;
+			}
+
+			return node_threads_count;
+		}
+
+		static void thread_main(ctx_t pool_ctx)
+		{
+			const numa* const itself{ static_cast<numa*>(std::get<pool*>(pool_ctx)) };
+			const numa::data_t& data{ itself->m_data };
+
+			const std::size_t thread_number{ std::get<std::size_t>(pool_ctx) + 1 };
+			const current_ctx_scope current_ctx_guard{ pool_ctx };
+			const node_t& node{ *data.nodes[itself->m_threads.storage[thread_number - 1]->node_index] };
+
+			const log_scope log_scope_guard{ itself->log(), L'[', data.pool_name, L"] [work-thread] [number: "sv, thread_number, L"] [numa-node: "sv, node.topology.id, L']' };
+
+			assert(1 <= thread_number && thread_number <= threads_limits_max);
+
+			if (data.nodes.size() > 1 && !bind_this_thread_to_numa_node(node.topology))
+				log_msg(itself->log(), L"Bind the thread to the processors of NUMA node is failed"sv);
+
+			if (data.threads_wrapper)
+			{
+				try
+				{
+					std::optional<log_scope> log_scope_guard_opt(std::in_place, itself->log(), L"[init-thread-wrapper]"sv);
+					data.threads_wrapper([&]
+					{
+						log_scope_guard_opt.reset();
+						thread_main_impl(pool_ctx);
+						log_scope_guard_opt.emplace(itself->log(), L"[uninit-thread-wrapper]"sv);
+					});
+				}
+				catch (...)
+				{
+					log_except(itself->log(), std::current_exception(), L"Work thread processing async task finished with error"sv);
+				}
+			}
+			else
+				thread_main_impl(pool_ctx);
+		}
+
+		static void thread_main_impl(ctx_t pool_ctx)
+		{
+			numa* const itself{ static_cast<numa*>(std::get<pool*>(pool_ctx)) };
+			numa::data_t& data{ itself->m_data };
+
+			const std::size_t thread_index{ std::get<std::size_t>(pool_ctx) };
+			const std::size_t node_index{ itself->m_threads.storage[thread_index]->node_index };
+			node_t& node{ *data.nodes[node_index] };
+
+			{
+				// The objects of threads are assigned under this mutex (see start_threads_impl)
+				const std::lock_guard<std::mutex> lk{ data.access };
+			}
+
+			while (!data.stop_working.load())
+			{
+				task_t tsk{};
+
+				if (!itself->try_take_next_task(node_index, tsk))
+				{
+					itself->m_counters.idle(thread_index);
+
+					std::unique_lock<std::mutex> un_lk{ data.access };
+
+					itself->m_counters.parked(thread_index);
+
+					node.idle_threads_count += 1;
+					data.idle_threads_count.fetch_add(1);
+					{
+						// Pairs with the fence in wake_up_idle_threads: either the producer sees this thread idle, or this thread sees the task
+						std::atomic_thread_fence(std::memory_order_seq_cst);
+
+						node.queue_changed.wait(un_lk, [itself] { return itself->is_continue_work_thread(); });
+					}
+					data.idle_threads_count.fetch_sub(1);
+					node.idle_threads_count -= 1;
+
+					itself->m_counters.woken(thread_index);
+
+					continue;
+				}
+
+				const std::uint64_t start_time{ itself->m_counters.dequeued(thread_index) };
+
+				try
+				{
+					tsk(std::as_const(pool_ctx));
+				}
+				catch (...)
+				{
+					log_except(itself->log(), std::current_exception(), L"Processing async task finished with error"sv);
+				}
+
+				tsk.reset();
+
+				itself->m_counters.executed(thread_index, start_time);
+
+				if (data.pending_tasks_count.fetch_sub(1) == 1)
+				{
+					const std::lock_guard<std::mutex> lk{ data.access };
+					data.cv.all_tasks_complete.notify_all();
+				}
+			}
+		}
+
+		node_t& target_node(ctx_t this_ctx)
+		{
+			if (this == std::get<pool*>(this_ctx))
+			{
+				assert(std::get<std::size_t>(this_ctx) < m_threads.storage.size());
+				return *m_data.nodes[m_threads.storage[std::get<std::size_t>(this_ctx)]->node_index];
+			}
+
+			return *m_data.nodes[m_data.next_node_index.fetch_add(1, std::memory_order_relaxed) % m_data.nodes.size()];
+		}
+
+		bool try_take_next_task(std::size_t node_index, task_t& tsk)
+		{
+			// 1. Queue of own node (the priority lanes)
+			if (m_data.nodes[node_index]->queue.try_pop(tsk))
+				return true;
+
+			// 2. Queues of other nodes
+			const std::size_t nodes_count{ m_data.nodes.size() };
+			for (std::size_t offset = 1; offset < nodes_count; ++offset)
+			{
+				if (m_data.nodes[(node_index + offset) % nodes_count]->queue.try_pop(tsk))
+					return true;
+			}
+
+			return false;
+		}
+
+		bool tasks_is_exists() const noexcept
+		{
+			for (const std::unique_ptr<node_t>& node : m_data.nodes)
+			{
+				if (!node->queue.empty_approx())
+					return true;
+			}
+
+			return false;
+		}
+
+		bool is_continue_work_thread() const noexcept
+		{
+			return (m_data.stop_working.load() || tasks_is_exists());
+		}
+
+		void wake_up_idle_threads(node_t& node, std::size_t tasks_count)
+		{
+			// Pairs with the fence in thread_main_impl before a thread is parked
+			std::atomic_thread_fence(std::memory_order_seq_cst);
+
+			if (tasks_count == 0 || m_data.idle_threads_count.load() == 0)
+				return;
+
+			const std::lock_guard<std::mutex> lk{ m_data.access };
+
+			// The threads of the node of tasks first, then the threads of other nodes
+			tasks_count -= notify_idle_threads(node, tasks_count);
+
+			for (const std::unique_ptr<node_t>& other_node : m_data.nodes)
+			{
+				if (tasks_count == 0)
+					break;
+
+				if (other_node.get() != &node)
+					tasks_count -= notify_idle_threads(*other_node, tasks_count);
+			}
+		}
+
+		static std::size_t notify_idle_threads(node_t& node, std::size_t tasks_count)
+		{
+			// Invoke under mutex: m_data.access
+
+			const std::size_t notify_count{ std::min<std::size_t>(node.idle_threads_count, tasks_count) };
+
+			if (notify_count == 0)
+				return 0;
+
+			if (notify_count == node.idle_threads_count)
+			{
+				node.queue_changed.notify_all();
+			}
+			else
+			{
+				for (std::size_t index = 0; index < notify_count; ++index)
+					node.queue_changed.notify_one();
+			}
+
+			return notify_count;
+		}
+
+		void join_thread(std::thread& thread, std::size_t thread_number) noexcept
+		{
+			try
+			{
+				thread.join();
+			}
+			catch (...)
+			{
+				log_except(m_data.logger.get(), std::current_exception(), L"Finish the thread of pool is failed [number: "sv, thread_number, L']');
+			}
+		}
+
+		bool wait_tasks_complete_for_impl(std::chrono::microseconds wait_time, std::unique_lock<std::mutex>& un_lk_data)
+		{
+			assert(!m_data.stop_working);
+
+			if (this_thread_of_pool(nullptr))
+				throw promise_error{ promise_errc::deadlock }; // Waiting for the thread pool to finished from the thread in this pool
+
+			const auto all_tasks_complete = [this] { return (m_data.pending_tasks_count.load() == 0); };
+
+			if (wait_time == wait_time_infinity)
+			{
+				m_data.cv.all_tasks_complete.wait(un_lk_data, all_tasks_complete);
+			}
+			else
+			if (!m_data.cv.all_tasks_complete.wait_for(un_lk_data, wait_time, all_tasks_complete))
+			{
+				log_msg(m_data.logger.get(), L"Did not wait for the completion of all flows..."sv);
+				return false;
+			}
+
+			return true;
+		}
+
+		void wait_threads_complete_impl()
+		{
+			// Invoke under mutex: m_threads.access
+
+			assert(m_data.stop_working);
+
+			std::size_t thread_number{ 0 };
+			for (const std::unique_ptr<worker_t>& worker : m_threads.storage)
+			{
+				thread_number += 1;
+
+				if (worker->thread.joinable())
+					join_thread(worker->thread, thread_number);
+			}
+		}
+
+		void start_threads_impl()
+		{
+			// Invoke under mutex: m_threads.access
+
+			assert(m_data.stop_working);
+			m_data.stop_working = false;
+
+			try
+			{
+				const std::lock_guard<std::mutex> lk_data{ m_data.access }; // The threads do not take tasks until all of them are assigned
+
+				std::size_t thread_number{ 0 };
+				for (const std::unique_ptr<worker_t>& worker : m_threads.storage)
+				{
+					thread_number += 1;
+
+					assert(!worker->thread.joinable());
+
+					for (std::size_t attempt = 1, max_attempt_count = 5; attempt <= max_attempt_count; ++attempt)
+					{
+						try
+						{
+							worker->thread = std::thread(&numa::thread_main, ctx_t{ this, thread_number - 1 });
+							break;
+						}
+						catch (...)
+						{
+							log_except(m_data.logger.get(), std::current_exception(), L"Start the thread of pool is failed [number: "sv, thread_number, L']');
+
+							if (attempt >= max_attempt_count)
+								throw;
+
+							std::this_thread::yield();
+						}
+					}
+				}
+			}
+			catch (...)
+			{
+				{
+					const std::lock_guard<std::mutex> lk_data{ m_data.access };
+					stop_threads_impl();
+				}
+				wait_threads_complete_impl();
+				throw;
+			}
+		}
+
+		void stop_threads_impl()
+		{
+			// Invoke under mutex: m_data.access
+
+			m_data.stop_working = true;
+
+			for (const std::unique_ptr<node_t>& node : m_data.nodes)
+				node->queue_changed.notify_all();
+		}
+
+		bool this_thread_of_pool(std::size_t* thread_index) const noexcept
+		{
+			const ctx_t this_thread_ctx{ current_ctx() };
+
+			if (this != std::get<pool*>(this_thread_ctx))
+				return false;
+
+			if (thread_index)
+				*thread_index = std::get<std::size_t>(this_thread_ctx);
+
+			return true;
+		}
+
+	private:
+
+		data_t m_data;
+
+		details::pool_counters m_counters;
+
+		struct
+		{
+			std::mutex access;
+			std::vector<std::unique_ptr<worker_t>> storage;
+
+		} m_threads;
+
+		static constexpr std::chrono::microseconds wait_time_infinity{ std::chrono::microseconds::zero() };
+	};
+
+} // namespace async::pool_threads
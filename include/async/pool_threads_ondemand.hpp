@@ -12,9 +12,10 @@
 #include <functional>
 #include <condition_variable>
 
-#include <async\pool.hpp>
-#include <async\logger.hpp>
-#include <async\promise_errc.hpp>
+#include <async/pool.hpp>
+#include <async/logger.hpp>
+#include <async/promise_errc.hpp>
+#include <async/threads_bitset.hpp>
 
 
 namespace async::pool_threads
@@ -27,8 +28,6 @@ namespace async::pool_threads
 
     private:
 
-        using threads_mask_t = std::uint32_t;
-
         struct data_t
         {
             mutable std::mutex access;
@@ -40,14 +39,14 @@ namespace async::pool_threads
 
             } cv;
 
-            std::unique_ptr<logger> logger;
+            std::unique_ptr<async::logger> logger;
             std::wstring pool_name;
 
             std::size_t idle_threads_count;
 
             tasks_t tasks;
 
-            threads_mask_t mask_stopped;
+            details::threads_bitset stopped_threads;
 
             bool stop_working;
             bool wake_up_sleep_threads;
@@ -59,7 +58,7 @@ namespace async::pool_threads
     public:
 
         static const std::size_t threads_limits_min{ 1 };
-        static const std::size_t threads_limits_max{ 8 * sizeof(threads_mask_t) };
+        static const std::size_t threads_limits_max{ 1024 };
 
         static std::chrono::microseconds waiting_time_new_tasks_default() noexcept
         {
@@ -69,14 +68,11 @@ namespace async::pool_threads
 
         static constexpr std::chrono::microseconds waiting_time_new_tasks__none{ std::chrono::microseconds::zero() };
 
-    private:
-
-        static const threads_mask_t mask_all_threads_of_stopped{ static_cast<threads_mask_t>(~0) };
-
     public:
 
         ondemand(std::unique_ptr<logger> logger, std::wstring pool_name, std::size_t threads_count, std::chrono::microseconds waiting_time_new_tasks, std::function<void(const std::function<void()>&)> threads_wrapper)
             : m_data{}
+            , m_counters{ normalize_threads_count(threads_count) }
             , m_threads(normalize_threads_count(threads_count))
         {
             if (logger)
@@ -87,7 +83,7 @@ namespace async::pool_threads
 
             m_data.stop_working = false;
             m_data.idle_threads_count = 0;
-            m_data.mask_stopped = mask_all_threads_of_stopped;
+            m_data.stopped_threads = details::threads_bitset(m_threads.size(), true);
             m_data.wake_up_sleep_threads = false;
             m_data.waiting_time_new_tasks = std::move(waiting_time_new_tasks);
             m_data.threads_wrapper = std::move(threads_wrapper);
@@ -111,34 +107,40 @@ namespace async::pool_threads
 
 	public:
 
-		virtual void add_task(ctx_t this_ctx, task_t task) override
+		virtual void add_task(ctx_t this_ctx, task_t task, priority_t priority = priority_t::normal) override
 		{
+			this_ctx = known_ctx(this_ctx);
+
 			const std::lock_guard<std::mutex> lk{ m_data.access };
 
-			if (m_data.stop_working)
-			{
-				m_data.tasks.add_task_in_queue(std::move(task));
+			if (try_set_task_out_of_queue(this_ctx, task))
 				return;
-			}
 
-			if constexpr (UseThreadReservationAlgorithm)
-			{
-				if (m_threads.size() > 1 &&                                   //        
-					this == std::get<pool*>(this_ctx) &&                      //         
-					m_data.tasks.queue_size() <= stopped_threads_count())     //     ( )    
-				{
-					[[maybe_unused]] std::size_t thread_index{ static_cast<std::size_t>(-1) };
-					assert(this_thread_of_pool(&thread_index));
-					assert(thread_index == std::get<std::size_t>(this_ctx));
+			m_counters.enqueued(own_thread_index(this_ctx), 1);
+			m_data.tasks.add_task_in_queue(std::move(task), priority);
 
-					// ...          
-					m_data.tasks.set_task_out_of_queue(std::get<std::size_t>(this_ctx), std::move(task));
-					return;
-				}
-			}
+			if (!m_data.stop_working)
+				resume_threads_impl(1);
+		}
+
+		virtual void add_tasks(ctx_t this_ctx, task_t* tasks, std::size_t count, priority_t priority = priority_t::normal) override
+		{
+			if (count == 0)
+				return;
+
+			this_ctx = known_ctx(this_ctx);
+
+			const std::lock_guard<std::mutex> lk{ m_data.access };
+
+			const std::size_t first_index{ try_set_task_out_of_queue(this_ctx, tasks[0]) ? std::size_t{ 1 } : std::size_t{ 0 } };
 
-			m_data.tasks.add_task_in_queue(std::move(task));
-			resume_threads_impl(1);
+			m_counters.enqueued(own_thread_index(this_ctx), count - first_index);
+
+			for (std::size_t index = first_index; index < count; ++index)
+				m_data.tasks.add_task_in_queue(std::move(tasks[index]), priority);
+
+			if (!m_data.stop_working && count > first_index)
+				resume_threads_impl(count - first_index);
 		}
 
 		virtual void resume_threads() override
@@ -191,22 +193,15 @@ namespace async::pool_threads
 
 		virtual std::size_t busy_threads_count() const override
 		{
-			threads_mask_t mask_running{ 0 };
+			std::size_t running_threads_count{ 0 };
 			std::size_t idle_threads_count{ 0 };
 			{
 				const std::lock_guard<std::mutex> lk{ m_data.access };
 
-				mask_running = static_cast<threads_mask_t>(~m_data.mask_stopped);
+				running_threads_count = running_threads_count_impl(m_data);
 				idle_threads_count = m_data.idle_threads_count;
 			}
 
-			std::size_t running_threads_count{ 0 };
-			for (; mask_running != 0; mask_running >>= 1)
-			{
-				if ((mask_running & 1) != 0)
-					running_threads_count += 1;
-			}
-
 			assert(running_threads_count >= idle_threads_count);
 			return (running_threads_count - idle_threads_count);
 		}
@@ -216,38 +211,70 @@ namespace async::pool_threads
 			return m_threads.size();
 		}
 
-	private:
+		virtual pool_stats stats() const override
+		{
+			return m_counters.snapshot();
+		}
 
-		std::size_t stopped_threads_count() const noexcept
+		virtual logger* log() const noexcept override
 		{
-			assert(threads_limits_min <= m_threads.size() && m_threads.size() <= threads_limits_max);
+			return m_data.logger.get();
+		}
 
-			const threads_mask_t mask_all_stopped{ static_cast<threads_mask_t>(m_threads.size() < threads_limits_max ? ((1 << m_threads.size())-1) : ~0) };
+		virtual std::wstring_view name() const noexcept override
+		{
+			return m_data.pool_name;
+		}
 
-			threads_mask_t mask{ m_data.mask_stopped & mask_all_stopped };
+	private:
 
-			std::size_t result{ 0 };
+		bool try_set_task_out_of_queue(ctx_t this_ctx, task_t& task)
+		{
+			// Invoke under mutex: m_data.access
 
-			for (; mask != 0; mask >>= 1)
+			if constexpr (UseThreadReservationAlgorithm)
 			{
-				if ((mask & 1) != 0)
-					result += 1;
+				if (!m_data.stop_working &&
+					m_threads.size() > 1 &&                                                 //        
+					this == std::get<pool*>(this_ctx) &&                                    //         
+					m_data.tasks.queue_size() <= stopped_threads_count() &&                 //     ( )    
+					!m_data.tasks.out_of_queue_is_exists(std::get<std::size_t>(this_ctx)))   //         
+				{
+					[[maybe_unused]] std::size_t thread_index{ static_cast<std::size_t>(-1) };
+					assert(this_thread_of_pool(&thread_index));
+					assert(thread_index == std::get<std::size_t>(this_ctx));
+
+					// ...          
+					m_counters.enqueued(std::get<std::size_t>(this_ctx), 1, true);
+					m_data.tasks.set_task_out_of_queue(std::get<std::size_t>(this_ctx), std::move(task));
+					return true;
+				}
 			}
 
-			return result;
+			return false;
 		}
 
-		static std::wstring mask_to_wstring(threads_mask_t threads_mask, std::size_t threads_count, wchar_t bit_set, wchar_t bit_notset)
+		std::size_t stopped_threads_count() const noexcept
 		{
-			std::wstring result(threads_count, bit_notset);
+			assert(threads_limits_min <= m_threads.size() && m_threads.size() <= threads_limits_max);
+			assert(m_data.stopped_threads.size() == m_threads.size());
 
-			std::size_t char_index{ 0 };
-			threads_mask_t index_by_mask{ static_cast<threads_mask_t>(1 << (threads_count - 1)) };
-			for (; char_index < threads_count; char_index += 1, index_by_mask >>= 1)
-			{
-				if ((threads_mask & index_by_mask) != 0)
-					result[char_index] = bit_set;
-			}
+			return m_data.stopped_threads.count();
+		}
+
+		static std::size_t running_threads_count_impl(const data_t& data) noexcept
+		{
+			return (data.stopped_threads.size() - data.stopped_threads.count());
+		}
+
+		static std::wstring threads_to_wstring(const details::threads_bitset& threads, wchar_t bit_set, wchar_t bit_notset)
+		{
+			// The last thread is the first char (as the bits of number)
+
+			std::wstring result(threads.size(), bit_notset);
+
+			for (std::size_t thread_index = threads.find_first(); thread_index != details::threads_bitset::npos; thread_index = threads.find_next(thread_index))
+				result[threads.size() - 1 - thread_index] = bit_set;
 
 			return result;
 		}
@@ -265,6 +292,7 @@ namespace async::pool_threads
 			const ondemand::data_t& data{ itself->m_data };
 
 			const std::size_t thread_number{ std::get<std::size_t>(pool_ctx) + 1 };
+			const current_ctx_scope current_ctx_guard{ pool_ctx };
 
             const log_scope log_scope_guard{ data.logger.get(), L'[', data.pool_name, L"] [work-thread] [number: "sv, thread_number, L']' };
 
@@ -320,6 +348,9 @@ namespace async::pool_threads
 						assert(!data.stop_working);
 						assert(!data.tasks.tasks_is_exists(thread_index));
 
+						itself->m_counters.idle(thread_index);
+						itself->m_counters.parked(thread_index);
+
 						data.idle_threads_count += 1;
 						{
 							if (is_all_running_threads_idle(data))
@@ -328,6 +359,8 @@ namespace async::pool_threads
 							waited = data.cv.queue_changed.wait_for(un_lk, data.waiting_time_new_tasks, [&] { return data.wake_up_sleep_threads || is_continue_work_thread(data, thread_index); });
 						}
 						data.idle_threads_count -= 1;
+
+						itself->m_counters.woken(thread_index);
 					}
 
 					bool stopped_work_thread{ false };
@@ -358,7 +391,7 @@ namespace async::pool_threads
 
 					if (stopped_work_thread)
 					{
-						data.mask_stopped |= (1 << thread_index);
+						data.stopped_threads.set(thread_index);
 
 						if (is_all_threads_stopped(data))
 							data.cv.state_threads_changed.notify_all();
@@ -367,6 +400,8 @@ namespace async::pool_threads
 					}
 				}
 
+				const std::uint64_t start_time{ itself->m_counters.dequeued(thread_index) };
+
 				try
 				{
 					tsk(std::as_const(pool_ctx));
@@ -375,6 +410,8 @@ namespace async::pool_threads
 				{
                     log_except(data.logger.get(), std::current_exception(), L"Processing async task finished with error"sv);
 				}
+
+				itself->m_counters.executed(thread_index, start_time);
 			}
 		}
 
@@ -385,30 +422,15 @@ namespace async::pool_threads
 
 		static bool is_all_threads_stopped(const data_t& data)
 		{
-			return (data.mask_stopped == mask_all_threads_of_stopped);
+			return data.stopped_threads.all();
 		}
 
 		static bool is_all_running_threads_idle(const data_t& data)
 		{
-			std::size_t idle_threads_count{ data.idle_threads_count };
+			const std::size_t running_threads_count{ running_threads_count_impl(data) };
 
-			for (threads_mask_t mask_running{ static_cast<threads_mask_t>(~data.mask_stopped) }; mask_running != 0; mask_running >>= 1)
-			{
-				if ((mask_running & 1) == 0)
-					continue;
-
-				if (idle_threads_count == 0)
-					return false;
-
-				idle_threads_count -= 1;
-			}
-
-			if (idle_threads_count != 0)
-			{
-				assert(idle_threads_count == 0);
-			}
-
-			return true;
+			assert(data.idle_threads_count <= running_threads_count);
+			return (data.idle_threads_count >= running_threads_count);
 		}
 
 		void join_thread(std::thread& thread, std::size_t thread_number) noexcept
@@ -481,90 +503,63 @@ namespace async::pool_threads
 
 			if (tasks_count > 0)
 			{
-				const std::size_t thread_count{ m_threads.size() };
-
 				for (std::size_t index = std::min<std::size_t>(stopped_threads_count(), tasks_count); index > 0; --index)
 				{
-					std::size_t thread_index{ 0 };
-					threads_mask_t index_by_mask{ 1 };
-					for (; thread_index < thread_count; thread_index += 1, index_by_mask <<= 1)
-					{
-						if ((m_data.mask_stopped & index_by_mask) == 0)
-							continue;
+					const std::size_t thread_index{ m_data.stopped_threads.find_first() };
+					assert(thread_index < m_threads.size());
 
-						auto&[thread_access, thread] = m_threads[thread_index];
-						const std::lock_guard<std::mutex> lk{ thread_access };
+					auto&[thread_access, thread] = m_threads[thread_index];
+					const std::lock_guard<std::mutex> lk{ thread_access };
 
-						if (thread.joinable())
-							join_thread(thread, thread_index + 1);
+					if (thread.joinable())
+						join_thread(thread, thread_index + 1);
 
-						for (std::size_t attempt = 1, attempt_count = 5; attempt <= attempt_count; ++attempt)
+					for (std::size_t attempt = 1, attempt_count = 5; attempt <= attempt_count; ++attempt)
+					{
+						try
 						{
-							try
-							{
-								//m_data.idle_threads_count += 1;
-								m_data.mask_stopped &= ~index_by_mask;
-								thread = std::thread(&ondemand::thread_main, ctx_t{ this, thread_index });
-								break;
-							}
-							catch (...)
-							{
-								//m_data.idle_threads_count -= 1;
-								m_data.mask_stopped |= index_by_mask;
-
-                                log_except(m_data.logger.get(), std::current_exception(), L"Start the thread of pool is failed [number: "sv, (thread_index + 1), L"] [mask-running: "sv, mask_to_wstring(static_cast<threads_mask_t>(~m_data.mask_stopped), thread_count, L'+', L'-'), L']');
-
-                                if (attempt < attempt_count)
-									std::this_thread::yield();
-							}
+							//m_data.idle_threads_count += 1;
+							m_data.stopped_threads.reset(thread_index);
+							thread = std::thread(&ondemand::thread_main, ctx_t{ this, thread_index });
+							break;
+						}
+						catch (...)
+						{
+							//m_data.idle_threads_count -= 1;
+							m_data.stopped_threads.set(thread_index);
+
+                            log_except(m_data.logger.get(), std::current_exception(), L"Start the thread of pool is failed [number: "sv, (thread_index + 1), L"] [mask-running: "sv, threads_to_wstring(m_data.stopped_threads, L'-', L'+'), L']');
+
+                            if (attempt < attempt_count)
+								std::this_thread::yield();
 						}
-						break;
 					}
 
-					assert(thread_index < thread_count);
+					if (m_data.stopped_threads.test(thread_index))
+						break; // The thread is not started, the next attempts are useless
 				}
 			}
 		}
 
-		bool this_thread_of_pool(std::size_t* thread_index) const
+		bool this_thread_of_pool(std::size_t* thread_index) const noexcept
 		{
-			assert(!m_threads.empty());
-
-			threads_mask_t mask_running{ static_cast<threads_mask_t>(~m_data.mask_stopped) };
-			if (0 != mask_running)
-			{
-				const std::thread::id this_thread_id{ std::this_thread::get_id() };
-
-				std::size_t thrd_index{ 0 };
-				threads_mask_t index_by_mask{ 1 };
-				for (;; thrd_index += 1, index_by_mask <<= 1)
-				{
-					assert(thrd_index < m_threads.size());
+			const ctx_t this_thread_ctx{ current_ctx() };
 
-					if ((mask_running & index_by_mask) != 0)
-					{
-						auto&[thread_access, thread] = m_threads[thrd_index];
-						if (this_thread_id == thread.get_id())
-						{
-							if (thread_index)
-								*thread_index = thrd_index;
+			if (this != std::get<pool*>(this_thread_ctx))
+				return false;
 
-							return true;
-						}
+			if (thread_index)
+				*thread_index = std::get<std::size_t>(this_thread_ctx);
 
-						if (0 == (mask_running &= ~index_by_mask))
-							break;
-					}
-				}
-			}
-
-			return false;
+			return true;
 		}
 
 	private:
 
 		data_t m_data;
 
+		details::pool_counters m_counters;
+
 		std::vector<std::pair<std::mutex, std::thread>> m_threads;
 	};
 
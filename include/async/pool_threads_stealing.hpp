@@ -0,0 +1,698 @@
+#pragma once
+
+
+#include <array>
+#include <mutex>
+#include <deque>
+#include <tuple>
+#include <atomic>
+#include <thread>
+#include <vector>
+#include <utility>
+#include <memory>
+#include <cstdint>
+#include <optional>
+#include <algorithm>
+#include <functional>
+#include <condition_variable>
+
+#include <async/pool.hpp>
+#include <async/logger.hpp>
+#include <async/promise_errc.hpp>
+#include <async/priority_lanes.hpp>
+#include <async/work_stealing_deque.hpp>
+
+
+namespace async::pool_threads
+{
+
+	/** \brief Pool with a work-stealing deque per thread.
+	 *
+	 * \details The task added from a thread of this pool is pushed into the own deque of the thread (LIFO for the owner),
+	 *          the idle threads steal from the other end of the deques (FIFO). The tasks added from outside
+	 *          (\a pool::unknown_ctx) go to the global lock-free injection queue. The mutex is used only to park and wake up threads.
+	 *
+	 * \details The deques hold only the tasks of \a priority_t::normal. The critical and background tasks always go to
+	 *          the lanes of the injection queue: a thread takes the critical lane before its own deque.
+	 */
+	class stealing : public async::pool
+	{
+	private:
+
+		using task_ptr_t = task_t*;
+
+		struct worker_t
+		{
+			worker_t()
+			{
+				free_tasks.reserve(free_tasks_max);
+			}
+
+			details::work_stealing_deque<task_ptr_t> deque;
+			std::thread thread;
+
+			std::vector<task_ptr_t> free_tasks; // The empty nodes of the tasks, executed by this thread: only this thread takes them for its add_task
+		};
+
+		static constexpr std::size_t free_tasks_max{ 256 };
+
+		struct data_t
+		{
+			mutable std::mutex access;
+
+			struct
+			{
+				std::condition_variable queue_changed;
+				std::condition_variable all_tasks_complete;
+
+			} cv;
+
+			details::mpmc_lanes<task_ptr_t, priorities_count> injection;
+
+			std::unique_ptr<async::logger> logger;
+			std::wstring pool_name;
+
+			std::size_t max_threads_count;
+
+			std::atomic<std::size_t> idle_threads_count;
+			std::atomic<std::size_t> pending_tasks_count; // In the queues and in the processing
+
+			std::atomic<bool> stop_working;
+
+			std::function<void(const std::function<void()>&)> threads_wrapper;
+		};
+
+	public:
+
+		static constexpr std::size_t threads_limits_min{ 1 };
+		static constexpr std::size_t threads_limits_max{ static_cast<std::size_t>(~0) };
+
+	public:
+
+		stealing(std::unique_ptr<logger> logger, std::wstring pool_name, std::size_t threads_count, std::function<void(const std::function<void()>&)> threads_wrapper)
+			: m_data{}
+			, m_counters{ normalize_threads_count(threads_count) }
+			, m_threads{}
+		{
+			if (logger)
+			{
+				m_data.logger = std::move(logger);
+				m_data.pool_name = (pool_name.empty() ? L"pool-threads-stealing"s : std::move(pool_name));
+			}
+
+			m_data.stop_working = true;
+			m_data.max_threads_count = normalize_threads_count(threads_count);
+			m_data.idle_threads_count = 0;
+			m_data.pending_tasks_count = 0;
+			m_data.threads_wrapper = std::move(threads_wrapper);
+
+			m_threads.storage.reserve(m_data.max_threads_count);
+			for (std::size_t index = 0; index < m_data.max_threads_count; ++index)
+				m_threads.storage.push_back(std::make_unique<worker_t>());
+
+			const std::lock_guard<std::mutex> lk_threads{ m_threads.access };
+			start_threads_impl();
+		}
+
+		stealing(std::size_t threads_count, std::function<void(const std::function<void()>&)> threads_wrapper)
+			: stealing(nullptr, std::wstring{}, threads_count, std::move(threads_wrapper))
+		{}
+
+		virtual ~stealing() // noexcept(false)
+		{
+			stop_threads_and_wait_them_complete();
+
+			task_ptr_t tsk{ nullptr };
+
+			for (const std::unique_ptr<worker_t>& worker : m_threads.storage)
+			{
+				while (worker->deque.pop(tsk))
+					delete tsk;
+			}
+
+			while (m_data.injection.try_pop(tsk))
+				delete tsk;
+
+			for (const std::unique_ptr<worker_t>& worker : m_threads.storage)
+			{
+				for (task_ptr_t free_tsk : worker->free_tasks)
+					delete free_tsk;
+			}
+		}
+
+		stealing(stealing&& other) = delete;
+		stealing(const stealing& other) = delete;
+
+		stealing& operator=(stealing&& other) = delete;
+		stealing& operator=(const stealing& other) = delete;
+
+	public:
+
+		virtual void add_task(ctx_t this_ctx, task_t task, priority_t priority = priority_t::normal) override
+		{
+			this_ctx = known_ctx(this_ctx);
+
+			assert(task);
+
+			std::unique_ptr<task_t> tsk{ make_task_node(this_thread_worker(), std::move(task)) };
+
+			m_counters.enqueued(own_thread_index(this_ctx), 1);
+			m_data.pending_tasks_count.fetch_add(1);
+
+			if (priority == priority_t::normal && !m_data.stop_working.load() && this == std::get<pool*>(this_ctx))
+			{
+				[[maybe_unused]] std::size_t thread_index{ static_cast<std::size_t>(-1) };
+				assert(this_thread_of_pool(&thread_index));
+				assert(thread_index == std::get<std::size_t>(this_ctx));
+
+				m_threads.storage[std::get<std::size_t>(this_ctx)]->deque.push(tsk.get());
+			}
+			else
+			{
+				m_data.injection.push(tsk.get(), static_cast<std::size_t>(priority));
+			}
+
+			tsk.release();
+
+			wake_up_idle_thread();
+		}
+
+		virtual void add_tasks(ctx_t this_ctx, task_t* tasks, std::size_t count, priority_t priority = priority_t::normal) override
+		{
+			if (count == 0)
+				return;
+
+			this_ctx = known_ctx(this_ctx);
+
+			worker_t* const this_worker{ this_thread_worker() };
+			worker_t* deque_worker{ nullptr };
+
+			if (priority == priority_t::normal && !m_data.stop_working.load() && this == std::get<pool*>(this_ctx))
+			{
+				[[maybe_unused]] std::size_t thread_index{ static_cast<std::size_t>(-1) };
+				assert(this_thread_of_pool(&thread_index));
+				assert(thread_index == std::get<std::size_t>(this_ctx));
+
+				// The whole batch goes into the own deque: the idle threads steal it from there
+				deque_worker = this_worker;
+			}
+
+			m_counters.enqueued(own_thread_index(this_ctx), count);
+
+			for (std::size_t index = 0; index < count; ++index)
+			{
+				assert(tasks[index]);
+
+				std::unique_ptr<task_t> tsk{ make_task_node(this_worker, std::move(tasks[index])) };
+
+				m_data.pending_tasks_count.fetch_add(1);
+
+				if (deque_worker)
+					deque_worker->deque.push(tsk.get());
+				else
+					m_data.injection.push(tsk.get(), static_cast<std::size_t>(priority));
+
+				tsk.release();
+			}
+
+			wake_up_idle_threads(count);
+		}
+
+		virtual bool wait_tasks_complete() override
+		{
+			std::unique_lock<std::mutex> un_lk_data{ m_data.access };
+
+			return m_data.stop_working
+				? (m_data.pending_tasks_count == 0)
+				: wait_tasks_complete_for_impl(wait_time_infinity, un_lk_data);
+		}
+
+		virtual bool wait_tasks_complete_for(std::chrono::microseconds wait_time) override
+		{
+			std::unique_lock<std::mutex> un_lk_data{ m_data.access };
+
+			if (m_data.stop_working || wait_time == wait_time_zero)
+				return (m_data.pending_tasks_count == 0);
+
+			return wait_tasks_complete_for_impl(wait_time, un_lk_data);
+		}
+
+		virtual void resume_threads() override
+		{
+			const std::lock_guard<std::mutex> lk_threads{ m_threads.access };
+
+			if (m_data.stop_working)
+			{
+				wait_threads_complete_impl();
+				move_extra_tasks_in_begin_injection_queue();
+
+				start_threads_impl();
+			}
+		}
+
+		virtual void stop_threads() override
+		{
+			std::unique_lock<std::mutex> un_lk_data{ m_data.access };
+
+			if (!m_data.stop_working)
+				stop_threads_impl();
+		}
+
+		virtual void stop_threads_and_wait_them_complete() override
+		{
+			const std::lock_guard<std::mutex> lk_threads{ m_threads.access };
+			{
+				const std::lock_guard<std::mutex> lk_data{ m_data.access };
+
+				if (!m_data.stop_working)
+					stop_threads_impl();
+			}
+			wait_threads_complete_impl();
+		}
+
+		virtual std::size_t busy_threads_count() const override
+		{
+			if (m_data.stop_working)
+				return 0;
+
+			const std::size_t idle_threads_count{ std::min<std::size_t>(m_data.idle_threads_count, max_threads_count()) };
+
+			return (max_threads_count() - idle_threads_count);
+		}
+
+		virtual std::size_t max_threads_count() const override
+		{
+			assert(m_data.max_threads_count == m_threads.storage.size());
+			return m_data.max_threads_count;
+		}
+
+		virtual pool_stats stats() const override
+		{
+			return m_counters.snapshot();
+		}
+
+	public:
+
+		virtual logger* log() const noexcept override
+		{
+			return m_data.logger.get();
+		}
+
+		virtual std::wstring_view name() const noexcept override
+		{
+			return m_data.pool_name;
+		}
+
+	private:
+
+		static std::size_t normalize_threads_count(std::size_t threads_count)
+		{
+			return std::max<std::size_t>(threads_limits_min, std::min<std::size_t>(threads_count, threads_limits_max));
+		}
+
+		static void thread_main(ctx_t pool_ctx)
+		{
+			const stealing* const itself{ static_cast<stealing*>(std::get<pool*>(pool_ctx)) };
+			const stealing::data_t& data{ itself->m_data };
+
+			const std::size_t thread_number{ std::get<std::size_t>(pool_ctx) + 1 };
+			const current_ctx_scope current_ctx_guard{ pool_ctx };
+
+			const log_scope log_scope_guard{ itself->log(), L'[', data.pool_name, L"] [work-thread] [number: "sv, thread_number, L']' };
+
+			assert(1 <= thread_number && thread_number <= threads_limits_max);
+
+			if (data.threads_wrapper)
+			{
+				try
+				{
+					std::optional<log_scope> log_scope_guard_opt(std::in_place, itself->log(), L"[init-thread-wrapper]"sv);
+					data.threads_wrapper([&]
+					{
+						log_scope_guard_opt.reset();
+						thread_main_impl(pool_ctx);
+						log_scope_guard_opt.emplace(itself->log(), L"[uninit-thread-wrapper]"sv);
+					});
+				}
+				catch (...)
+				{
+					log_except(itself->log(), std::current_exception(), L"Work thread processing async task finished with error"sv);
+				}
+			}
+			else
+				thread_main_impl(pool_ctx);
+		}
+
+		static void thread_main_impl(ctx_t pool_ctx)
+		{
+			stealing* const itself{ static_cast<stealing*>(std::get<pool*>(pool_ctx)) };
+			stealing::data_t& data{ itself->m_data };
+
+			const std::size_t thread_index{ std::get<std::size_t>(pool_ctx) };
+
+			{
+				// The objects of threads are assigned under this mutex (see start_threads_impl)
+				const std::lock_guard<std::mutex> lk{ data.access };
+			}
+
+			while (!data.stop_working.load())
+			{
+				task_ptr_t tsk{ itself->take_next_task(thread_index) };
+
+				if (!tsk)
+				{
+					itself->m_counters.idle(thread_index);
+
+					std::unique_lock<std::mutex> un_lk{ data.access };
+
+					itself->m_counters.parked(thread_index);
+
+					data.idle_threads_count.fetch_add(1);
+					{
+						// Pairs with the fence in wake_up_idle_thread: either the producer sees this thread idle, or this thread sees the task
+						std::atomic_thread_fence(std::memory_order_seq_cst);
+
+						data.cv.queue_changed.wait(un_lk, [itself] { return itself->is_continue_work_thread(); });
+					}
+					data.idle_threads_count.fetch_sub(1);
+
+					itself->m_counters.woken(thread_index);
+
+					continue;
+				}
+
+				const std::uint64_t start_time{ itself->m_counters.dequeued(thread_index) };
+
+				try
+				{
+					(*tsk)(std::as_const(pool_ctx));
+				}
+				catch (...)
+				{
+					log_except(itself->log(), std::current_exception(), L"Processing async task finished with error"sv);
+				}
+
+				free_task_node(*itself->m_threads.storage[thread_index], tsk);
+
+				itself->m_counters.executed(thread_index, start_time);
+
+				if (data.pending_tasks_count.fetch_sub(1) == 1)
+				{
+					const std::lock_guard<std::mutex> lk{ data.access };
+					data.cv.all_tasks_complete.notify_all();
+				}
+			}
+		}
+
+		worker_t* this_thread_worker() const noexcept
+		{
+			// The worker of the current thread (not of the passed context), if it is a thread of this pool
+
+			const ctx_t thread_ctx{ current_ctx() };
+
+			if (this != std::get<pool*>(thread_ctx))
+				return nullptr;
+
+			assert(std::get<std::size_t>(thread_ctx) < m_threads.storage.size());
+			return m_threads.storage[std::get<std::size_t>(thread_ctx)].get();
+		}
+
+		static task_ptr_t make_task_node(worker_t* own_worker, task_t&& task)
+		{
+			// The node of the executed task is reused by the thread, which has executed it: no allocation per task in the steady state
+
+			if (own_worker && !own_worker->free_tasks.empty())
+			{
+				const task_ptr_t tsk{ own_worker->free_tasks.back() };
+				own_worker->free_tasks.pop_back();
+
+				*tsk = std::move(task);
+				return tsk;
+			}
+
+			return new task_t{ std::move(task) };
+		}
+
+		static void free_task_node(worker_t& own_worker, task_ptr_t tsk) noexcept
+		{
+			*tsk = nullptr; // The closure is destroyed now, not at the reuse
+
+			if (own_worker.free_tasks.size() < free_tasks_max)
+				own_worker.free_tasks.push_back(tsk); // Without the allocation: the capacity is reserved
+			else
+				delete tsk;
+		}
+
+		task_ptr_t take_next_task(std::size_t thread_index)
+		{
+			task_ptr_t tsk{ nullptr };
+
+			// 1. Critical lane of the injection queue
+			if (m_data.injection.try_pop(tsk, static_cast<std::size_t>(priority_t::critical)))
+				return tsk;
+
+			// 2. Own deque, the newest task (LIFO)
+			if (m_threads.storage[thread_index]->deque.pop(tsk))
+				return tsk;
+
+			// 3. Global injection queue, all lanes (with the aging of background lane)
+			if (m_data.injection.try_pop(tsk))
+				return tsk;
+
+			// 4. Deques of other threads, the oldest task (FIFO)
+			const std::size_t threads_count{ m_threads.storage.size() };
+			for (std::size_t offset = 1; offset < threads_count; ++offset)
+			{
+				worker_t& victim{ *m_threads.storage[(thread_index + offset) % threads_count] };
+
+				while (!victim.deque.empty_approx())
+				{
+					if (victim.deque.steal(tsk))
+						return tsk;
+				}
+			}
+
+			return nullptr;
+		}
+
+		bool tasks_is_exists() const noexcept
+		{
+			if (!m_data.injection.empty_approx())
+				return true;
+
+			for (const std::unique_ptr<worker_t>& worker : m_threads.storage)
+			{
+				if (!worker->deque.empty_approx())
+					return true;
+			}
+
+			return false;
+		}
+
+		bool is_continue_work_thread() const noexcept
+		{
+			return (m_data.stop_working.load() || tasks_is_exists());
+		}
+
+		void wake_up_idle_thread()
+		{
+			// Pairs with the fence in thread_main_impl before a thread is parked
+			std::atomic_thread_fence(std::memory_order_seq_cst);
+
+			if (m_data.idle_threads_count.load() > 0)
+			{
+				const std::lock_guard<std::mutex> lk{ m_data.access };
+				m_data.cv.queue_changed.notify_one();
+			}
+		}
+
+		void wake_up_idle_threads(std::size_t tasks_count)
+		{
+			// Pairs with the fence in thread_main_impl before a thread is parked
+			std::atomic_thread_fence(std::memory_order_seq_cst);
+
+			const std::size_t idle_threads_count{ m_data.idle_threads_count.load() };
+
+			if (idle_threads_count > 0)
+			{
+				const std::lock_guard<std::mutex> lk{ m_data.access };
+
+				if (tasks_count >= idle_threads_count)
+				{
+					m_data.cv.queue_changed.notify_all();
+				}
+				else
+				{
+					for (std::size_t index = 0; index < tasks_count; ++index)
+						m_data.cv.queue_changed.notify_one();
+				}
+			}
+		}
+
+		void join_thread(std::thread& thread, std::size_t thread_number) noexcept
+		{
+			try
+			{
+				thread.join();
+			}
+			catch (...)
+			{
+				log_except(m_data.logger.get(), std::current_exception(), L"Finish the thread of pool is failed [number: "sv, thread_number, L']');
+			}
+		}
+
+		bool wait_tasks_complete_for_impl(std::chrono::microseconds wait_time, std::unique_lock<std::mutex>& un_lk_data)
+		{
+			assert(!m_data.stop_working);
+
+			if (this_thread_of_pool(nullptr))
+				throw promise_error{ promise_errc::deadlock }; // Waiting for the thread pool to finished from the thread in this pool
+
+			const auto all_tasks_complete = [this] { return (m_data.pending_tasks_count.load() == 0); };
+
+			if (wait_time == wait_time_infinity)
+			{
+				m_data.cv.all_tasks_complete.wait(un_lk_data, all_tasks_complete);
+			}
+			else
+			if (!m_data.cv.all_tasks_complete.wait_for(un_lk_data, wait_time, all_tasks_complete))
+			{
+				log_msg(m_data.logger.get(), L"Did not wait for the completion of all flows..."sv);
+				return false;
+			}
+
+			return true;
+		}
+
+		void wait_threads_complete_impl()
+		{
+			// Invoke under mutex: m_threads.access
+
+			assert(m_data.stop_working);
+
+			std::size_t thread_number{ 0 };
+			for (const std::unique_ptr<worker_t>& worker : m_threads.storage)
+			{
+				thread_number += 1;
+
+				if (worker->thread.joinable())
+					join_thread(worker->thread, thread_number);
+			}
+		}
+
+		void move_extra_tasks_in_begin_injection_queue()
+		{
+			// Invoke under mutex: m_threads.access, when all threads are finished
+
+			constexpr std::size_t normal_lane{ static_cast<std::size_t>(priority_t::normal) };
+
+			std::array<std::deque<task_ptr_t>, priorities_count> queue_tails;
+			task_ptr_t tsk{ nullptr };
+
+			for (std::size_t lane = 0; lane < priorities_count; ++lane)
+			{
+				while (m_data.injection.try_pop(tsk, lane))
+					queue_tails[lane].push_back(tsk);
+			}
+
+			for (const std::unique_ptr<worker_t>& worker : m_threads.storage)
+			{
+				assert(!worker->thread.joinable());
+
+				while (worker->deque.pop(tsk))
+					queue_tails[normal_lane].push_front(tsk);
+			}
+
+			for (std::size_t lane = 0; lane < priorities_count; ++lane)
+			{
+				for (task_ptr_t tsk_in_queue : queue_tails[lane])
+					m_data.injection.push(tsk_in_queue, lane);
+			}
+		}
+
+		void start_threads_impl()
+		{
+			// Invoke under mutex: m_threads.access
+
+			assert(m_data.stop_working);
+			m_data.stop_working = false;
+
+			try
+			{
+				const std::lock_guard<std::mutex> lk_data{ m_data.access }; // The threads do not take tasks until all of them are assigned
+
+				std::size_t thread_number{ 0 };
+				for (const std::unique_ptr<worker_t>& worker : m_threads.storage)
+				{
+					thread_number += 1;
+
+					assert(!worker->thread.joinable());
+
+					for (std::size_t attempt = 1, max_attempt_count = 5; attempt <= max_attempt_count; ++attempt)
+					{
+						try
+						{
+							worker->thread = std::thread(&stealing::thread_main, ctx_t{ this, thread_number - 1 });
+							break;
+						}
+						catch (...)
+						{
+							log_except(m_data.logger.get(), std::current_exception(), L"Start the thread of pool is failed [number: "sv, thread_number, L']');
+
+							if (attempt >= max_attempt_count)
+								throw;
+
+							std::this_thread::yield();
+						}
+					}
+				}
+			}
+			catch (...)
+			{
+				{
+					const std::lock_guard<std::mutex> lk_data{ m_data.access };
+					stop_threads_impl();
+				}
+				wait_threads_complete_impl();
+				throw;
+			}
+		}
+
+		void stop_threads_impl()
+		{
+			// Invoke under mutex: m_data.access
+
+			m_data.stop_working = true;
+			m_data.cv.queue_changed.notify_all();
+		}
+
+		bool this_thread_of_pool(std::size_t* thread_index) const noexcept
+		{
+			const ctx_t this_thread_ctx{ current_ctx() };
+
+			if (this != std::get<pool*>(this_thread_ctx))
+				return false;
+
+			if (thread_index)
+				*thread_index = std::get<std::size_t>(this_thread_ctx);
+
+			return true;
+		}
+
+	private:
+
+		data_t m_data;
+
+		details::pool_counters m_counters;
+
+		struct
+		{
+			std::mutex access;
+			std::vector<std::unique_ptr<worker_t>> storage;
+
+		} m_threads;
+
+		static constexpr std::chrono::microseconds wait_time_infinity{ std::chrono::microseconds::zero() };
+	};
+
+} // namespace async::pool_threads
@@ -0,0 +1,142 @@
+#pragma once
+
+
+#include <array>
+#include <atomic>
+#include <cassert>
+#include <cstddef>
+#include <utility>
+
+#include <async/mpmc_queue.hpp>
+
+
+namespace async::details
+{
+	/** \brief Anti-starvation aging of the priority lanes.
+	 *
+	 * \details The lane 0 has the highest priority. The next item is taken from the highest non-empty lane, but a lower lane
+	 *          which was passed over (it was not empty when a higher lane was taken) \a aging_limit times gets the next turn.
+	 *          So a flood of high-priority work delays the low-priority items, but never blocks them.
+	 *
+	 * \details \a _Counter is \a std::size_t for the lanes guarded by a mutex and \a std::atomic<std::size_t> for the lock-free lanes
+	 *          (there the aging is approximate: the concurrent consumers can give the turn to one lane twice).
+	 */
+	template<std::size_t _LanesCount, class _Counter = std::size_t>
+	class lanes_aging
+	{
+		static_assert(_LanesCount > 0);
+
+	public:
+
+		static constexpr std::size_t aging_limit{ 16 };
+
+	public:
+
+		/** \brief Take the next item.
+		 *
+		 * \param [in] try_take_from_lane - Functor \a bool(std::size_t lane): take the item from the lane, if it is not empty.
+		 * \param [in] lane_is_empty      - Functor \a bool(std::size_t lane).
+		 *
+		 * \return If the item is taken \a true, otherwise (all lanes are empty) \a false.
+		 */
+		template<class _TryTakeFromLane, class _LaneIsEmpty>
+		[[nodiscard]] bool try_take(_TryTakeFromLane&& try_take_from_lane, _LaneIsEmpty&& lane_is_empty)
+		{
+			// 1. The aged lane, the lowest first (it waits longest)
+			for (std::size_t lane = _LanesCount; lane-- > 1; )
+			{
+				if (m_passed_over[lane] >= aging_limit)
+				{
+					m_passed_over[lane] = 0;
+
+					if (try_take_from_lane(lane))
+						return true;
+				}
+			}
+
+			// 2. By priority
+			for (std::size_t lane = 0; lane < _LanesCount; ++lane)
+			{
+				if (try_take_from_lane(lane))
+				{
+					for (std::size_t lower_lane = lane + 1; lower_lane < _LanesCount; ++lower_lane)
+					{
+						if (!lane_is_empty(lower_lane))
+							m_passed_over[lower_lane] += 1;
+					}
+
+					return true;
+				}
+			}
+
+			return false;
+		}
+
+	private:
+
+		std::array<_Counter, _LanesCount> m_passed_over{};
+	};
+
+
+	/** \brief Lock-free priority lanes: \a mpmc_queue per lane with \a lanes_aging between them.
+	 *
+	 * \details The order of the items is FIFO inside a lane.
+	 */
+	template<class _Item, std::size_t _LanesCount>
+	class mpmc_lanes
+	{
+	public:
+
+		void push(_Item item, std::size_t lane)
+		{
+			assert(lane < _LanesCount);
+			m_lanes[lane].push(std::move(item));
+		}
+
+		[[nodiscard]] bool try_pop(_Item& item)
+		{
+			return m_aging.try_take(
+				[this, &item](std::size_t lane) { return m_lanes[lane].try_pop(item); },
+				[this](std::size_t lane) { return m_lanes[lane].empty_approx(); });
+		}
+
+		[[nodiscard]] bool try_pop(_Item& item, std::size_t lane)
+		{
+			assert(lane < _LanesCount);
+			return m_lanes[lane].try_pop(item);
+		}
+
+		[[nodiscard]] std::size_t size_approx() const noexcept
+		{
+			std::size_t result{ 0 };
+
+			for (const mpmc_queue<_Item>& lane_queue : m_lanes)
+				result += lane_queue.size_approx();
+
+			return result;
+		}
+
+		[[nodiscard]] bool empty_approx() const noexcept
+		{
+			for (const mpmc_queue<_Item>& lane_queue : m_lanes)
+			{
+				if (!lane_queue.empty_approx())
+					return false;
+			}
+
+			return true;
+		}
+
+		[[nodiscard]] bool empty_approx(std::size_t lane) const noexcept
+		{
+			assert(lane < _LanesCount);
+			return m_lanes[lane].empty_approx();
+		}
+
+	private:
+
+		std::array<mpmc_queue<_Item>, _LanesCount> m_lanes;
+		lanes_aging<_LanesCount, std::atomic<std::size_t>> m_aging;
+	};
+
+} // namespace async::details
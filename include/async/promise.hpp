@@ -1,14 +1,17 @@
 
 #pragma once
 
-#include <async\promise_types.hpp>
-#include <async\value.hpp>
+#include <async/promise_types.hpp>
+#include <async/value.hpp>
 
 
 namespace async::details
 {
 	template<class _Value>
-	std::shared_ptr<typename details::prom_data_t<_Value>> take_data_of_promise(promise<_Value>& promise);
+	prom_data_ptr<_Value> take_data_of_promise(promise<_Value>& promise);
+
+	template<class _Value>
+	class coroutine_promise_base;
 
 } // namespace async::details
 
@@ -44,30 +47,54 @@ namespace async
 
 	public:
 
-		promise<_Result> then(std::wstring log_ctx, then_t<_Result, _Result> thn, finally_t fnly = {});
+		/** \brief Priority of the next steps (\a then, \a success, \a reject, \a finaly) in the pool.
+		 *
+		 * \details The promise of the next step inherits the priority, so it is kept along the chain until it is set again.
+		 */
+		pool::priority_t priority() const;
+		promise& set_priority(pool::priority_t priority);
+
+		/** \brief Execution of the next step: through the pool queue or at once in the thread, which completed this promise.
+		 *
+		 * \details It is not inherited: the promise of the next step uses \a pool::continuations_exec, until it is set.
+		 *          The \a inline_exec tag of \a then, \a success, \a reject, \a finaly sets \a pool::exec_t::inline_exec.
+		 */
+		pool::exec_t exec() const;
+		promise& set_exec(pool::exec_t exec);
+
+	public:
+
+		promise<_Result> then(log_ctx_t log_ctx, then_t<_Result, _Result> thn, finally_t fnly = {});
 		promise<_Result> then(                      then_t<_Result, _Result> thn, finally_t fnly = {});
 
-		promise<_Result> then(std::wstring log_ctx, success_t<_Result, _Result> scss, reject_t<_Result> rjct, finally_t fnly = {});
+		promise<_Result> then(log_ctx_t log_ctx, success_t<_Result, _Result> scss, reject_t<_Result> rjct, finally_t fnly = {});
 		promise<_Result> then(                      success_t<_Result, _Result> scss, reject_t<_Result> rjct, finally_t fnly = {});
 
-		template<class _Result2> promise<_Result2> then(std::wstring log_ctx, then_t<_Result2, _Result> thn, finally_t fnly = {});
+		template<class _Result2> promise<_Result2> then(log_ctx_t log_ctx, then_t<_Result2, _Result> thn, finally_t fnly = {});
 		template<class _Result2> promise<_Result2> then(                      then_t<_Result2, _Result> thn, finally_t fnly = {});
 
-		template<class _Result2> promise<_Result2> then(std::wstring log_ctx, success_t<_Result2, _Result> scss, reject_t<_Result2> rjct, finally_t fnly = {});
+		template<class _Result2> promise<_Result2> then(log_ctx_t log_ctx, success_t<_Result2, _Result> scss, reject_t<_Result2> rjct, finally_t fnly = {});
 		template<class _Result2> promise<_Result2> then(                      success_t<_Result2, _Result> scss, reject_t<_Result2> rjct, finally_t fnly = {});
 
-		promise<_Result> success(std::wstring log_ctx, success_t<_Result, _Result> scss, finally_t fnly = {});
+		promise<_Result> success(log_ctx_t log_ctx, success_t<_Result, _Result> scss, finally_t fnly = {});
 		promise<_Result> success(                      success_t<_Result, _Result> scss, finally_t fnly = {});
 
-		template<class _Result2> promise<_Result2> success(std::wstring log_ctx, success_t<_Result2, _Result> scss, finally_t fnly = {});
+		template<class _Result2> promise<_Result2> success(log_ctx_t log_ctx, success_t<_Result2, _Result> scss, finally_t fnly = {});
 		template<class _Result2> promise<_Result2> success(                      success_t<_Result2, _Result> scss, finally_t fnly = {});
 
-		promise<_Result> reject(std::wstring log_ctx, reject_t<_Result> rjct, finally_t fnly = {});
+		promise<_Result> reject(log_ctx_t log_ctx, reject_t<_Result> rjct, finally_t fnly = {});
 		promise<_Result> reject(                      reject_t<_Result> rjct, finally_t fnly = {});
 
-		promise<_Result> finaly(std::wstring log_ctx, finally_t fnly);
+		promise<_Result> finaly(log_ctx_t log_ctx, finally_t fnly);
 		promise<_Result> finaly(                      finally_t fnly);
 
+	public:
+
+		template<class _Result2 = _Result, class... _Args> promise<_Result2> then(inline_exec_t, _Args&&... args);
+		template<class _Result2 = _Result, class... _Args> promise<_Result2> success(inline_exec_t, _Args&&... args);
+		template<class... _Args>                            promise<_Result>  reject(inline_exec_t, _Args&&... args);
+		template<class... _Args>                            promise<_Result>  finaly(inline_exec_t, _Args&&... args);
+
 	private:
 
 		friend class manager;
@@ -75,6 +102,9 @@ namespace async
 		template<class _Result2>
 		friend class promise;
 
+		template<class _Value>
+		friend class details::coroutine_promise_base;
+
 		template<class _Value>
 		using prom_data_t = details::prom_data_t<_Value>;
 
@@ -82,11 +112,11 @@ namespace async
 		using prom_data_ptr = details::prom_data_ptr<_Value>;
 
 		template<class _Value>
-		friend std::shared_ptr<prom_data_t<_Value>> details::take_data_of_promise<_Value>(promise<_Value>& promise);
+		friend prom_data_ptr<_Value> details::take_data_of_promise(promise<_Value>& promise);
 
 	private:
 
-		promise(pool_ptr pool);
+		promise(pool_ptr pool, pool::priority_t priority = pool::priority_t::normal);
 
 		bool pool_is_equal(const pool_ptr& other_pool) const;
 
@@ -1,8 +1,8 @@
 
 #pragma once
 
-#include <async\promise.hpp>
-#include <async\details__impl.hpp>
+#include <async/promise.hpp>
+#include <async/details__impl.hpp>
 
 
 namespace async
@@ -13,11 +13,9 @@ namespace async
 	{}
 
 	template<class _Result>
-	promise<_Result>::promise(pool_ptr pool)
-		: m_data(std::make_shared<prom_data_t<_Result>>())
-	{
-		m_data->pool = std::move(pool);
-	}
+	promise<_Result>::promise(pool_ptr pool, pool::priority_t priority)
+		: m_data(details::make_prom_data<_Result>(std::move(pool), priority))
+	{}
 
 	template<class _Result>
 	promise<_Result>::promise(promise&& other) noexcept
@@ -33,7 +31,8 @@ namespace async
 	template<class _Result>
 	bool promise<_Result>::pool_is_equal(const pool_ptr& other_pool) const
 	{
-		if (const prom_data_ptr<_Result> data = std::atomic_load(&m_data))
+		// The atomic copy holds the state while the pool is compared: the promise can be taken by the other thread (see take_data)
+		if (const prom_data_ptr<_Result> data = m_data.atomic_copy())
 			return (data->pool == other_pool);
 
 		return false;
@@ -42,7 +41,7 @@ namespace async
 	template<class _Result>
 	details::prom_data_ptr<_Result> promise<_Result>::take_data()
 	{
-		prom_data_ptr<_Result> data{ std::atomic_exchange(&m_data, prom_data_ptr<_Result>()) };
+		prom_data_ptr<_Result> data{ m_data.exchange(nullptr) };
 
 		if (!data)
 			throw promise_error{ promise_errc::no_state };
@@ -77,15 +76,81 @@ namespace async
 
 	}
 
+	template<class _Result>
+	pool::priority_t promise<_Result>::priority() const
+	{
+		if (!m_data)
+			throw promise_error{ promise_errc::no_state };
+
+		return m_data->result.priority;
+	}
+
+	template<class _Result>
+	promise<_Result>& promise<_Result>::set_priority(pool::priority_t priority)
+	{
+		if (!m_data)
+			throw promise_error{ promise_errc::no_state };
+
+		m_data->result.priority = priority;
+		return *this;
+	}
+
+	template<class _Result>
+	pool::exec_t promise<_Result>::exec() const
+	{
+		if (!m_data)
+			throw promise_error{ promise_errc::no_state };
+
+		return m_data->result.exec.value_or(m_data->pool->continuations_exec());
+	}
+
+	template<class _Result>
+	promise<_Result>& promise<_Result>::set_exec(pool::exec_t exec)
+	{
+		if (!m_data)
+			throw promise_error{ promise_errc::no_state };
+
+		m_data->result.exec = exec;
+		return *this;
+	}
+
+	template<class _Result>
+	template<class _Result2, class... _Args>
+	inline promise<_Result2> promise<_Result>::then(inline_exec_t, _Args&&... args)
+	{
+		return this->set_exec(pool::exec_t::inline_exec).template then<_Result2>(std::forward<_Args>(args)...);
+	}
+
+	template<class _Result>
+	template<class _Result2, class... _Args>
+	inline promise<_Result2> promise<_Result>::success(inline_exec_t, _Args&&... args)
+	{
+		return this->set_exec(pool::exec_t::inline_exec).template success<_Result2>(std::forward<_Args>(args)...);
+	}
+
+	template<class _Result>
+	template<class... _Args>
+	inline promise<_Result> promise<_Result>::reject(inline_exec_t, _Args&&... args)
+	{
+		return this->set_exec(pool::exec_t::inline_exec).reject(std::forward<_Args>(args)...);
+	}
+
+	template<class _Result>
+	template<class... _Args>
+	inline promise<_Result> promise<_Result>::finaly(inline_exec_t, _Args&&... args)
+	{
+		return this->set_exec(pool::exec_t::inline_exec).finaly(std::forward<_Args>(args)...);
+	}
+
 	template<class _Result>
 	template<class _Result2>
-	inline promise<_Result2> promise<_Result>::then(std::wstring log_ctx, then_t<_Result2, _Result> thn, finally_t fnly)
+	inline promise<_Result2> promise<_Result>::then(log_ctx_t log_ctx, then_t<_Result2, _Result> thn, finally_t fnly)
 	{
 		using namespace std::literals;
 
 		const prom_data_ptr<_Result> arg_data{ this->take_data() };
 
-		promise<_Result2> res_promise(arg_data->pool);
+		promise<_Result2> res_promise(arg_data->pool, arg_data->result.priority);
 
 		const prom_data_ptr<_Result2> res_data{ res_promise.m_data };
 
@@ -95,12 +160,10 @@ namespace async
 			*arg_data->pool,
 			[log_ctx = details::normalize_log_ctx(std::move(log_ctx)), res_data, arg_data, fnc_thn = std::move(thn), fnc_fnly = std::move(fnly)](pool::ctx_t pool_ctx)
 		{
-			assert(std::get<pool*>(pool_ctx));
-			assert(std::get<pool*>(pool_ctx)->log());
-			logger* const logger{ std::get<pool*>(pool_ctx)->log() };
+			logger* const logger{ arg_data->pool->log() };
 
 			res_data->log_ctx.swap(arg_data->log_ctx);
-			details::append_log_ctx(res_data->log_ctx, log_ctx);
+			details::append_log_ctx(logger, res_data->log_ctx, log_ctx);
 
 			value_or_promise_t<_Result2> result{ details::then_then<_Result2, _Result>(logger, res_data->log_ctx, arg_data->result.value, fnc_thn) };
 
@@ -117,11 +180,11 @@ namespace async
 	template<class _Result2>
 	inline promise<_Result2> promise<_Result>::then(then_t<_Result2, _Result> thn, finally_t fnly)
 	{
-		return this->then<_Result2>(std::wstring(), std::move(thn), std::move(fnly));
+		return this->then<_Result2>(log_ctx_t{}, std::move(thn), std::move(fnly));
 	}
 
 	template<class _Result>
-	inline promise<_Result> promise<_Result>::then(std::wstring log_ctx, then_t<_Result, _Result> thn, finally_t fnly)
+	inline promise<_Result> promise<_Result>::then(log_ctx_t log_ctx, then_t<_Result, _Result> thn, finally_t fnly)
 	{
 		return this->then<_Result>(std::move(log_ctx), std::move(thn), std::move(fnly));
 	}
@@ -129,16 +192,16 @@ namespace async
 	template<class _Result>
 	inline promise<_Result> promise<_Result>::then(then_t<_Result, _Result> thn, finally_t fnly)
 	{
-		return this->then<_Result>(std::wstring(), std::move(thn), std::move(fnly));
+		return this->then<_Result>(log_ctx_t{}, std::move(thn), std::move(fnly));
 	}
 
 	template<class _Result>
 	template<class _Result2>
-	inline promise<_Result2> promise<_Result>::then(std::wstring log_ctx, success_t<_Result2, _Result> scss, reject_t<_Result2> rjct, finally_t fnly)
+	inline promise<_Result2> promise<_Result>::then(log_ctx_t log_ctx, success_t<_Result2, _Result> scss, reject_t<_Result2> rjct, finally_t fnly)
 	{
 		const prom_data_ptr<_Result> arg_data{ this->take_data() };
 
-		promise<_Result2> res_promise(arg_data->pool);
+		promise<_Result2> res_promise(arg_data->pool, arg_data->result.priority);
 
 		const prom_data_ptr<_Result2> res_data{ res_promise.m_data };
 
@@ -148,12 +211,10 @@ namespace async
 			*arg_data->pool,
 			[log_ctx = details::normalize_log_ctx(std::move(log_ctx)), res_data, arg_data, fnc_scss = std::move(scss), fnc_rjct = std::move(rjct), fnc_fnly = std::move(fnly)](pool::ctx_t pool_ctx)
 		{
-			assert(std::get<pool*>(pool_ctx));
-			assert(std::get<pool*>(pool_ctx)->log());
-			logger* const logger{ std::get<pool*>(pool_ctx)->log() };
+			logger* const logger{ arg_data->pool->log() };
 
 			res_data->log_ctx.swap(arg_data->log_ctx);
-			details::append_log_ctx(res_data->log_ctx, log_ctx);
+			details::append_log_ctx(logger, res_data->log_ctx, log_ctx);
 
 			value_or_promise_t<_Result2> result{ details::then_success_reject<_Result2, _Result>(logger, res_data->log_ctx, arg_data->result.value, fnc_scss, fnc_rjct) };
 
@@ -170,11 +231,11 @@ namespace async
 	template<class _Result2>
 	inline promise<_Result2> promise<_Result>::then(success_t<_Result2, _Result> scss, reject_t<_Result2> rjct, finally_t fnly)
 	{
-		return this->then<_Result2>(std::wstring(), std::move(scss), std::move(rjct), std::move(fnly));
+		return this->then<_Result2>(log_ctx_t{}, std::move(scss), std::move(rjct), std::move(fnly));
 	}
 
 	template<class _Result>
-	inline promise<_Result> promise<_Result>::then(std::wstring log_ctx, success_t<_Result, _Result> scss, reject_t<_Result> rjct, finally_t fnly)
+	inline promise<_Result> promise<_Result>::then(log_ctx_t log_ctx, success_t<_Result, _Result> scss, reject_t<_Result> rjct, finally_t fnly)
 	{
 		return this->then<_Result>(std::move(log_ctx), std::move(scss), std::move(rjct), std::move(fnly));
 	}
@@ -182,16 +243,16 @@ namespace async
 	template<class _Result>
 	inline promise<_Result> promise<_Result>::then(success_t<_Result, _Result> scss, reject_t<_Result> rjct, finally_t fnly)
 	{
-		return this->then<_Result>(std::wstring(), std::move(scss), std::move(rjct), std::move(fnly));
+		return this->then<_Result>(log_ctx_t{}, std::move(scss), std::move(rjct), std::move(fnly));
 	}
 
 	template<class _Result>
 	template<class _Result2>
-	inline promise<_Result2> promise<_Result>::success(std::wstring log_ctx, success_t<_Result2, _Result> scss, finally_t fnly)
+	inline promise<_Result2> promise<_Result>::success(log_ctx_t log_ctx, success_t<_Result2, _Result> scss, finally_t fnly)
 	{
 		const prom_data_ptr<_Result> arg_data{ this->take_data() };
 
-		promise<_Result2> res_promise(arg_data->pool);
+		promise<_Result2> res_promise(arg_data->pool, arg_data->result.priority);
 
 		const prom_data_ptr<_Result2> res_data{ res_promise.m_data };
 
@@ -201,12 +262,10 @@ namespace async
 			*arg_data->pool,
 			[log_ctx = details::normalize_log_ctx(std::move(log_ctx)), res_data, arg_data, fnc_scss = std::move(scss), fnc_fnly = std::move(fnly)](pool::ctx_t pool_ctx)
 		{
-			assert(std::get<pool*>(pool_ctx));
-			assert(std::get<pool*>(pool_ctx)->log());
-			logger* const logger{ std::get<pool*>(pool_ctx)->log() };
+			logger* const logger{ arg_data->pool->log() };
 
 			res_data->log_ctx.swap(arg_data->log_ctx);
-			details::append_log_ctx(res_data->log_ctx, log_ctx);
+			details::append_log_ctx(logger, res_data->log_ctx, log_ctx);
 
 			value_or_promise_t<_Result2> result{ details::then_success<_Result2, _Result>(logger, res_data->log_ctx, arg_data->result.value, fnc_scss) };
 
@@ -223,11 +282,11 @@ namespace async
 	template<class _Result2>
 	inline promise<_Result2> promise<_Result>::success(success_t<_Result2, _Result> scss, finally_t fnly)
 	{
-		return this->success<_Result2>(std::wstring(), std::move(scss), std::move(fnly));
+		return this->success<_Result2>(log_ctx_t{}, std::move(scss), std::move(fnly));
 	}
 
 	template<class _Result>
-	inline promise<_Result> promise<_Result>::success(std::wstring log_ctx, success_t<_Result, _Result> scss, finally_t fnly)
+	inline promise<_Result> promise<_Result>::success(log_ctx_t log_ctx, success_t<_Result, _Result> scss, finally_t fnly)
 	{
 		return this->success<_Result>(std::move(log_ctx), std::move(scss), std::move(fnly));
 	}
@@ -235,15 +294,15 @@ namespace async
 	template<class _Result>
 	inline promise<_Result> promise<_Result>::success(success_t<_Result, _Result> scss, finally_t fnly)
 	{
-		return this->success<_Result>(std::wstring(), std::move(scss), std::move(fnly));
+		return this->success<_Result>(log_ctx_t{}, std::move(scss), std::move(fnly));
 	}
 
 	template<class _Result>
-	inline promise<_Result> promise<_Result>::reject(std::wstring log_ctx, reject_t<_Result> rjct, finally_t fnly)
+	inline promise<_Result> promise<_Result>::reject(log_ctx_t log_ctx, reject_t<_Result> rjct, finally_t fnly)
 	{
 		const prom_data_ptr<_Result> arg_data{ this->take_data() };
 
-		promise<_Result> res_promise(arg_data->pool);
+		promise<_Result> res_promise(arg_data->pool, arg_data->result.priority);
 
 		const prom_data_ptr<_Result> res_data{ res_promise.m_data };
 
@@ -253,12 +312,10 @@ namespace async
 			*arg_data->pool,
 			[log_ctx = details::normalize_log_ctx(std::move(log_ctx)), res_data, arg_data, fnc_rjct = std::move(rjct), fnc_fnly = std::move(fnly)](pool::ctx_t pool_ctx)
 		{
-			assert(std::get<pool*>(pool_ctx));
-			assert(std::get<pool*>(pool_ctx)->log());
-			logger* const logger{ std::get<pool*>(pool_ctx)->log() };
+			logger* const logger{ arg_data->pool->log() };
 
 			res_data->log_ctx.swap(arg_data->log_ctx);
-			details::append_log_ctx(res_data->log_ctx, log_ctx);
+			details::append_log_ctx(logger, res_data->log_ctx, log_ctx);
 
 			value_or_promise_t<_Result> result{ details::then_reject<_Result>(logger, res_data->log_ctx, std::move(arg_data->result.value), fnc_rjct) };
 
@@ -274,15 +331,15 @@ namespace async
 	template<class _Result>
 	inline promise<_Result> promise<_Result>::reject(reject_t<_Result> rjct, finally_t fnly)
 	{
-		return this->reject(std::wstring(), std::move(rjct), std::move(fnly));
+		return this->reject(log_ctx_t{}, std::move(rjct), std::move(fnly));
 	}
 
 	template<class _Result>
-	inline promise<_Result> promise<_Result>::finaly(std::wstring log_ctx, finally_t fnly)
+	inline promise<_Result> promise<_Result>::finaly(log_ctx_t log_ctx, finally_t fnly)
 	{
 		const prom_data_ptr<_Result> arg_data{ this->take_data() };
 
-		promise<_Result> res_promise(arg_data->pool);
+		promise<_Result> res_promise(arg_data->pool, arg_data->result.priority);
 
 		const prom_data_ptr<_Result> res_data{ res_promise.m_data };
 
@@ -292,12 +349,10 @@ namespace async
 			*arg_data->pool,
 			[log_ctx = details::normalize_log_ctx(std::move(log_ctx)), res_data, arg_data, fnc_fnly = std::move(fnly)](pool::ctx_t pool_ctx)
 		{
-			assert(std::get<pool*>(pool_ctx));
-			assert(std::get<pool*>(pool_ctx)->log());
-			logger* const logger{ std::get<pool*>(pool_ctx)->log() };
+			logger* const logger{ arg_data->pool->log() };
 
 			res_data->log_ctx.swap(arg_data->log_ctx);
-			details::append_log_ctx(res_data->log_ctx, log_ctx);
+			details::append_log_ctx(logger, res_data->log_ctx, log_ctx);
 
 			value_or_promise_t<_Result> arg_data_result;
 			arg_data_result.set_value(std::move(arg_data->result.value));
@@ -311,7 +366,7 @@ namespace async
 	template<class _Result>
 	inline promise<_Result> promise<_Result>::finaly(finally_t fnly)
 	{
-		return this->finaly(std::wstring(), std::move(fnly));
+		return this->finaly(log_ctx_t{}, std::move(fnly));
 	}
 
 } // namespace async
@@ -0,0 +1,271 @@
+#pragma once
+
+#include <async/config.hpp>
+
+#ifdef ASYNC_LIB_COROUTINES
+
+#include <async/manager.hpp>
+#include <async/promise.hpp>
+#include <async/details__impl.hpp>
+
+#include <new>
+#include <cstddef>
+#include <utility>
+#include <coroutine>
+#include <exception>
+#include <type_traits>
+#include <memory_resource>
+
+
+namespace async::details
+{
+	template<class _Arg>
+	inline constexpr bool is_manager_v{ std::is_same_v<std::remove_cv_t<_Arg>, manager> };
+
+	template<class _Arg, class... _Args>
+	[[nodiscard]] inline const manager& coroutine_manager(const _Arg& arg, const _Args&... args) noexcept
+	{
+		if constexpr (is_manager_v<_Arg>)
+			return arg;
+		else
+			return coroutine_manager(args...);
+	}
+
+
+	/** \brief Awaiter of \a promise: the coroutine is resumed by the next step of the promise, so in its pool (see \a promise::exec).
+	 *
+	 * \details The resolved promise does not go through the pool: the coroutine continues in this thread.
+	 */
+	template<class _Value>
+	class promise_awaiter
+	{
+	public:
+
+		explicit promise_awaiter(prom_data_ptr<_Value> data) noexcept
+			: m_data(std::move(data))
+		{}
+
+		[[nodiscard]] bool await_ready() const noexcept
+		{
+			return (m_data->result.state.load() == result_state_t::value);
+		}
+
+		std::coroutine_handle<> await_suspend(std::coroutine_handle<> coroutine)
+		{
+			// The awaiter is a part of the frame, which can be destroyed by the resumed coroutine before the return
+			const prom_data_ptr<_Value> data{ m_data };
+
+			if (data->result.state.load() == result_state_t::value)
+				return coroutine; // It is resolved after await_ready: the symmetric transfer, without the pool
+
+			api<_Value>::bind_next_step(
+				pool::unknown_ctx,
+				data->result,
+				*data->pool,
+				[coroutine](pool::ctx_t)
+			{
+				coroutine.resume();
+			});
+
+			return std::noop_coroutine();
+		}
+
+		_Value await_resume()
+		{
+			if constexpr (std::is_void_v<_Value>)
+				m_data->result.value.get_value();
+			else
+				return std::move(m_data->result.value).get_value();
+		}
+
+	private:
+
+		prom_data_ptr<_Value> m_data;
+	};
+
+
+	/** \brief Type of the promise of coroutine, which returns \a promise: the coroutine takes \a manager (by reference) as one of its arguments.
+	 *
+	 * \details The coroutine is executed in the calling thread until the first \a co_await, the next parts are executed by the pool of the manager.
+	 *          The frame is allocated from the memory resource of the manager (see \a manager::memory_resource) and is freed before
+	 *          the next steps of the result.
+	 */
+	template<class _Value>
+	class coroutine_promise_base
+	{
+	protected:
+
+		/** \brief The frame is freed before the result is set, so the next steps do not wait for it.
+		 */
+		struct final_awaiter
+		{
+			bool await_ready() const noexcept
+			{
+				return false;
+			}
+
+			template<class _Promise>
+			void await_suspend(std::coroutine_handle<_Promise> coroutine) const noexcept
+			{
+				coroutine_promise_base& base{ coroutine.promise() };
+
+				const prom_data_ptr<_Value> data{ std::move(base.m_data) };
+				value_t<_Value> value{ std::move(base.m_value) };
+
+				coroutine.destroy();
+
+				try
+				{
+					api<_Value>::set_result_impl(pool::unknown_ctx, *data->pool, data->result, std::move(value));
+				}
+				catch (...)
+				{
+					log_except(data->pool->log(), std::current_exception(), L'[', data->log_ctx, L']');
+				}
+			}
+
+			void await_resume() const noexcept
+			{}
+		};
+
+	public:
+
+		template<class... _Args>
+		explicit coroutine_promise_base(const _Args&... args)
+		{
+			static_assert((is_manager_v<_Args> || ...), "The coroutine, which returns async::promise, takes async::manager& as an argument");
+
+			const manager& mngr{ coroutine_manager(args...) };
+
+			m_data = make_prom_data<_Value>(mngr.check_and_get_pool(), pool::priority_t::normal);
+
+			if (logger* const log = m_data->pool->log())
+			{
+				using namespace std::literals;
+				m_data->log_ctx = details::normalize_log_ctx(log, log_ctx_t{}, L"coro"sv);
+			}
+		}
+
+		template<class... _Args>
+		[[nodiscard]] static void* operator new(std::size_t size, const _Args&... args)
+		{
+			static_assert((is_manager_v<_Args> || ...), "The coroutine, which returns async::promise, takes async::manager& as an argument");
+
+			std::pmr::memory_resource* const resource{ coroutine_manager(args...).memory_resource() };
+
+			// The resource is kept after the frame for operator delete
+			void* const memory{ resource->allocate(frame_size(size), alignof(std::max_align_t)) };
+			::new (static_cast<std::byte*>(memory) + resource_offset(size)) std::pmr::memory_resource*{ resource };
+
+			return memory;
+		}
+
+		static void operator delete(void* memory, std::size_t size) noexcept
+		{
+			std::pmr::memory_resource* const resource{ *std::launder(reinterpret_cast<std::pmr::memory_resource**>(static_cast<std::byte*>(memory) + resource_offset(size))) };
+
+			resource->deallocate(memory, frame_size(size), alignof(std::max_align_t));
+		}
+
+	public:
+
+		promise<_Value> get_return_object() noexcept
+		{
+			promise<_Value> result{};
+			result.m_data = m_data;
+
+			return result;
+		}
+
+		std::suspend_never initial_suspend() const noexcept
+		{
+			return {};
+		}
+
+		final_awaiter final_suspend() const noexcept
+		{
+			return {};
+		}
+
+		void unhandled_exception() noexcept
+		{
+			log_except(m_data->pool->log(), std::current_exception(), L'[', m_data->log_ctx, L']');
+
+			m_value.set_except(std::current_exception());
+		}
+
+	protected:
+
+		value_t<_Value> m_value;
+
+	private:
+
+		static constexpr std::size_t resource_offset(std::size_t size) noexcept
+		{
+			return (size + alignof(std::pmr::memory_resource*) - 1) / alignof(std::pmr::memory_resource*) * alignof(std::pmr::memory_resource*);
+		}
+
+		static constexpr std::size_t frame_size(std::size_t size) noexcept
+		{
+			return resource_offset(size) + sizeof(std::pmr::memory_resource*);
+		}
+
+	private:
+
+		prom_data_ptr<_Value> m_data;
+	};
+
+	template<class _Value>
+	class coroutine_promise : public coroutine_promise_base<_Value>
+	{
+	public:
+
+		using coroutine_promise_base<_Value>::coroutine_promise_base;
+
+		template<class _Value2 = _Value>
+		void return_value(_Value2&& value)
+		{
+			this->m_value.set_value(std::forward<_Value2>(value));
+		}
+	};
+
+	template<>
+	class coroutine_promise<void> : public coroutine_promise_base<void>
+	{
+	public:
+
+		using coroutine_promise_base<void>::coroutine_promise_base;
+
+		void return_void()
+		{
+			m_value.set_value();
+		}
+	};
+
+} // namespace async::details
+
+
+namespace async
+{
+	/** \brief \a co_await of the promise: the promise is taken (as by \a then) and its value is the result (or its exception is thrown).
+	 */
+	template<class _Value>
+	[[nodiscard]] inline details::promise_awaiter<_Value> operator co_await(promise<_Value>&& prom)
+	{
+		return details::promise_awaiter<_Value>{ details::take_data_of_promise(prom) };
+	}
+
+} // namespace async
+
+
+namespace std
+{
+	template<class _Value, class... _Args>
+	struct coroutine_traits<async::promise<_Value>, _Args...>
+	{
+		using promise_type = async::details::coroutine_promise<_Value>;
+	};
+
+} // namespace std
+
+#endif // ASYNC_LIB_COROUTINES
@@ -28,15 +28,15 @@ namespace async
 	{
 	public:
 
-		inline explicit promise_error::promise_error(promise_errc errc)
+		inline explicit promise_error(promise_errc errc)
 			: std::logic_error("")
 			, m_code{ make_error_code(errc) }
 		{}
-		[[nodiscard]] inline std::error_code promise_error::code() const noexcept
+		[[nodiscard]] inline std::error_code code() const noexcept
 		{
 			return m_code;
 		}
-		[[nodiscard]] virtual const char* promise_error::what() const override
+		[[nodiscard]] virtual const char* what() const noexcept override
 		{
 			return to_static_message_view(m_code.value()).data();
 		}
@@ -59,7 +59,6 @@ namespace async
 		case promise_errc::no_state:                    return "no state"sv;
 		default:                                        return ""sv;
 		}
-		__assume(false);
 	}
 	inline std::error_code make_error_code(promise_errc errc) noexcept
 	{
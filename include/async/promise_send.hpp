@@ -2,7 +2,7 @@
 #pragma once
 
 
-#include <async\promise.hpp>
+#include <async/promise.hpp>
 
 
 namespace async
@@ -17,11 +17,11 @@ namespace async
 	{
 	public:
 
-		template<class _Value>
-		using prom_data_t = details::prom_data_t<_Value>;
+		template<class _Other>
+		using prom_data_t = details::prom_data_t<_Other>;
 
-		template<class _Value>
-		using prom_data_ptr = details::prom_data_ptr<_Value>;
+		template<class _Other>
+		using prom_data_ptr = details::prom_data_ptr<_Other>;
 
 	public:
 
@@ -4,9 +4,9 @@
 
 #include <optional>
 
-#include <async\logger.hpp>
-#include <async\promise_send.hpp>
-#include <async\details__impl.hpp>
+#include <async/logger.hpp>
+#include <async/promise_send.hpp>
+#include <async/details__impl.hpp>
 
 
 namespace async
@@ -19,7 +19,7 @@ namespace async
 
 	template<class _Value>
 	inline promise<_Value>::send::send(prom_data_ptr<_Value> data)
-		: m_data{ data ? std::make_shared<data_t>() : nullptr }
+		: m_data{ data ? data->pool->template allocate_shared<data_t>() : nullptr }
 	{
 		if (m_data)
 			m_data->promise_data = std::move(data);
@@ -108,7 +108,7 @@ namespace async
 
 		if (m_data)
 		{
-			if (prom_data_ptr<_Value> promise_data = std::atomic_exchange(&m_data->promise_data, prom_data_ptr<_Value>{}))
+			if (prom_data_ptr<_Value> promise_data = m_data->promise_data.exchange(nullptr))
 			{
 				value_or_promise_t<_Value> value{};
 				value.set_value();
@@ -148,7 +148,7 @@ namespace async
 
 		if (m_data)
 		{
-			if (prom_data_ptr<_Value> promise_data = std::atomic_exchange(&m_data->promise_data, prom_data_ptr<_Value>{}))
+			if (prom_data_ptr<_Value> promise_data = m_data->promise_data.exchange(nullptr))
 			{
 				value_or_promise_t<_Value> value{};
 				value.set_value(std::forward<_Value2>(raw_value));
@@ -186,7 +186,7 @@ namespace async
 	{
 		if (m_data)
 		{
-			if (prom_data_ptr<_Value> promise_data = std::atomic_exchange(&m_data->promise_data, prom_data_ptr<_Value>{}))
+			if (prom_data_ptr<_Value> promise_data = m_data->promise_data.exchange(nullptr))
 			{
 				try
 				{
@@ -211,7 +211,7 @@ namespace async
 	{
 		if (m_data)
 		{
-			if (prom_data_ptr<_Value> promise_data = std::atomic_exchange(&m_data->promise_data, prom_data_ptr<_Value>{}))
+			if (prom_data_ptr<_Value> promise_data = m_data->promise_data.exchange(nullptr))
 			{
 				value_or_promise_t<_Value> value{};
 				value.set_promise(std::move(promise_value));
@@ -246,7 +246,7 @@ namespace async
 	{
 		if (m_data)
 		{
-			if (prom_data_ptr<_Value> promise_data = std::atomic_exchange(&m_data->promise_data, prom_data_ptr<_Value>{}))
+			if (prom_data_ptr<_Value> promise_data = m_data->promise_data.exchange(nullptr))
 			{
 				value_or_promise_t<_Value> value{};
 				value.set_except(except);
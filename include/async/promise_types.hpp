@@ -11,8 +11,11 @@
 #include <optional>
 #include <exception>
 #include <functional>
+#include <memory_resource>
 
-#include <async\pool.hpp>
+#include <async/pool.hpp>
+#include <async/logger.hpp>
+#include <async/intrusive_ptr.hpp>
 
 
 namespace async
@@ -57,6 +60,15 @@ namespace async
 
 	using finally_t = std::function<void()>;
 
+	/** \brief Tag of the next step, which is executed by \a pool::exec_t::inline_exec (see \a promise::set_exec).
+	 */
+	struct inline_exec_t
+	{
+		explicit inline_exec_t() = default;
+	};
+
+	inline constexpr inline_exec_t inline_exec{};
+
 } // namespace async
 
 
@@ -91,9 +103,15 @@ namespace async::details
 		value_t<_Value> value = {};
 		
 		task_variant_t next_task_v;
+
+		pool::priority_t priority = pool::priority_t::normal; // Of the next steps, it is inherited by their promises
+
+		std::optional<pool::exec_t> exec = std::nullopt; // Of the next step only; if it is not set, see pool::continuations_exec
 	};
 
 
+	/** \brief Shared state of promise: one allocation from \a pool::memory_resource with the reference counter inside.
+	 */
 	template<class _Value>
 	struct prom_data_t
 	{
@@ -101,10 +119,56 @@ namespace async::details
 
 		result_t<_Value> result;
 
-		std::wstring log_ctx;
+		ASYNC_NO_UNIQUE_ADDRESS log_ctx_t log_ctx; // Empty with ASYNC_LIB_NO_LOGGING, it takes no memory
+
+		std::atomic<std::size_t> refs_count{ 1 };
+		std::pmr::memory_resource* resource{ nullptr }; // Of this allocation
 	};
 	template<class _Value>
-	using prom_data_ptr = std::shared_ptr<prom_data_t<_Value>>;
+	using prom_data_ptr = intrusive_ptr<prom_data_t<_Value>>;
+
+	template<class _Value>
+	inline void intrusive_ptr_add_ref(prom_data_t<_Value>* data) noexcept
+	{
+		data->refs_count.fetch_add(1, std::memory_order_relaxed);
+	}
+
+	template<class _Value>
+	inline void intrusive_ptr_release(prom_data_t<_Value>* data) noexcept
+	{
+		if (data->refs_count.fetch_sub(1, std::memory_order_acq_rel) == 1)
+		{
+			std::pmr::memory_resource* const resource{ data->resource };
+
+			data->~prom_data_t();
+			resource->deallocate(data, sizeof(prom_data_t<_Value>), alignof(prom_data_t<_Value>));
+		}
+	}
+
+	template<class _Value>
+	[[nodiscard]] inline prom_data_ptr<_Value> make_prom_data(pool_ptr pool, pool::priority_t priority)
+	{
+		std::pmr::memory_resource* const resource{ pool->memory_resource() };
+
+		void* const memory{ resource->allocate(sizeof(prom_data_t<_Value>), alignof(prom_data_t<_Value>)) };
+
+		prom_data_t<_Value>* data{ nullptr };
+		try
+		{
+			data = ::new (memory) prom_data_t<_Value>{};
+		}
+		catch (...)
+		{
+			resource->deallocate(memory, sizeof(prom_data_t<_Value>), alignof(prom_data_t<_Value>));
+			throw;
+		}
+
+		data->pool = std::move(pool);
+		data->result.priority = priority;
+		data->resource = resource;
+
+		return prom_data_ptr<_Value>::adopt(data);
+	}
 
 
 } // namespace async::details
@@ -0,0 +1,178 @@
+#pragma once
+
+
+#include <vector>
+#include <cassert>
+#include <cstdint>
+#include <cstddef>
+
+#if defined(_MSC_VER)
+#   include <intrin.h>
+#endif
+
+
+namespace async::details
+{
+	/** \brief Index of the lowest set bit of the non-zero word.
+	 */
+	inline std::size_t count_trailing_zeros(std::uint64_t word) noexcept
+	{
+		assert(word != 0);
+
+#if defined(_MSC_VER)
+		unsigned long index{ 0 };
+#   if defined(_M_X64) || defined(_M_ARM64)
+		_BitScanForward64(&index, word);
+#   else
+		if (_BitScanForward(&index, static_cast<unsigned long>(word)) == 0)
+		{
+			_BitScanForward(&index, static_cast<unsigned long>(word >> 32));
+			index += 32;
+		}
+#   endif
+		return static_cast<std::size_t>(index);
+#else
+		return static_cast<std::size_t>(__builtin_ctzll(word));
+#endif
+	}
+
+
+	/** \brief Bitset with the size defined at runtime, for the states of the threads of pool.
+	 *
+	 * \details The number of set bits is cached, so \a count, \a all and \a none do not walk the words.
+	 *          Searching of a bit walks the words (64 threads per word) and uses \a count_trailing_zeros inside the word.
+	 *          The bitset is not thread-safe: it is used under the mutex of pool.
+	 */
+	class threads_bitset
+	{
+	public:
+
+		static constexpr std::size_t npos{ static_cast<std::size_t>(-1) };
+
+	public:
+
+		threads_bitset() noexcept
+			: m_words{}
+			, m_size{ 0 }
+			, m_count{ 0 }
+		{}
+
+		threads_bitset(std::size_t size, bool value)
+			: m_words((size + word_bits - 1) / word_bits, (value ? ~std::uint64_t{ 0 } : std::uint64_t{ 0 }))
+			, m_size{ size }
+			, m_count{ value ? size : 0 }
+		{
+			if (value && (m_size % word_bits) != 0)
+				m_words.back() = (std::uint64_t{ 1 } << (m_size % word_bits)) - 1;
+		}
+
+	public:
+
+		[[nodiscard]] std::size_t size() const noexcept
+		{
+			return m_size;
+		}
+
+		[[nodiscard]] std::size_t count() const noexcept
+		{
+			return m_count;
+		}
+
+		[[nodiscard]] bool all() const noexcept
+		{
+			return (m_count == m_size);
+		}
+
+		[[nodiscard]] bool none() const noexcept
+		{
+			return (m_count == 0);
+		}
+
+		[[nodiscard]] bool test(std::size_t index) const noexcept
+		{
+			assert(index < m_size);
+			return ((m_words[index / word_bits] & bit_of(index)) != 0);
+		}
+
+		void set(std::size_t index) noexcept
+		{
+			assert(index < m_size);
+
+			std::uint64_t& word{ m_words[index / word_bits] };
+
+			if ((word & bit_of(index)) == 0)
+			{
+				word |= bit_of(index);
+				m_count += 1;
+			}
+		}
+
+		void reset(std::size_t index) noexcept
+		{
+			assert(index < m_size);
+
+			std::uint64_t& word{ m_words[index / word_bits] };
+
+			if ((word & bit_of(index)) != 0)
+			{
+				word &= ~bit_of(index);
+				m_count -= 1;
+			}
+		}
+
+		/** \brief Find the first bit with the value \a value.
+		 *
+		 * \return Index of the bit or \a threads_bitset::npos.
+		 */
+		[[nodiscard]] std::size_t find_first(bool value = true) const noexcept
+		{
+			return find_from(0, value);
+		}
+
+		/** \brief Find the next bit with the value \a value after the bit \a index.
+		 *
+		 * \return Index of the bit or \a threads_bitset::npos.
+		 */
+		[[nodiscard]] std::size_t find_next(std::size_t index, bool value = true) const noexcept
+		{
+			return find_from(index + 1, value);
+		}
+
+	private:
+
+		static std::uint64_t bit_of(std::size_t index) noexcept
+		{
+			return (std::uint64_t{ 1 } << (index % word_bits));
+		}
+
+		std::size_t find_from(std::size_t index, bool value) const noexcept
+		{
+			if ((value ? m_count : m_size - m_count) == 0)
+				return npos;
+
+			for (std::size_t word_index = index / word_bits; index < m_size; word_index += 1, index = word_index * word_bits)
+			{
+				std::uint64_t word{ value ? m_words[word_index] : ~m_words[word_index] };
+
+				word &= (~std::uint64_t{ 0 } << (index % word_bits)); // Skip the bits before index
+
+				if (word != 0)
+				{
+					const std::size_t result{ word_index * word_bits + count_trailing_zeros(word) };
+					return (result < m_size ? result : npos);
+				}
+			}
+
+			return npos;
+		}
+
+	private:
+
+		static constexpr std::size_t word_bits{ 64 };
+
+		std::vector<std::uint64_t> m_words;
+		std::size_t m_size;
+		std::size_t m_count;
+	};
+
+} // namespace async::details
@@ -0,0 +1,564 @@
+#pragma once
+
+
+#include <array>
+#include <mutex>
+#include <chrono>
+#include <memory>
+#include <thread>
+#include <vector>
+#include <cassert>
+#include <cstdint>
+#include <utility>
+#include <algorithm>
+#include <functional>
+#include <condition_variable>
+
+#include <async/pool.hpp>
+#include <async/logger.hpp>
+
+
+namespace async::details
+{
+	class timer_wheel;
+
+} // namespace async::details
+
+
+namespace async
+{
+
+	/** \brief Handle of the periodic task (see \a manager::every).
+	 *
+	 * \details The handle does not own the timer: the timer works until \a timer::cancel is called or the manager is destroyed.
+	 */
+	class timer
+	{
+	public:
+
+		timer() noexcept = default;
+
+	public:
+
+		/** \brief Stop the timer.
+		 *
+		 * \details The task which is already passed to the pool is not cancelled.
+		 *
+		 * \return If the timer was armed \a true, otherwise \a false.
+		 */
+		bool cancel();
+
+	private:
+
+		friend class details::timer_wheel;
+
+		timer(std::weak_ptr<details::timer_wheel> wheel, std::uint32_t index, std::uint32_t generation) noexcept
+			: m_wheel{ std::move(wheel) }
+			, m_index{ index }
+			, m_generation{ generation }
+		{}
+
+	private:
+
+		std::weak_ptr<details::timer_wheel> m_wheel;
+		std::uint32_t m_index{ 0 };
+		std::uint32_t m_generation{ 0 };
+	};
+
+} // namespace async
+
+
+namespace async::details
+{
+
+	/** \brief Hierarchical timing wheel, driven by one thread.
+	 *
+	 * \details The time is counted in ticks of \a timer_wheel::tick_duration. The wheel has \a levels_count levels
+	 *          of \a slots_count slots, every level is \a slots_count times coarser than the previous one; when the lower level
+	 *          makes a turn, the timers of the next slot of the upper level are spread over the lower levels (cascade).
+	 *          The timers farther than the wheel wait in the top level and are placed again at the cascade.
+	 *
+	 * \details The timers are the nodes of the doubly-linked lists of slots, the links are indexes in one vector of nodes
+	 *          (with the list of free nodes), so arming and cancelling is O(1) and does not allocate in the steady state.
+	 *
+	 * \details The expired tasks are collected under the mutex and are passed to the pool by \a pool::add_tasks,
+	 *          one batch per priority, after the mutex is released.
+	 */
+	class timer_wheel : public std::enable_shared_from_this<timer_wheel>
+	{
+	public:
+
+		using clock_t = std::chrono::steady_clock;
+		using tick_t = std::uint64_t;
+
+		static constexpr std::chrono::milliseconds tick_duration{ 1 };
+
+		static constexpr std::size_t slot_bits{ 6 };
+		static constexpr std::size_t slots_count{ std::size_t{ 1 } << slot_bits };
+		static constexpr std::size_t levels_count{ 4 };
+
+	private:
+
+		static constexpr std::uint32_t npos{ static_cast<std::uint32_t>(~0) };
+		static constexpr tick_t slot_mask{ slots_count - 1 };
+		static constexpr tick_t wheel_ticks_count{ tick_t{ 1 } << (slot_bits * levels_count) };
+
+		struct node_t
+		{
+			std::uint32_t prev;
+			std::uint32_t next;
+			std::uint32_t slot;       // Index in m_slots, npos if the node is free
+			std::uint32_t generation; // Is changed when the node is freed, so the old handles do not match
+
+			tick_t expires;
+			tick_t period;            // Zero for the one-shot timer
+
+			pool::priority_t priority;
+
+			pool::task_t task;                              // One-shot timer
+			std::function<void(pool::ctx_t)> periodic_task; // Periodic timer
+		};
+
+		using ready_tasks_t = std::array<pool::more_tasks_t, pool::priorities_count>;
+
+	public:
+
+		explicit timer_wheel(pool_ptr pool)
+			: m_pool{ std::move(pool) }
+			, m_start{ clock_t::now() }
+			, m_current_tick{ 0 }
+			, m_wait_tick{ 0 }
+			, m_armed_count{ 0 }
+			, m_free_head{ npos }
+			, m_stop{ false }
+		{
+			assert(m_pool);
+
+			m_slots.fill(npos);
+
+			m_thread = std::thread(&timer_wheel::thread_main, this);
+		}
+
+		~timer_wheel()
+		{
+			stop();
+		}
+
+		timer_wheel(timer_wheel&& other) = delete;
+		timer_wheel(const timer_wheel& other) = delete;
+
+		timer_wheel& operator=(timer_wheel&& other) = delete;
+		timer_wheel& operator=(const timer_wheel& other) = delete;
+
+	public:
+
+		/** \brief Pass the task to the pool at the time (or at once, if the time has passed).
+		 */
+		void arm(clock_t::time_point time, pool::task_t task, pool::priority_t priority)
+		{
+			assert(task);
+
+			const std::lock_guard<std::mutex> lk{ m_access };
+
+			if (m_stop)
+				return; // The task is dropped out of the mutex, as by stop
+
+			node_t& node{ m_nodes[arm_impl(time, tick_t{ 0 }, priority)] };
+			node.task = std::move(task);
+		}
+
+		/** \brief Pass the task to the pool every period, the first time in one period.
+		 *
+		 * \details The period is counted from the previous expiration (not from the completion of the task),
+		 *          so the tasks of one timer can be executed at the same time, if the task is longer than the period.
+		 *          The expirations missed by a busy timer thread are skipped.
+		 */
+		timer arm_periodic(clock_t::duration period, std::function<void(pool::ctx_t)> task, pool::priority_t priority)
+		{
+			assert(task);
+
+			const tick_t period_ticks{ std::max<tick_t>(1, static_cast<tick_t>(std::chrono::ceil<std::chrono::milliseconds>(period) / tick_duration)) };
+
+			const std::lock_guard<std::mutex> lk{ m_access };
+
+			if (m_stop)
+				return timer{};
+
+			const std::uint32_t index{ arm_impl(clock_t::now() + period, period_ticks, priority) };
+
+			node_t& node{ m_nodes[index] };
+			node.periodic_task = std::move(task);
+
+			return timer{ weak_from_this(), index, node.generation };
+		}
+
+		bool cancel(std::uint32_t index, std::uint32_t generation)
+		{
+			const std::lock_guard<std::mutex> lk{ m_access };
+
+			if (index >= m_nodes.size() || m_nodes[index].generation != generation || m_nodes[index].slot == npos)
+				return false;
+
+			unlink_node(index);
+			free_node(index);
+
+			return true;
+		}
+
+		std::size_t armed_count() const
+		{
+			const std::lock_guard<std::mutex> lk{ m_access };
+			return m_armed_count;
+		}
+
+		/** \brief Stop the thread of wheel and drop the armed timers.
+		 *
+		 * \details The tasks of the dropped timers are destroyed out of the mutex: so they can reject their promises
+		 *          (see \a details::armed_prom_data), whose next steps may arm the timers again.
+		 */
+		void stop()
+		{
+			{
+				const std::lock_guard<std::mutex> lk{ m_access };
+
+				if (m_stop)
+					return;
+
+				m_stop = true;
+				m_changed.notify_all();
+			}
+
+			if (m_thread.joinable())
+				m_thread.join();
+
+			std::vector<node_t> nodes;
+			{
+				const std::lock_guard<std::mutex> lk{ m_access };
+
+				nodes.swap(m_nodes);
+				m_slots.fill(npos);
+				m_free_head = npos;
+				m_armed_count = 0;
+			}
+
+			nodes.clear();
+		}
+
+	private:
+
+		tick_t tick_floor(clock_t::time_point time) const noexcept
+		{
+			return (time <= m_start) ? 0 : static_cast<tick_t>(std::chrono::floor<std::chrono::milliseconds>(time - m_start) / tick_duration);
+		}
+
+		tick_t tick_ceil(clock_t::time_point time) const noexcept
+		{
+			return (time <= m_start) ? 0 : static_cast<tick_t>(std::chrono::ceil<std::chrono::milliseconds>(time - m_start) / tick_duration);
+		}
+
+		clock_t::time_point time_of(tick_t tick) const noexcept
+		{
+			return m_start + tick * tick_duration;
+		}
+
+		std::uint32_t arm_impl(clock_t::time_point time, tick_t period, pool::priority_t priority)
+		{
+			// Invoke under mutex: m_access
+
+			if (m_armed_count == 0)
+				m_current_tick = std::max(m_current_tick, tick_floor(clock_t::now())); // The empty wheel does not need to catch up the time
+
+			const std::uint32_t index{ allocate_node() };
+
+			node_t& node{ m_nodes[index] };
+			node.expires = std::max(tick_ceil(time), m_current_tick + 1);
+			node.period = period;
+			node.priority = priority;
+
+			link_node(index);
+
+			if (node.expires < m_wait_tick || m_armed_count == 1)
+				m_changed.notify_one();
+
+			return index;
+		}
+
+		std::uint32_t allocate_node()
+		{
+			// Invoke under mutex: m_access
+
+			std::uint32_t index{ m_free_head };
+
+			if (index != npos)
+			{
+				m_free_head = m_nodes[index].next;
+			}
+			else
+			{
+				assert(m_nodes.size() < npos);
+
+				index = static_cast<std::uint32_t>(m_nodes.size());
+				m_nodes.push_back(node_t{ npos, npos, npos, 0, 0, 0, pool::priority_t::normal, nullptr, nullptr });
+			}
+
+			m_armed_count += 1;
+
+			return index;
+		}
+
+		void free_node(std::uint32_t index) noexcept
+		{
+			// Invoke under mutex: m_access
+
+			node_t& node{ m_nodes[index] };
+			assert(node.slot == npos);
+
+			node.task = nullptr;
+			node.periodic_task = nullptr;
+			node.generation += 1;
+			node.prev = npos;
+			node.next = m_free_head;
+
+			m_free_head = index;
+			m_armed_count -= 1;
+		}
+
+		void link_node(std::uint32_t index) noexcept
+		{
+			// Invoke under mutex: m_access
+
+			node_t& node{ m_nodes[index] };
+
+			const tick_t delta{ (node.expires > m_current_tick) ? (node.expires - m_current_tick) : 0 };
+
+			std::size_t level{ 0 };
+			while (level + 1 < levels_count && delta >= (tick_t{ 1 } << (slot_bits * (level + 1))))
+				level += 1;
+
+			// The timer farther than the wheel waits in the top level and is placed again at the cascade
+			const tick_t expires{ (delta < wheel_ticks_count) ? node.expires : (m_current_tick + wheel_ticks_count - 1) };
+
+			const std::uint32_t slot{ static_cast<std::uint32_t>(level * slots_count + ((expires >> (slot_bits * level)) & slot_mask)) };
+
+			node.slot = slot;
+			node.prev = npos;
+			node.next = m_slots[slot];
+
+			if (node.next != npos)
+				m_nodes[node.next].prev = index;
+
+			m_slots[slot] = index;
+		}
+
+		void unlink_node(std::uint32_t index) noexcept
+		{
+			// Invoke under mutex: m_access
+
+			node_t& node{ m_nodes[index] };
+			assert(node.slot != npos);
+
+			if (node.prev != npos)
+				m_nodes[node.prev].next = node.next;
+			else
+				m_slots[node.slot] = node.next;
+
+			if (node.next != npos)
+				m_nodes[node.next].prev = node.prev;
+
+			node.slot = npos;
+			node.prev = npos;
+			node.next = npos;
+		}
+
+		std::uint32_t detach_slot(std::size_t slot) noexcept
+		{
+			// Invoke under mutex: m_access
+
+			const std::uint32_t head{ m_slots[slot] };
+			m_slots[slot] = npos;
+
+			for (std::uint32_t index = head; index != npos; index = m_nodes[index].next)
+				m_nodes[index].slot = npos;
+
+			return head;
+		}
+
+		void cascade(std::size_t level, std::size_t slot_index) noexcept
+		{
+			// Invoke under mutex: m_access
+
+			for (std::uint32_t index = detach_slot(level * slots_count + slot_index); index != npos; )
+			{
+				const std::uint32_t next{ m_nodes[index].next };
+				link_node(index);
+				index = next;
+			}
+		}
+
+		void expire_slot(std::size_t slot_index, ready_tasks_t& ready_tasks)
+		{
+			// Invoke under mutex: m_access
+
+			for (std::uint32_t index = detach_slot(slot_index); index != npos; )
+			{
+				node_t& node{ m_nodes[index] };
+				const std::uint32_t next{ node.next };
+
+				assert(node.expires <= m_current_tick);
+
+				pool::more_tasks_t& priority_tasks{ ready_tasks[static_cast<std::size_t>(node.priority)] };
+
+				if (node.period == 0)
+				{
+					priority_tasks.push_back(std::move(node.task));
+					free_node(index);
+				}
+				else
+				{
+					priority_tasks.emplace_back(node.periodic_task);
+
+					node.expires += node.period;
+					if (node.expires <= m_current_tick)
+						node.expires = m_current_tick + node.period; // Skip the missed expirations
+
+					link_node(index);
+				}
+
+				index = next;
+			}
+		}
+
+		void advance(tick_t now_tick, ready_tasks_t& ready_tasks)
+		{
+			// Invoke under mutex: m_access
+
+			while (m_current_tick < now_tick)
+			{
+				m_current_tick += 1;
+
+				if ((m_current_tick & slot_mask) == 0)
+				{
+					for (std::size_t level = 1; level < levels_count; ++level)
+					{
+						const std::size_t slot_index{ static_cast<std::size_t>((m_current_tick >> (slot_bits * level)) & slot_mask) };
+
+						cascade(level, slot_index);
+
+						if (slot_index != 0)
+							break;
+					}
+				}
+
+				expire_slot(static_cast<std::size_t>(m_current_tick & slot_mask), ready_tasks);
+			}
+		}
+
+		tick_t next_wake_tick() const noexcept
+		{
+			// Invoke under mutex: m_access
+			// The next not empty slot of the lowest level, or the next cascade
+
+			const tick_t cascade_tick{ (m_current_tick | slot_mask) + 1 };
+
+			for (tick_t tick = m_current_tick + 1; tick < cascade_tick; ++tick)
+			{
+				if (m_slots[static_cast<std::size_t>(tick & slot_mask)] != npos)
+					return tick;
+			}
+
+			return cascade_tick;
+		}
+
+		void pass_ready_tasks(ready_tasks_t& ready_tasks) noexcept
+		{
+			for (std::size_t priority_index = 0; priority_index < ready_tasks.size(); ++priority_index)
+			{
+				pool::more_tasks_t& priority_tasks{ ready_tasks[priority_index] };
+
+				if (!priority_tasks.empty())
+				{
+					try
+					{
+						m_pool->add_tasks(pool::unknown_ctx, priority_tasks.data(), priority_tasks.size(), static_cast<pool::priority_t>(priority_index));
+					}
+					catch (...)
+					{
+						log_except(m_pool->log(), std::current_exception(), L"Passing the expired timers to the pool is failed"sv);
+					}
+
+					priority_tasks.clear();
+				}
+			}
+		}
+
+		void thread_main()
+		{
+			const log_scope log_scope_guard{ m_pool->log(), L"[timer-thread]"sv };
+
+			ready_tasks_t ready_tasks{};
+
+			std::unique_lock<std::mutex> un_lk{ m_access };
+
+			while (!m_stop)
+			{
+				if (m_armed_count == 0)
+				{
+					m_wait_tick = static_cast<tick_t>(~0);
+					m_changed.wait(un_lk);
+					continue;
+				}
+
+				const tick_t now_tick{ tick_floor(clock_t::now()) };
+
+				if (now_tick <= m_current_tick)
+				{
+					m_wait_tick = next_wake_tick();
+					m_changed.wait_until(un_lk, time_of(m_wait_tick));
+					continue;
+				}
+
+				advance(now_tick, ready_tasks);
+
+				un_lk.unlock();
+				pass_ready_tasks(ready_tasks);
+				un_lk.lock();
+			}
+		}
+
+	private:
+
+		pool_ptr m_pool;
+
+		const clock_t::time_point m_start;
+
+		mutable std::mutex m_access;
+		std::condition_variable m_changed;
+
+		tick_t m_current_tick; // All ticks up to this one are processed
+		tick_t m_wait_tick;    // The timer thread sleeps up to this tick
+
+		std::vector<node_t> m_nodes;
+		std::array<std::uint32_t, levels_count * slots_count> m_slots; // Heads of the lists
+		std::size_t m_armed_count;
+		std::uint32_t m_free_head;
+
+		bool m_stop;
+
+		std::thread m_thread;
+	};
+
+} // namespace async::details
+
+
+namespace async
+{
+
+	inline bool timer::cancel()
+	{
+		const std::shared_ptr<details::timer_wheel> wheel{ m_wheel.lock() };
+		m_wheel.reset();
+
+		return (wheel && wheel->cancel(m_index, m_generation));
+	}
+
+} // namespace async
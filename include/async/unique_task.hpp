@@ -0,0 +1,320 @@
+#pragma once
+
+
+#include <new>
+#include <memory>
+#include <cassert>
+#include <cstddef>
+#include <utility>
+#include <functional>
+#include <type_traits>
+#include <memory_resource>
+
+
+namespace async
+{
+	constexpr std::size_t unique_task_inline_size_default{ 128 - alignof(std::max_align_t) }; // sizeof(unique_task) == 128
+
+	template<class _Signature, std::size_t _InlineSize = unique_task_inline_size_default>
+	class unique_task;
+
+	namespace details
+	{
+		template<class _Type>
+		struct is_nullable_functor : std::bool_constant<std::is_pointer_v<_Type> || std::is_member_pointer_v<_Type>> {};
+
+		template<class _Signature>
+		struct is_nullable_functor<std::function<_Signature>> : std::true_type {};
+
+		template<class _Signature, std::size_t _InlineSize>
+		struct is_nullable_functor<unique_task<_Signature, _InlineSize>> : std::true_type {};
+
+	} // namespace details
+
+
+	/** \brief Move-only callable wrapper: the replacement of \a std::function for the tasks of pool.
+	 *
+	 * \details The functor is stored in the inline buffer if it fits and its move constructor does not throw,
+	 *          otherwise it is allocated on the heap. The moving of the wrapper never throws and never allocates.
+	 *
+	 * \details The constructor with \a std::allocator_arg takes the heap block from the memory resource
+	 *          (the functor is stored together with the pointer to the resource, to return the block there).
+	 *
+	 * \details There is no RTTI (no \a target_type / \a target) and no copying: the captures of the continuations
+	 *          (\a prom_data_ptr, user functors) are only moved from the place of creation to the thread of pool.
+	 */
+	template<class _Result, class... _Args, std::size_t _InlineSize>
+	class unique_task<_Result(_Args...), _InlineSize>
+	{
+		static_assert(_InlineSize >= sizeof(void*));
+
+	public:
+
+		unique_task() noexcept
+			: m_vtable{ nullptr }
+		{}
+
+		unique_task(std::nullptr_t) noexcept
+			: m_vtable{ nullptr }
+		{}
+
+		template<class _Functor,
+			class _FunctorT = std::decay_t<_Functor>,
+			class = std::enable_if_t<!std::is_same_v<_FunctorT, unique_task> && std::is_invocable_r_v<_Result, _FunctorT&, _Args...>>
+		>
+		unique_task(_Functor&& functor)
+			: m_vtable{ nullptr }
+		{
+			if constexpr (details::is_nullable_functor<_FunctorT>::value)
+			{
+				if (!functor)
+					return;
+			}
+
+			if constexpr (is_inline_v<_FunctorT>)
+			{
+				::new (static_cast<void*>(&m_storage)) _FunctorT(std::forward<_Functor>(functor));
+				m_vtable = &vtable_inline<_FunctorT>;
+			}
+			else
+			{
+				*reinterpret_cast<_FunctorT**>(&m_storage) = new _FunctorT(std::forward<_Functor>(functor));
+				m_vtable = &vtable_heap<_FunctorT>;
+			}
+		}
+
+		template<class _Functor,
+			class _FunctorT = std::decay_t<_Functor>,
+			class = std::enable_if_t<!std::is_same_v<_FunctorT, unique_task> && std::is_invocable_r_v<_Result, _FunctorT&, _Args...>>
+		>
+		unique_task(std::allocator_arg_t, std::pmr::memory_resource* resource, _Functor&& functor)
+			: m_vtable{ nullptr }
+		{
+			assert(resource);
+
+			if constexpr (details::is_nullable_functor<_FunctorT>::value)
+			{
+				if (!functor)
+					return;
+			}
+
+			if constexpr (is_inline_v<_FunctorT>)
+			{
+				::new (static_cast<void*>(&m_storage)) _FunctorT(std::forward<_Functor>(functor));
+				m_vtable = &vtable_inline<_FunctorT>;
+			}
+			else
+			{
+				using block_t = resource_block_t<_FunctorT>;
+
+				void* const memory{ resource->allocate(sizeof(block_t), alignof(block_t)) };
+
+				try
+				{
+					*reinterpret_cast<block_t**>(&m_storage) = ::new (memory) block_t{ resource, _FunctorT(std::forward<_Functor>(functor)) };
+				}
+				catch (...)
+				{
+					resource->deallocate(memory, sizeof(block_t), alignof(block_t));
+					throw;
+				}
+
+				m_vtable = &vtable_resource<_FunctorT>;
+			}
+		}
+
+		unique_task(unique_task&& other) noexcept
+			: m_vtable{ std::exchange(other.m_vtable, nullptr) }
+		{
+			if (m_vtable)
+				m_vtable->move(&other.m_storage, &m_storage);
+		}
+
+		unique_task(const unique_task& other) = delete;
+
+		~unique_task()
+		{
+			reset();
+		}
+
+		unique_task& operator=(unique_task&& other) noexcept
+		{
+			if (this != &other)
+			{
+				reset();
+
+				m_vtable = std::exchange(other.m_vtable, nullptr);
+
+				if (m_vtable)
+					m_vtable->move(&other.m_storage, &m_storage);
+			}
+
+			return *this;
+		}
+
+		unique_task& operator=(const unique_task& other) = delete;
+
+		unique_task& operator=(std::nullptr_t) noexcept
+		{
+			reset();
+			return *this;
+		}
+
+		template<class _Functor, class = std::enable_if_t<!std::is_same_v<std::decay_t<_Functor>, unique_task>>>
+		unique_task& operator=(_Functor&& functor)
+		{
+			unique_task(std::forward<_Functor>(functor)).swap(*this);
+			return *this;
+		}
+
+	public:
+
+		_Result operator()(_Args... args)
+		{
+			assert(m_vtable);
+			return m_vtable->invoke(&m_storage, std::forward<_Args>(args)...);
+		}
+
+		explicit operator bool() const noexcept
+		{
+			return (m_vtable != nullptr);
+		}
+
+		void swap(unique_task& other) noexcept
+		{
+			if (this != &other)
+			{
+				unique_task tmp{ std::move(other) };
+				other = std::move(*this);
+				*this = std::move(tmp);
+			}
+		}
+
+		void reset() noexcept
+		{
+			if (const vtable_t* const vtable = std::exchange(m_vtable, nullptr))
+				vtable->destroy(&m_storage);
+		}
+
+	private:
+
+		using storage_t = std::aligned_storage_t<_InlineSize, alignof(std::max_align_t)>;
+
+		struct vtable_t
+		{
+			_Result(*invoke)(storage_t* storage, _Args&&... args);
+			void(*move)(storage_t* from, storage_t* to) noexcept;
+			void(*destroy)(storage_t* storage) noexcept;
+		};
+
+		template<class _FunctorT>
+		static constexpr bool is_inline_v{
+			sizeof(_FunctorT) <= sizeof(storage_t) &&
+			alignof(storage_t) % alignof(_FunctorT) == 0 &&
+			std::is_nothrow_move_constructible_v<_FunctorT> };
+
+		template<class _FunctorT>
+		static _FunctorT& inline_functor(storage_t* storage) noexcept
+		{
+			return *std::launder(reinterpret_cast<_FunctorT*>(storage));
+		}
+
+		template<class _FunctorT>
+		static _FunctorT*& heap_functor(storage_t* storage) noexcept
+		{
+			return *reinterpret_cast<_FunctorT**>(storage);
+		}
+
+		template<class _FunctorT>
+		static inline const vtable_t vtable_inline{
+			[](storage_t* storage, _Args&&... args) -> _Result
+			{
+				return std::invoke(inline_functor<_FunctorT>(storage), std::forward<_Args>(args)...);
+			},
+			[](storage_t* from, storage_t* to) noexcept
+			{
+				_FunctorT& functor{ inline_functor<_FunctorT>(from) };
+				::new (static_cast<void*>(to)) _FunctorT(std::move(functor));
+				functor.~_FunctorT();
+			},
+			[](storage_t* storage) noexcept
+			{
+				inline_functor<_FunctorT>(storage).~_FunctorT();
+			}
+		};
+
+		template<class _FunctorT>
+		static inline const vtable_t vtable_heap{
+			[](storage_t* storage, _Args&&... args) -> _Result
+			{
+				return std::invoke(*heap_functor<_FunctorT>(storage), std::forward<_Args>(args)...);
+			},
+			[](storage_t* from, storage_t* to) noexcept
+			{
+				heap_functor<_FunctorT>(to) = std::exchange(heap_functor<_FunctorT>(from), nullptr);
+			},
+			[](storage_t* storage) noexcept
+			{
+				delete std::exchange(heap_functor<_FunctorT>(storage), nullptr);
+			}
+		};
+
+		template<class _FunctorT>
+		struct resource_block_t
+		{
+			std::pmr::memory_resource* resource;
+			_FunctorT functor;
+		};
+
+		template<class _FunctorT>
+		static resource_block_t<_FunctorT>*& resource_block(storage_t* storage) noexcept
+		{
+			return *reinterpret_cast<resource_block_t<_FunctorT>**>(storage);
+		}
+
+		template<class _FunctorT>
+		static inline const vtable_t vtable_resource{
+			[](storage_t* storage, _Args&&... args) -> _Result
+			{
+				return std::invoke(resource_block<_FunctorT>(storage)->functor, std::forward<_Args>(args)...);
+			},
+			[](storage_t* from, storage_t* to) noexcept
+			{
+				resource_block<_FunctorT>(to) = std::exchange(resource_block<_FunctorT>(from), nullptr);
+			},
+			[](storage_t* storage) noexcept
+			{
+				resource_block_t<_FunctorT>* const block{ std::exchange(resource_block<_FunctorT>(storage), nullptr) };
+				std::pmr::memory_resource* const resource{ block->resource };
+
+				block->~resource_block_t();
+				resource->deallocate(block, sizeof(resource_block_t<_FunctorT>), alignof(resource_block_t<_FunctorT>));
+			}
+		};
+
+	private:
+
+		storage_t m_storage;
+		const vtable_t* m_vtable;
+	};
+
+
+	template<class _Signature, std::size_t _InlineSize>
+	inline void swap(unique_task<_Signature, _InlineSize>& left, unique_task<_Signature, _InlineSize>& right) noexcept
+	{
+		left.swap(right);
+	}
+
+	template<class _Signature, std::size_t _InlineSize>
+	[[nodiscard]] inline bool operator==(const unique_task<_Signature, _InlineSize>& task, std::nullptr_t) noexcept
+	{
+		return !task;
+	}
+
+	template<class _Signature, std::size_t _InlineSize>
+	[[nodiscard]] inline bool operator!=(const unique_task<_Signature, _InlineSize>& task, std::nullptr_t) noexcept
+	{
+		return static_cast<bool>(task);
+	}
+
+} // namespace async
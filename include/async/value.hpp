@@ -56,7 +56,7 @@ namespace async
 		inline void set_except(std::exception_ptr except)
 		{
 			assert(!has_except());
-			m_store.emplace<index_store_except>(except);
+			m_store.template emplace<index_store_except>(except);
 		}
 
 		[[nodiscard]] inline std::exception_ptr get_except() const
@@ -74,7 +74,7 @@ namespace async
 		inline store_value_type& emplace_value(_Args&&... args)
 		{
 			assert(!is_established());
-			return m_store.emplace<index_store_value>(std::forward<_Args>(args)...);
+			return m_store.template emplace<index_store_value>(std::forward<_Args>(args)...);
 		}
 
 		inline void set_value(this_t&& other)
@@ -87,7 +87,7 @@ namespace async
 		inline void set_value(_Value2&& value2)
 		{
 			assert(!is_established());
-			m_store.emplace<index_store_value>(std::forward<_Value2>(value2));
+			m_store.template emplace<index_store_value>(std::forward<_Value2>(value2));
 		}
 
 		[[nodiscard]] inline store_value_type& get_value() &
@@ -136,14 +136,14 @@ namespace async
 
 		friend class value_base_t<_Value, true>;
 
-		template<class _Value, class other_store_t = typename value_base_t<_Value, false>::store_t>
-		[[nodiscard]] static other_store_t& other_store(value_base_t<_Value, false>& other) noexcept
+		template<class _Other, class other_store_t = typename value_base_t<_Other, false>::store_t>
+		[[nodiscard]] static other_store_t& other_store(value_base_t<_Other, false>& other) noexcept
 		{
 			return other.m_store;
 		}
 
-		template<class _Value, class other_store_t = typename value_base_t<_Value, false>::store_t>
-		[[nodiscard]] static other_store_t&& other_store(value_base_t<_Value, false>&& other) noexcept
+		template<class _Other, class other_store_t = typename value_base_t<_Other, false>::store_t>
+		[[nodiscard]] static other_store_t&& other_store(value_base_t<_Other, false>&& other) noexcept
 		{
 			return std::move(other.m_store);
 		}
@@ -2,8 +2,8 @@
 #pragma once
 
 
-#include <async\value.hpp>
-#include <async\promise.hpp>
+#include <async/value.hpp>
+#include <async/promise.hpp>
 
 
 namespace async
@@ -20,7 +20,7 @@ namespace async
 		static_assert(base_t::index_store_value == base_t::index_store_empty + 1);
 		static_assert(this_t::index_store_promise == base_t::index_store_value + 1);
 		static_assert(base_t::index_store_except == this_t::index_store_promise + 1);
-		static_assert(std::variant_size_v<base_t::store_t> == 4);
+		static_assert(std::variant_size_v<typename base_t::store_t> == 4);
 
 	public:
 
@@ -28,28 +28,28 @@ namespace async
 
 		inline void set_value(value_t<_Value>&& val_value)
 		{
-			assert(!is_established());
+			assert(!this->is_established());
 
 			if (val_value.has_value())
-				store().emplace<index_store_value>(std::get<value_t<_Value>::index_store_value>(other_store(std::move(val_value))));
+				this->store().template emplace<base_t::index_store_value>(std::get<value_t<_Value>::index_store_value>(base_t::other_store(std::move(val_value))));
 			else if (val_value.has_except())
-				store().emplace<index_store_except>(std::get<value_t<_Value>::index_store_except>(other_store(std::move(val_value))));
+				this->store().template emplace<base_t::index_store_except>(std::get<value_t<_Value>::index_store_except>(base_t::other_store(std::move(val_value))));
 			else
-				store().emplace<index_store_empty>();
+				this->store().template emplace<base_t::index_store_empty>();
 		}
 
 		inline value_t<_Value> take_value_t()
 		{
-			assert(is_established() && !has_promise());
+			assert(this->is_established() && !this->has_promise());
 
 			value_t<_Value> result{};
 
-			if (has_value())
-				other_store(result).emplace<value_t<_Value>::index_store_value>(std::get<index_store_value>(std::move(*this).store()));
-			else if (has_except())
-				other_store(result).emplace<value_t<_Value>::index_store_except>(std::get<index_store_except>(std::move(*this).store()));
+			if (this->has_value())
+				base_t::other_store(result).template emplace<value_t<_Value>::index_store_value>(std::get<base_t::index_store_value>(std::move(*this).store()));
+			else if (this->has_except())
+				base_t::other_store(result).template emplace<value_t<_Value>::index_store_except>(std::get<base_t::index_store_except>(std::move(*this).store()));
 			else
-				other_store(result).emplace<value_t<_Value>::index_store_empty>(std::get<index_store_empty>(std::move(*this).store()));
+				base_t::other_store(result).template emplace<value_t<_Value>::index_store_empty>(std::get<base_t::index_store_empty>(std::move(*this).store()));
 
 			return result;
 		}
@@ -58,45 +58,45 @@ namespace async
 
 		inline bool has_promise() const noexcept
 		{
-			return (index_store_promise == store().index());
+			return (index_store_promise == this->store().index());
 		}
 
 		inline void set_promise(promise<_Value>&& promise_value)
 		{
-			assert(!is_established());
-			store().emplace<index_store_promise>(std::move(promise_value));
+			assert(!this->is_established());
+			this->store().template emplace<index_store_promise>(std::move(promise_value));
 		}
 
 		[[nodiscard]] inline promise<_Value>& get_promise() &
 		{
-			if (index_store_promise != store().index())
-				rethrow_except();
+			if (index_store_promise != this->store().index())
+				this->rethrow_except();
 			
-			return std::get<index_store_promise>(store());
+			return std::get<index_store_promise>(this->store());
 		}
 
 		[[nodiscard]] inline promise<_Value>&& get_promise() &&
 		{
-			if (index_store_promise != store().index())
-				rethrow_except();
+			if (index_store_promise != this->store().index())
+				this->rethrow_except();
 			
-			return std::get<index_store_promise>(std::move(store()));
+			return std::get<index_store_promise>(std::move(this->store()));
 		}
 
 		[[nodiscard]] inline const promise<_Value>& get_promise() const &
 		{
-			if (index_store_promise != store().index())
-				rethrow_except();
+			if (index_store_promise != this->store().index())
+				this->rethrow_except();
 			
-			return std::get<index_store_promise>(store());
+			return std::get<index_store_promise>(this->store());
 		}
 
 		[[nodiscard]] inline const promise<_Value>&& get_promise() const &&
 		{
-			if (index_store_promise != store().index())
-				rethrow_except();
+			if (index_store_promise != this->store().index())
+				this->rethrow_except();
 			
-			return std::get<index_store_promise>(std::move(store()));
+			return std::get<index_store_promise>(std::move(this->store()));
 		}
 	};
 
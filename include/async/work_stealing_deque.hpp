@@ -0,0 +1,183 @@
+#pragma once
+
+
+#include <atomic>
+#include <memory>
+#include <vector>
+#include <cassert>
+#include <cstdint>
+#include <type_traits>
+
+
+namespace async::details
+{
+	/** \brief Chase-Lev work-stealing deque.
+	 *
+	 * \details Memory orders follow "Correct and Efficient Work-Stealing for Weak Memory Models" (Le, Pop, Cohen, Zappa Nardelli).
+	 *          \a push and \a pop are called only by the owner thread (LIFO end), \a steal by any thread (FIFO end).
+	 *          The buffer grows on demand; retired buffers are kept until the deque is destroyed, because a thief may still read them.
+	 */
+	template<class _Item>
+	class work_stealing_deque
+	{
+		static_assert(std::is_trivially_copyable_v<_Item>);
+
+	public:
+
+		explicit work_stealing_deque(std::size_t capacity = capacity_default)
+			: m_top{ 0 }
+			, m_bottom{ 0 }
+			, m_buffer{ nullptr }
+			, m_buffers{}
+		{
+			std::size_t capacity_pow2{ capacity_min };
+			while (capacity_pow2 < capacity)
+				capacity_pow2 <<= 1;
+
+			m_buffers.push_back(std::make_unique<buffer_t>(capacity_pow2));
+			m_buffer.store(m_buffers.back().get(), std::memory_order_relaxed);
+		}
+
+		work_stealing_deque(work_stealing_deque&& other) = delete;
+		work_stealing_deque(const work_stealing_deque& other) = delete;
+
+		work_stealing_deque& operator=(work_stealing_deque&& other) = delete;
+		work_stealing_deque& operator=(const work_stealing_deque& other) = delete;
+
+	public:
+
+		void push(_Item item)
+		{
+			// Invoke only from the owner thread
+
+			const std::int64_t bottom{ m_bottom.load(std::memory_order_relaxed) };
+			const std::int64_t top{ m_top.load(std::memory_order_acquire) };
+
+			buffer_t* buffer{ m_buffer.load(std::memory_order_relaxed) };
+
+			if (bottom - top > static_cast<std::int64_t>(buffer->mask))
+				buffer = grow(buffer, top, bottom);
+
+			buffer->store(bottom, item);
+
+			m_bottom.store(bottom + 1, std::memory_order_release);
+		}
+
+		[[nodiscard]] bool pop(_Item& item) noexcept
+		{
+			// Invoke only from the owner thread
+
+			const std::int64_t bottom{ m_bottom.load(std::memory_order_relaxed) - 1 };
+			buffer_t* const buffer{ m_buffer.load(std::memory_order_relaxed) };
+			m_bottom.store(bottom, std::memory_order_relaxed);
+
+			std::atomic_thread_fence(std::memory_order_seq_cst);
+
+			std::int64_t top{ m_top.load(std::memory_order_relaxed) };
+
+			if (top > bottom)
+			{
+				// Empty
+				m_bottom.store(bottom + 1, std::memory_order_relaxed);
+				return false;
+			}
+
+			item = buffer->load(bottom);
+
+			if (top == bottom)
+			{
+				// The last item: race with thieves
+				const bool won{ m_top.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed) };
+				m_bottom.store(bottom + 1, std::memory_order_relaxed);
+				return won;
+			}
+
+			return true;
+		}
+
+		[[nodiscard]] bool steal(_Item& item) noexcept
+		{
+			std::int64_t top{ m_top.load(std::memory_order_acquire) };
+
+			std::atomic_thread_fence(std::memory_order_seq_cst);
+
+			const std::int64_t bottom{ m_bottom.load(std::memory_order_acquire) };
+
+			if (top >= bottom)
+				return false;
+
+			const buffer_t* const buffer{ m_buffer.load(std::memory_order_acquire) };
+			const _Item result{ buffer->load(top) };
+
+			if (!m_top.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed))
+				return false; // Lost the race with the owner or other thief
+
+			item = result;
+			return true;
+		}
+
+		[[nodiscard]] std::size_t size_approx() const noexcept
+		{
+			const std::int64_t bottom{ m_bottom.load(std::memory_order_relaxed) };
+			const std::int64_t top{ m_top.load(std::memory_order_relaxed) };
+
+			return (bottom > top ? static_cast<std::size_t>(bottom - top) : 0);
+		}
+
+		[[nodiscard]] bool empty_approx() const noexcept
+		{
+			return (size_approx() == 0);
+		}
+
+	private:
+
+		struct buffer_t
+		{
+			explicit buffer_t(std::size_t capacity)
+				: mask{ capacity - 1 }
+				, items{ std::make_unique<std::atomic<_Item>[]>(capacity) }
+			{
+				assert(capacity > 0 && (capacity & mask) == 0);
+			}
+
+			_Item load(std::int64_t index) const noexcept
+			{
+				return items[static_cast<std::size_t>(index) & mask].load(std::memory_order_relaxed);
+			}
+
+			void store(std::int64_t index, _Item item) noexcept
+			{
+				items[static_cast<std::size_t>(index) & mask].store(item, std::memory_order_relaxed);
+			}
+
+			const std::size_t mask;
+			const std::unique_ptr<std::atomic<_Item>[]> items;
+		};
+
+		buffer_t* grow(buffer_t* old_buffer, std::int64_t top, std::int64_t bottom)
+		{
+			m_buffers.push_back(std::make_unique<buffer_t>(2 * (old_buffer->mask + 1)));
+
+			buffer_t* const new_buffer{ m_buffers.back().get() };
+
+			for (std::int64_t index = top; index < bottom; ++index)
+				new_buffer->store(index, old_buffer->load(index));
+
+			m_buffer.store(new_buffer, std::memory_order_release);
+
+			return new_buffer;
+		}
+
+	private:
+
+		static constexpr std::size_t capacity_min{ 32 };
+		static constexpr std::size_t capacity_default{ 256 };
+
+		alignas(64) std::atomic<std::int64_t> m_top;
+		alignas(64) std::atomic<std::int64_t> m_bottom;
+		alignas(64) std::atomic<buffer_t*>    m_buffer;
+
+		std::vector<std::unique_ptr<buffer_t>> m_buffers; // Owner only
+	};
+
+} // namespace async::details
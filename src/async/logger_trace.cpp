@@ -0,0 +1,6 @@
+#include <async/config.hpp>
+#include <async/logger_trace.hpp>
+
+#ifndef ASYNC_LIB_HEADERS_ONLY
+#   include <async/logger_trace_impl.hpp>
+#endif
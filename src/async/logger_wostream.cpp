@@ -1,7 +1,7 @@
 
-#include <async\config.hpp>
-#include <async\logger_wostream.hpp>
+#include <async/config.hpp>
+#include <async/logger_wostream.hpp>
 
 #ifndef ASYNC_LIB_HEADERS_ONLY
-#   include <async\logger_wostream_impl.hpp>
+#   include <async/logger_wostream_impl.hpp>
 #endif
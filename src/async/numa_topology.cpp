@@ -0,0 +1,6 @@
+#include <async/config.hpp>
+#include <async/numa_topology.hpp>
+
+#ifndef ASYNC_LIB_HEADERS_ONLY
+#   include <async/numa_topology_impl.hpp>
+#endif
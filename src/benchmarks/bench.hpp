@@ -0,0 +1,99 @@
+//
+// bench.hpp
+// Common parts of the benchmarks: the options, the rows of the results and the statistics.
+//
+
+#pragma once
+
+#include <chrono>
+#include <string>
+#include <thread>
+#include <vector>
+#include <cstdint>
+#include <algorithm>
+
+
+namespace bench
+{
+    using clock_t = std::chrono::steady_clock;
+
+    struct options_t
+    {
+        bool json{ false };
+        bool pools{ true };
+        bool promises{ true };
+        bool loggers{ true };
+        bool memory{ true };
+        bool compare{ true };
+        std::size_t max_threads{ std::max<std::size_t>(1, std::thread::hardware_concurrency()) };
+        std::size_t tasks{ 1'000'000 };
+        std::size_t rounds{ 1'000 };
+        std::size_t depth{ 1'000 };
+        std::size_t iterations{ 100'000 };
+        std::size_t population{ 1'000'000 };
+        std::size_t repeats{ 5 };
+    };
+
+    /** \brief One row of the results: the benchmark of the subject (e.g. the pool) with the number of threads.
+     */
+    struct result_t
+    {
+        std::string suite;
+        std::string subject;
+        std::size_t threads;
+        std::string benchmark;
+        std::size_t samples;
+        double value;
+        const char* unit;
+    };
+
+    /** \brief Number of the allocations by the global operator new (see main.cpp) from the start of the program.
+     */
+    std::uint64_t allocations_count() noexcept;
+
+    /** \brief Number of the bytes allocated by the global operator new from the start of the program (the freed bytes are not subtracted).
+     */
+    std::uint64_t allocated_bytes() noexcept;
+
+    void run_pools(const options_t& options, std::vector<result_t>& results);
+
+    void run_promises(const options_t& options, std::vector<result_t>& results);
+
+    void run_loggers(const options_t& options, std::vector<result_t>& results);
+
+    void run_memory(const options_t& options, std::vector<result_t>& results);
+
+    void run_compare(const options_t& options, std::vector<result_t>& results);
+
+
+    inline double seconds_since(clock_t::time_point start) noexcept
+    {
+        return std::chrono::duration<double>(clock_t::now() - start).count();
+    }
+
+    inline double percentile(const std::vector<double>& sorted, double part) noexcept
+    {
+        if (sorted.empty())
+            return 0;
+
+        const std::size_t index{ static_cast<std::size_t>(part * static_cast<double>(sorted.size() - 1) + 0.5) };
+        return sorted[std::min(index, sorted.size() - 1)];
+    }
+
+    /** \brief Rows "<benchmark>_p50", "<benchmark>_p99" and "<benchmark>_p99.9" of the samples.
+     */
+    inline void add_percentiles(std::vector<result_t>& results, const result_t& head, std::vector<double> samples)
+    {
+        std::sort(samples.begin(), samples.end());
+
+        for (const auto& [suffix, part] : { std::make_pair("_p50", 0.50), std::make_pair("_p99", 0.99), std::make_pair("_p99.9", 0.999) })
+        {
+            result_t result{ head };
+            result.benchmark += suffix;
+            result.samples = samples.size();
+            result.value = percentile(samples, part);
+            results.push_back(std::move(result));
+        }
+    }
+
+} // namespace bench
@@ -0,0 +1,45 @@
+//
+// bench_promise.hpp
+// Common parts of the benchmarks of the promises.
+//
+
+#pragma once
+
+#include <async.hpp>
+
+#include <utility>
+
+
+namespace bench
+{
+    /** \brief Logger, which drops everything: the cost of the contexts of log without the cost of the output.
+     */
+    class null_logger : public async::logger
+    {
+    public:
+
+        virtual void message(std::wstring_view) noexcept override {}
+
+        virtual void exception(std::exception_ptr, std::wstring_view) noexcept override {}
+
+        virtual void enter_to_scope(std::wstring_view) noexcept override {}
+
+        virtual void leave_scope(std::wstring_view) noexcept override {}
+    };
+
+    /** \brief The promise, which is resolved by the returned send (as by the code out of the library).
+     */
+    template<class _Value>
+    std::pair<async::promise<_Value>, typename async::promise<_Value>::send> pending_promise(async::manager& manager)
+    {
+        typename async::promise<_Value>::send sender{};
+
+        async::promise<_Value> prom{ manager.task_here_and_now<_Value>(L"pending", [&sender](typename async::promise<_Value>::send async_send)
+        {
+            sender = std::move(async_send);
+        }) };
+
+        return { std::move(prom), std::move(sender) };
+    }
+
+} // namespace bench
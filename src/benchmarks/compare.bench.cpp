@@ -0,0 +1,523 @@
+//
+// compare.bench.cpp
+// The same workloads by async::manager (the pool always), by std::async/std::future and by the minimal pool
+// (one queue under the mutex with the condition variable), --threads threads, --repeats runs of every workload:
+//   - fan_out_in:  the tasks are started at once, their results are summed, when all of them are ready
+//   - pipeline:    every item goes through the stages one by one, the items go in parallel
+//   - fib:         the recursive fork/join (fibonacci), the sequential one under the cutoff
+//   - ping_pong:   the chain of the tasks, where every task starts the next one
+//
+// The rows are the medians (ms) and the ratios to the minimal pool ("<workload>_vs_raw"), the summary table
+// is written to stderr.
+//
+
+#include "bench.hpp"
+
+#include <async.hpp>
+
+#include <deque>
+#include <mutex>
+#include <atomic>
+#include <cstdio>
+#include <future>
+#include <memory>
+#include <vector>
+#include <functional>
+#include <condition_variable>
+
+
+using namespace std::literals::string_literals;
+
+
+namespace
+{
+    constexpr int fan_out_count{ 1'000 };
+    constexpr int pipeline_items{ 64 };
+    constexpr int pipeline_stages{ 8 };
+    constexpr int fib_number{ 24 };
+    constexpr int fib_cutoff{ 14 };
+    constexpr int ping_pong_rounds{ 10'000 };
+    constexpr int work_iterations{ 1'000 };
+
+    /** \brief The work of the task: the result depends only on the seed.
+     */
+    int work(int seed) noexcept
+    {
+        std::uint32_t value{ static_cast<std::uint32_t>(seed) };
+
+        for (int iteration = 0; iteration < work_iterations; ++iteration)
+            value = value * 1'664'525u + 1'013'904'223u;
+
+        return static_cast<int>(value >> 24);
+    }
+
+    int stage(int value, int stage_index) noexcept
+    {
+        return value + (work(value + stage_index) & 0xF);
+    }
+
+    int fib_sequential(int number) noexcept
+    {
+        return (number < 2) ? number : (fib_sequential(number - 1) + fib_sequential(number - 2));
+    }
+
+    /** \brief The minimal pool: one queue under the mutex, the threads wait on the condition variable.
+     */
+    class raw_pool
+    {
+    public:
+
+        explicit raw_pool(std::size_t threads_count)
+        {
+            for (std::size_t index = 0; index < threads_count; ++index)
+                m_threads.emplace_back([this] { work_loop(); });
+        }
+
+        ~raw_pool()
+        {
+            {
+                const std::lock_guard lock{ m_mutex };
+                m_stop = true;
+            }
+            m_has_tasks.notify_all();
+
+            for (std::thread& thread : m_threads)
+                thread.join();
+        }
+
+        void post(std::function<void()> task)
+        {
+            {
+                const std::lock_guard lock{ m_mutex };
+                m_tasks.push_back(std::move(task));
+            }
+            m_has_tasks.notify_one();
+        }
+
+        void wait()
+        {
+            std::unique_lock lock{ m_mutex };
+            m_idle.wait(lock, [this] { return m_tasks.empty() && m_running == 0; });
+        }
+
+    private:
+
+        void work_loop()
+        {
+            std::unique_lock lock{ m_mutex };
+
+            for (;;)
+            {
+                m_has_tasks.wait(lock, [this] { return m_stop || !m_tasks.empty(); });
+
+                if (m_tasks.empty())
+                    return;
+
+                std::function<void()> task{ std::move(m_tasks.front()) };
+                m_tasks.pop_front();
+                m_running += 1;
+
+                lock.unlock();
+                task();
+                lock.lock();
+
+                m_running -= 1;
+
+                if (m_tasks.empty() && m_running == 0)
+                    m_idle.notify_all();
+            }
+        }
+
+    private:
+
+        std::mutex m_mutex;
+        std::condition_variable m_has_tasks;
+        std::condition_variable m_idle;
+        std::deque<std::function<void()>> m_tasks;
+        std::size_t m_running{ 0 };
+        bool m_stop{ false };
+        std::vector<std::thread> m_threads;
+    };
+
+
+    // async::manager
+
+    long long manager_fan_out_in(async::manager& manager)
+    {
+        std::vector<async::promise<int>> promises{};
+        promises.reserve(fan_out_count);
+
+        for (int index = 0; index < fan_out_count; ++index)
+            promises.push_back(manager.task<int>(L"item"s, [index] { return work(index); }));
+
+        std::atomic<long long> sum{ 0 };
+
+        manager.all(L"all"s, std::move(promises)).success<void>([&sum](std::vector<int> values)
+        {
+            long long values_sum{ 0 };
+            for (int value : values)
+                values_sum += value;
+
+            sum = values_sum;
+        });
+
+        manager.wait_tasks_complete();
+        return sum.load();
+    }
+
+    long long manager_pipeline(async::manager& manager)
+    {
+        std::atomic<long long> sum{ 0 };
+
+        for (int item = 0; item < pipeline_items; ++item)
+        {
+            async::promise<int> prom{ manager.task<int>(L"item"s, [item] { return stage(item, 0); }) };
+
+            for (int stage_index = 1; stage_index < pipeline_stages; ++stage_index)
+                prom = prom.success<int>([stage_index](int value) { return stage(value, stage_index); });
+
+            prom.success<void>([&sum](int value) { sum += value; });
+        }
+
+        manager.wait_tasks_complete();
+        return sum.load();
+    }
+
+    struct manager_fib_t
+    {
+        async::manager* manager;
+
+        async::promise<int> operator()(int number) const
+        {
+            if (number < fib_cutoff)
+                return manager->resolve(L"fib"s, fib_sequential(number));
+
+            const manager_fib_t fib{ *this };
+
+            return manager->all(L"fib"s,
+                    manager->task<int>(L"fib"s, [fib, number] { return fib(number - 1); }),
+                    manager->task<int>(L"fib"s, [fib, number] { return fib(number - 2); }))
+                .success<int>([](std::tuple<int, int> values) { return std::get<0>(values) + std::get<1>(values); });
+        }
+    };
+
+    long long manager_fib(async::manager& manager)
+    {
+        std::atomic<long long> result{ 0 };
+
+        manager_fib_t{ &manager }(fib_number).success<void>([&result](int value) { result = value; });
+
+        manager.wait_tasks_complete();
+        return result.load();
+    }
+
+    struct manager_ping_t
+    {
+        async::manager* manager;
+        std::atomic<int>* count;
+
+        void operator()() const
+        {
+            if (count->fetch_add(1) + 1 < ping_pong_rounds)
+                manager->task(L"ping"s, manager_ping_t{ *this });
+        }
+    };
+
+    long long manager_ping_pong(async::manager& manager)
+    {
+        std::atomic<int> count{ 0 };
+
+        manager.task(L"ping"s, manager_ping_t{ &manager, &count });
+
+        manager.wait_tasks_complete();
+        return count.load();
+    }
+
+
+    // std::async / std::future
+
+    long long std_fan_out_in()
+    {
+        std::vector<std::future<int>> futures{};
+        futures.reserve(fan_out_count);
+
+        for (int index = 0; index < fan_out_count; ++index)
+            futures.push_back(std::async(std::launch::async, [index] { return work(index); }));
+
+        long long sum{ 0 };
+        for (std::future<int>& future : futures)
+            sum += future.get();
+
+        return sum;
+    }
+
+    long long std_pipeline()
+    {
+        std::vector<std::future<int>> futures{};
+        futures.reserve(pipeline_items);
+
+        for (int item = 0; item < pipeline_items; ++item)
+            futures.push_back(std::async(std::launch::async, [item] { return stage(item, 0); }));
+
+        for (int stage_index = 1; stage_index < pipeline_stages; ++stage_index)
+        {
+            for (std::future<int>& future : futures)
+            {
+                future = std::async(std::launch::async, [stage_index, previous = std::move(future)]() mutable
+                {
+                    return stage(previous.get(), stage_index);
+                });
+            }
+        }
+
+        long long sum{ 0 };
+        for (std::future<int>& future : futures)
+            sum += future.get();
+
+        return sum;
+    }
+
+    int std_fib(int number)
+    {
+        if (number < fib_cutoff)
+            return fib_sequential(number);
+
+        std::future<int> left{ std::async(std::launch::async, std_fib, number - 1) };
+        const int right{ std_fib(number - 2) };
+
+        return left.get() + right;
+    }
+
+    long long std_ping_pong()
+    {
+        // Two threads pass the turn to each other by the promises
+        std::vector<std::promise<void>> turns(ping_pong_rounds);
+
+        const auto player = [&turns](int first_turn)
+        {
+            for (int turn = first_turn; turn < ping_pong_rounds; turn += 2)
+            {
+                if (turn > 0)
+                    turns[turn - 1].get_future().wait();
+
+                turns[turn].set_value();
+            }
+        };
+
+        std::future<void> ping{ std::async(std::launch::async, player, 0) };
+        std::future<void> pong{ std::async(std::launch::async, player, 1) };
+
+        ping.get();
+        pong.get();
+
+        return ping_pong_rounds;
+    }
+
+
+    // The minimal pool
+
+    long long raw_fan_out_in(raw_pool& pool)
+    {
+        std::atomic<long long> sum{ 0 };
+
+        for (int index = 0; index < fan_out_count; ++index)
+            pool.post([&sum, index] { sum += work(index); });
+
+        pool.wait();
+        return sum.load();
+    }
+
+    long long raw_pipeline(raw_pool& pool)
+    {
+        struct step_t
+        {
+            raw_pool* pool;
+            std::atomic<long long>* sum;
+            int value;
+            int stage_index;
+
+            void operator()() const
+            {
+                const int next_value{ stage(value, stage_index) };
+
+                if (stage_index + 1 < pipeline_stages)
+                    pool->post(step_t{ pool, sum, next_value, stage_index + 1 });
+                else
+                    *sum += next_value;
+            }
+        };
+
+        std::atomic<long long> sum{ 0 };
+
+        for (int item = 0; item < pipeline_items; ++item)
+            pool.post(step_t{ &pool, &sum, item, 0 });
+
+        pool.wait();
+        return sum.load();
+    }
+
+    long long raw_fib(raw_pool& pool)
+    {
+        // The join is the counter of the node: the last finished child passes the sum to the parent
+        struct node_t
+        {
+            node_t* parent;
+            std::atomic<int> pending;
+            std::atomic<long long> sum;
+        };
+
+        struct fib_t
+        {
+            raw_pool* pool;
+            node_t* parent;
+            int number;
+
+            static void complete(node_t* node, long long value)
+            {
+                while (node)
+                {
+                    node->sum += value;
+
+                    if (node->pending.fetch_sub(1) != 1)
+                        return;
+
+                    value = node->sum.load();
+                    node_t* const parent{ node->parent };
+
+                    if (!parent)
+                        return; // The root is kept by raw_fib
+
+                    delete node;
+                    node = parent;
+                }
+            }
+
+            void operator()() const
+            {
+                if (number < fib_cutoff)
+                {
+                    complete(parent, fib_sequential(number));
+                    return;
+                }
+
+                node_t* const node{ new node_t{ parent, { 2 }, { 0 } } };
+
+                pool->post(fib_t{ pool, node, number - 1 });
+                pool->post(fib_t{ pool, node, number - 2 });
+            }
+        };
+
+        node_t root{ nullptr, { 1 }, { 0 } };
+
+        pool.post(fib_t{ &pool, &root, fib_number });
+
+        pool.wait();
+        return root.sum.load();
+    }
+
+    long long raw_ping_pong(raw_pool& pool)
+    {
+        struct ping_t
+        {
+            raw_pool* pool;
+            std::atomic<int>* count;
+
+            void operator()() const
+            {
+                if (count->fetch_add(1) + 1 < ping_pong_rounds)
+                    pool->post(ping_t{ *this });
+            }
+        };
+
+        std::atomic<int> count{ 0 };
+
+        pool.post(ping_t{ &pool, &count });
+
+        pool.wait();
+        return count.load();
+    }
+
+
+    struct workload_t
+    {
+        std::string name;
+        std::function<long long()> by_manager;
+        std::function<long long()> by_std_async;
+        std::function<long long()> by_raw_pool;
+    };
+
+    /** \brief Median of the times of the runs (ms); the results of the runs are checked against the expected one.
+     */
+    double median_ms(const std::string& name, const std::function<long long()>& run, std::size_t repeats, long long expected)
+    {
+        std::vector<double> times{};
+        times.reserve(repeats);
+
+        for (std::size_t repeat = 0; repeat < repeats; ++repeat)
+        {
+            const bench::clock_t::time_point start{ bench::clock_t::now() };
+            const long long result{ run() };
+            times.push_back(bench::seconds_since(start) * 1000);
+
+            if (result != expected)
+                std::fprintf(stderr, "compare: %s returned %lld instead of %lld\n", name.c_str(), result, expected);
+        }
+
+        std::sort(times.begin(), times.end());
+        return bench::percentile(times, 0.5);
+    }
+
+} // namespace
+
+
+void bench::run_compare(const options_t& options, std::vector<result_t>& results)
+{
+    const std::size_t threads_count{ options.max_threads };
+
+    std::fprintf(stderr, "compare: %zu thread(s)\n", threads_count);
+
+    async::manager manager{ std::make_unique<async::pool_threads::always>(nullptr, L"compare"s, threads_count, nullptr) };
+    raw_pool pool{ threads_count };
+
+    long long fan_out_expected{ 0 };
+    for (int index = 0; index < fan_out_count; ++index)
+        fan_out_expected += work(index);
+
+    long long pipeline_expected{ 0 };
+    for (int item = 0; item < pipeline_items; ++item)
+    {
+        int value{ item };
+        for (int stage_index = 0; stage_index < pipeline_stages; ++stage_index)
+            value = stage(value, stage_index);
+
+        pipeline_expected += value;
+    }
+
+    const std::vector<std::pair<workload_t, long long>> workloads{
+        { { "fan_out_in"s, [&manager] { return manager_fan_out_in(manager); }, [] { return std_fan_out_in(); }, [&pool] { return raw_fan_out_in(pool); } }, fan_out_expected },
+        { { "pipeline"s, [&manager] { return manager_pipeline(manager); }, [] { return std_pipeline(); }, [&pool] { return raw_pipeline(pool); } }, pipeline_expected },
+        { { "fib"s, [&manager] { return manager_fib(manager); }, [] { return static_cast<long long>(std_fib(fib_number)); }, [&pool] { return raw_fib(pool); } }, fib_sequential(fib_number) },
+        { { "ping_pong"s, [&manager] { return manager_ping_pong(manager); }, [] { return std_ping_pong(); }, [&pool] { return raw_ping_pong(pool); } }, ping_pong_rounds },
+    };
+
+    std::fprintf(stderr, "\n%-12s %14s %14s %14s %14s %14s\n", "workload", "manager, ms", "std_async, ms", "raw_pool, ms", "manager/raw", "std_async/raw");
+
+    for (const auto& [workload, expected] : workloads)
+    {
+        const double manager_ms{ median_ms("manager/"s + workload.name, workload.by_manager, options.repeats, expected) };
+        const double std_async_ms{ median_ms("std_async/"s + workload.name, workload.by_std_async, options.repeats, expected) };
+        const double raw_pool_ms{ median_ms("raw_pool/"s + workload.name, workload.by_raw_pool, options.repeats, expected) };
+
+        const auto ratio = [raw_pool_ms](double time_ms) { return (raw_pool_ms > 0) ? (time_ms / raw_pool_ms) : 0; };
+
+        results.push_back({ "compare"s, "manager"s, threads_count, workload.name, options.repeats, manager_ms, "ms" });
+        results.push_back({ "compare"s, "manager"s, threads_count, workload.name + "_vs_raw"s, options.repeats, ratio(manager_ms), "x" });
+        results.push_back({ "compare"s, "std_async"s, threads_count, workload.name, options.repeats, std_async_ms, "ms" });
+        results.push_back({ "compare"s, "std_async"s, threads_count, workload.name + "_vs_raw"s, options.repeats, ratio(std_async_ms), "x" });
+        results.push_back({ "compare"s, "raw_pool"s, threads_count, workload.name, options.repeats, raw_pool_ms, "ms" });
+
+        std::fprintf(stderr, "%-12s %14.3f %14.3f %14.3f %14.2f %14.2f\n", workload.name.c_str(), manager_ms, std_async_ms, raw_pool_ms, ratio(manager_ms), ratio(std_async_ms));
+    }
+
+    std::fprintf(stderr, "\n");
+}
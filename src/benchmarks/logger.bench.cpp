@@ -0,0 +1,196 @@
+//
+// logger.bench.cpp
+// Benchmarks of the logging: ns/op, allocations/op and bytes allocated/op (--iterations calls of every operation).
+// The subjects: no_logger (the logger is nullptr), null_stream and file (logger_wostream to the stream,
+// which drops the characters, and to the file benchmarks.log, removed at the end).
+//   - log_msg_N:          log_msg with N (1..8) arguments of the different types
+//   - log_except:         log_except with the formatted text
+//   - log_scope_str,
+//     log_scope_args:     enter and leave of log_scope with the name and with the formatted name
+//   - log_ctx_chain_N:    growth of the context of log by N steps (details::append_log_ctx and
+//                         details::add_details_log_ctx), per step
+//   - log_ctx_render_N:   log_msg with the context of log of N steps (the text of the chain is made here)
+//
+
+#include "bench.hpp"
+
+#include <async.hpp>
+
+#include <tuple>
+#include <cstdio>
+#include <memory>
+#include <fstream>
+#include <utility>
+#include <stdexcept>
+#include <streambuf>
+
+
+using namespace std::literals::string_literals;
+using namespace std::literals::string_view_literals;
+
+
+namespace
+{
+    using bench::clock_t;
+
+    /** \brief Buffer of stream, which drops the characters.
+     */
+    class null_wstreambuf : public std::wstreambuf
+    {
+    protected:
+
+        virtual int_type overflow(int_type ch) override
+        {
+            return traits_type::not_eof(ch);
+        }
+
+        virtual std::streamsize xsputn(const char_type*, std::streamsize count) override
+        {
+            return count;
+        }
+    };
+
+    struct subject_t
+    {
+        async::logger* log;
+        const bench::options_t& options;
+        std::vector<bench::result_t>& results;
+        const std::string name;
+
+        /** \brief Rows "<benchmark>" (ns/op), "<benchmark>_allocs" and "<benchmark>_bytes" of the operation.
+         */
+        template<class _Operation>
+        void measure(const std::string& benchmark, std::size_t steps, _Operation&& operation) const
+        {
+            const std::size_t iterations{ options.iterations };
+
+            operation(); // Warm-up: the labels are interned, the buffers are allocated
+
+            const std::uint64_t allocations_before{ bench::allocations_count() };
+            const std::uint64_t bytes_before{ bench::allocated_bytes() };
+            const clock_t::time_point start{ clock_t::now() };
+
+            for (std::size_t iteration = 0; iteration < iterations; ++iteration)
+                operation();
+
+            const double seconds{ bench::seconds_since(start) };
+            const double operations{ static_cast<double>(iterations) * static_cast<double>(steps) };
+
+            results.push_back({ "loggers"s, name, 1, benchmark, iterations, seconds * 1e9 / operations, "ns/op" });
+            results.push_back({ "loggers"s, name, 1, benchmark + "_allocs"s, iterations, static_cast<double>(bench::allocations_count() - allocations_before) / operations, "allocs/op" });
+            results.push_back({ "loggers"s, name, 1, benchmark + "_bytes"s, iterations, static_cast<double>(bench::allocated_bytes() - bytes_before) / operations, "bytes/op" });
+        }
+    };
+
+    template<std::size_t... _Indexes>
+    void bench_log_msg(const subject_t& subject, std::index_sequence<_Indexes...>)
+    {
+        const std::tuple args{ L"message #"sv, 42, L' ', L"text"s, 1234567890ull, true, static_cast<unsigned short>(7), -7ll };
+
+        subject.measure("log_msg_"s + std::to_string(sizeof...(_Indexes)), 1, [&subject, &args]
+        {
+            async::log_msg(subject.log, std::get<_Indexes>(args)...);
+        });
+    }
+
+    void bench_log_except(const subject_t& subject)
+    {
+        const std::exception_ptr except{ std::make_exception_ptr(std::runtime_error{ "bench" }) };
+
+        subject.measure("log_except"s, 1, [&subject, &except]
+        {
+            async::log_except(subject.log, except, L"failed action #"sv, 42);
+        });
+    }
+
+    void bench_log_scope(const subject_t& subject)
+    {
+        subject.measure("log_scope_str"s, 1, [&subject]
+        {
+            const async::log_scope scope{ subject.log, L"scope"s };
+        });
+
+        subject.measure("log_scope_args"s, 1, [&subject]
+        {
+            const async::log_scope scope{ subject.log, L'[', L"scope #"sv, 42, L']' };
+        });
+    }
+
+    void bench_log_ctx(const subject_t& subject, std::size_t steps)
+    {
+        const async::log_ctx_t root{ L"root"s };
+        const async::log_ctx_t next{ L"step"s };
+
+        subject.measure("log_ctx_chain_"s + std::to_string(steps), steps, [&subject, &root, &next, steps]
+        {
+            async::log_ctx_t log_ctx{ root };
+
+            for (std::size_t step = 0; step < steps; ++step)
+            {
+                async::details::append_log_ctx(subject.log, log_ctx, next);
+                async::details::add_details_log_ctx(subject.log, log_ctx, L"scss"sv);
+            }
+        });
+
+        async::log_ctx_t log_ctx{ root };
+
+        for (std::size_t step = 0; step < steps; ++step)
+        {
+            async::details::append_log_ctx(subject.log, log_ctx, next);
+            async::details::add_details_log_ctx(subject.log, log_ctx, L"scss"sv);
+        }
+
+        subject.measure("log_ctx_render_"s + std::to_string(steps), 1, [&subject, &log_ctx]
+        {
+            async::log_msg(subject.log, log_ctx, L": message"sv);
+        });
+    }
+
+    void run_subject(const std::string& name, async::logger* log, const bench::options_t& options, std::vector<bench::result_t>& results)
+    {
+        std::fprintf(stderr, "loggers: %s\n", name.c_str());
+
+        const subject_t subject{ log, options, results, name };
+
+        bench_log_msg(subject, std::make_index_sequence<1>{});
+        bench_log_msg(subject, std::make_index_sequence<2>{});
+        bench_log_msg(subject, std::make_index_sequence<3>{});
+        bench_log_msg(subject, std::make_index_sequence<4>{});
+        bench_log_msg(subject, std::make_index_sequence<5>{});
+        bench_log_msg(subject, std::make_index_sequence<6>{});
+        bench_log_msg(subject, std::make_index_sequence<7>{});
+        bench_log_msg(subject, std::make_index_sequence<8>{});
+
+        bench_log_except(subject);
+        bench_log_scope(subject);
+
+        for (std::size_t steps : { 1, 8, 64 })
+            bench_log_ctx(subject, steps);
+    }
+
+} // namespace
+
+
+void bench::run_loggers(const options_t& options, std::vector<result_t>& results)
+{
+    run_subject("no_logger"s, nullptr, options, results);
+
+    {
+        null_wstreambuf buffer{};
+        std::wostream stream{ &buffer };
+        async::logger_wostream log{ stream };
+
+        run_subject("null_stream"s, &log, options, results);
+    }
+
+    {
+        const char* const file_name{ "benchmarks.log" };
+        {
+            std::wofstream stream{ file_name, std::ios::out | std::ios::trunc };
+            async::logger_wostream log{ stream };
+
+            run_subject("file"s, &log, options, results);
+        }
+        std::remove(file_name);
+    }
+}
@@ -0,0 +1,251 @@
+//
+// main.cpp
+// Benchmarks of the pools (pool.bench.cpp), of the promises (promise.bench.cpp), of the logging (logger.bench.cpp)
+// the memory footprint of the promises (memory.bench.cpp) and the comparison with std::async and the minimal pool
+// (compare.bench.cpp).
+//
+// Usage: benchmarks [--json] [--suite pools|promises|loggers|memory|compare] [--threads <max>] [--tasks <count>] [--rounds <count>] [--depth <count>] [--iterations <count>] [--population <count>] [--repeats <count>]
+//
+// The results are written to stdout as CSV (by default) or as JSON, one row for every subject (e.g. the pool),
+// number of threads and benchmark. The progress is written to stderr.
+//
+
+#include "bench.hpp"
+
+#include <new>
+#include <array>
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+
+namespace
+{
+    /** \brief Counters of the global operator new: a slot per thread (the threads share the slots round-robin, if there are more of them),
+     *         so the allocating threads of the pools do not contend on one cache line. The counters are summed at the reading.
+     */
+    struct alignas(64) allocations_slot_t
+    {
+        std::atomic<std::uint64_t> count{ 0 };
+        std::atomic<std::uint64_t> bytes{ 0 };
+    };
+
+    constexpr std::size_t allocations_slots_count{ 64 };
+
+    std::array<allocations_slot_t, allocations_slots_count> s_allocations_slots{};
+    std::atomic<std::size_t> s_next_allocations_slot{ 0 };
+
+    allocations_slot_t& allocations_slot_of_this_thread() noexcept
+    {
+        // Without the dynamic initialization: operator new is called before main and by the exiting threads
+        thread_local std::size_t slot_number{ 0 };
+
+        if (slot_number == 0)
+            slot_number = (s_next_allocations_slot.fetch_add(1, std::memory_order_relaxed) % allocations_slots_count) + 1;
+
+        return s_allocations_slots[slot_number - 1];
+    }
+
+    void write_csv(const std::vector<bench::result_t>& results)
+    {
+        std::printf("suite,subject,threads,benchmark,samples,value,unit\n");
+
+        for (const bench::result_t& result : results)
+        {
+            std::printf("%s,%s,%zu,%s,%zu,%.3f,%s\n",
+                result.suite.c_str(), result.subject.c_str(), result.threads, result.benchmark.c_str(), result.samples, result.value, result.unit);
+        }
+    }
+
+    void write_json(const std::vector<bench::result_t>& results)
+    {
+        std::printf("[");
+
+        for (std::size_t index = 0; index < results.size(); ++index)
+        {
+            const bench::result_t& result{ results[index] };
+
+            std::printf("%s\n{\"suite\":\"%s\",\"subject\":\"%s\",\"threads\":%zu,\"benchmark\":\"%s\",\"samples\":%zu,\"value\":%.3f,\"unit\":\"%s\"}",
+                (index == 0) ? "" : ",", result.suite.c_str(), result.subject.c_str(), result.threads, result.benchmark.c_str(), result.samples, result.value, result.unit);
+        }
+
+        std::printf("\n]\n");
+    }
+
+    bool parse_options(int argc, char* argv[], bench::options_t& options)
+    {
+        for (int index = 1; index < argc; ++index)
+        {
+            const auto next_number = [argc, argv, &index](std::size_t& number) -> bool
+            {
+                if (index + 1 >= argc)
+                    return false;
+
+                number = static_cast<std::size_t>(std::strtoull(argv[++index], nullptr, 10));
+                return (number > 0);
+            };
+
+            if (std::strcmp(argv[index], "--json") == 0)
+                options.json = true;
+            else
+            if (std::strcmp(argv[index], "--suite") == 0)
+            {
+                if (index + 1 >= argc)
+                    return false;
+
+                ++index;
+                options.pools = (std::strcmp(argv[index], "pools") == 0);
+                options.promises = (std::strcmp(argv[index], "promises") == 0);
+                options.loggers = (std::strcmp(argv[index], "loggers") == 0);
+                options.memory = (std::strcmp(argv[index], "memory") == 0);
+                options.compare = (std::strcmp(argv[index], "compare") == 0);
+
+                if (!options.pools && !options.promises && !options.loggers && !options.memory && !options.compare)
+                    return false;
+            }
+            else
+            if (std::strcmp(argv[index], "--threads") == 0)
+            {
+                if (!next_number(options.max_threads))
+                    return false;
+            }
+            else
+            if (std::strcmp(argv[index], "--tasks") == 0)
+            {
+                if (!next_number(options.tasks))
+                    return false;
+            }
+            else
+            if (std::strcmp(argv[index], "--rounds") == 0)
+            {
+                if (!next_number(options.rounds))
+                    return false;
+            }
+            else
+            if (std::strcmp(argv[index], "--depth") == 0)
+            {
+                if (!next_number(options.depth))
+                    return false;
+            }
+            else
+            if (std::strcmp(argv[index], "--iterations") == 0)
+            {
+                if (!next_number(options.iterations))
+                    return false;
+            }
+            else
+            if (std::strcmp(argv[index], "--population") == 0)
+            {
+                if (!next_number(options.population))
+                    return false;
+            }
+            else
+            if (std::strcmp(argv[index], "--repeats") == 0)
+            {
+                if (!next_number(options.repeats))
+                    return false;
+            }
+            else
+                return false;
+        }
+
+        return true;
+    }
+
+} // namespace
+
+
+std::uint64_t bench::allocations_count() noexcept
+{
+    std::uint64_t count{ 0 };
+    for (const allocations_slot_t& slot : s_allocations_slots)
+        count += slot.count.load(std::memory_order_relaxed);
+
+    return count;
+}
+
+std::uint64_t bench::allocated_bytes() noexcept
+{
+    std::uint64_t bytes{ 0 };
+    for (const allocations_slot_t& slot : s_allocations_slots)
+        bytes += slot.bytes.load(std::memory_order_relaxed);
+
+    return bytes;
+}
+
+
+// The global allocator counts the allocations (the aligned ones are not counted)
+
+void* operator new(std::size_t size)
+{
+    allocations_slot_t& slot{ allocations_slot_of_this_thread() };
+    slot.count.fetch_add(1, std::memory_order_relaxed);
+    slot.bytes.fetch_add(size, std::memory_order_relaxed);
+
+    if (void* const memory = std::malloc(size ? size : 1))
+        return memory;
+
+    throw std::bad_alloc{};
+}
+
+void* operator new[](std::size_t size)
+{
+    return operator new(size);
+}
+
+void operator delete(void* memory) noexcept
+{
+    std::free(memory);
+}
+
+void operator delete[](void* memory) noexcept
+{
+    std::free(memory);
+}
+
+void operator delete(void* memory, std::size_t) noexcept
+{
+    std::free(memory);
+}
+
+void operator delete[](void* memory, std::size_t) noexcept
+{
+    std::free(memory);
+}
+
+
+int main(int argc, char* argv[])
+{
+    bench::options_t options{};
+
+    if (!parse_options(argc, argv, options))
+    {
+        std::fprintf(stderr, "Usage: benchmarks [--json] [--suite pools|promises|loggers|memory|compare] [--threads <max>] [--tasks <count>] [--rounds <count>] [--depth <count>] [--iterations <count>] [--population <count>] [--repeats <count>]\n");
+        return EXIT_FAILURE;
+    }
+
+    std::vector<bench::result_t> results{};
+
+    if (options.pools)
+        bench::run_pools(options, results);
+
+    if (options.promises)
+        bench::run_promises(options, results);
+
+    if (options.loggers)
+        bench::run_loggers(options, results);
+
+    if (options.memory)
+        bench::run_memory(options, results);
+
+    if (options.compare)
+        bench::run_compare(options, results);
+
+    if (options.json)
+        write_json(results);
+    else
+        write_csv(results);
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,299 @@
+//
+// memory.bench.cpp
+// Memory footprint of the promises: --population objects are made by every stage and kept until its end,
+// the bytes per object are measured by the memory resource of the manager, by the global operator new and by the RSS.
+//   - pending:       the unresolved promise<int> with its promise<int>::send
+//   - send_copy:     one more copy of the send (the handle of the shared state)
+//   - continuation:  the bound continuation (success) of the pending promise with the promise of the next step
+//   - all:           manager::all over the container of the pending promises, per promise
+//
+// The bytes of every stage are broken down as:
+//   - <stage>_prom_data:  the shared states of the promises (prom_data_t, its reference counter is inside),
+//                         told by the sizes of prom_data_t<int> and prom_data_t<std::vector<int>> (see the row "sizeof")
+//   - <stage>_closure:    the other allocations from the memory resource (the closures of the next steps, the shared
+//                         state of all with the control block of std::allocate_shared)
+//   - <stage>_heap:       the global operator new (the targets of std::function, the contexts of log, the vectors);
+//                         the subject "logger" minus the subject "no_logger" is the cost of the contexts of log
+//   - <stage>_total, <stage>_allocs, <stage>_rss
+// The rows of the subject "sizeof" are the sizes of the types (without the allocations, which they own).
+//
+
+#include "bench.hpp"
+#include "bench_promise.hpp"
+
+#include <new>
+#include <atomic>
+#include <memory>
+#include <cstdio>
+#include <vector>
+#include <cstdlib>
+#include <utility>
+#include <algorithm>
+#include <functional>
+#include <memory_resource>
+
+#if defined(_WIN32)
+#   ifndef NOMINMAX
+#       define NOMINMAX
+#   endif
+#   ifndef WIN32_LEAN_AND_MEAN
+#       define WIN32_LEAN_AND_MEAN
+#   endif
+#   include <windows.h>
+#   include <psapi.h>
+#elif defined(__linux__)
+#   include <unistd.h>
+#endif
+
+
+using namespace std::literals::string_literals;
+
+
+namespace
+{
+    /** \brief Resident memory of the process (0, if it is not known on the platform).
+     */
+    std::size_t resident_bytes() noexcept
+    {
+#if defined(_WIN32)
+        PROCESS_MEMORY_COUNTERS counters{};
+        if (::GetProcessMemoryInfo(::GetCurrentProcess(), &counters, sizeof(counters)))
+            return counters.WorkingSetSize;
+#elif defined(__linux__)
+        if (std::FILE* const file = std::fopen("/proc/self/statm", "r"))
+        {
+            unsigned long long total_pages{ 0 };
+            unsigned long long resident_pages{ 0 };
+            const int read_count{ std::fscanf(file, "%llu %llu", &total_pages, &resident_pages) };
+            std::fclose(file);
+
+            if (read_count == 2)
+                return static_cast<std::size_t>(resident_pages) * static_cast<std::size_t>(::sysconf(_SC_PAGESIZE));
+        }
+#endif
+        return 0;
+    }
+
+    /** \brief Memory resource of the manager, which counts the bytes: of the shared states of promises (by their sizes) and of the others.
+     *
+     * \details The memory is taken by malloc, so it is not counted by the global operator new.
+     */
+    class counting_resource : public std::pmr::memory_resource
+    {
+    public:
+
+        std::atomic<std::uint64_t> prom_data_bytes{ 0 };
+        std::atomic<std::uint64_t> other_bytes{ 0 };
+        std::atomic<std::uint64_t> allocations{ 0 };
+
+        std::vector<std::size_t> prom_data_sizes{}; // Set before the manager is used
+
+    private:
+
+        virtual void* do_allocate(std::size_t bytes, std::size_t alignment) override
+        {
+            allocations.fetch_add(1, std::memory_order_relaxed);
+
+            if (std::find(prom_data_sizes.begin(), prom_data_sizes.end(), bytes) != prom_data_sizes.end())
+                prom_data_bytes.fetch_add(bytes, std::memory_order_relaxed);
+            else
+                other_bytes.fetch_add(bytes, std::memory_order_relaxed);
+
+            if (alignment > alignof(std::max_align_t))
+                return ::operator new(bytes, std::align_val_t{ alignment });
+
+            if (void* const memory = std::malloc(bytes ? bytes : 1))
+                return memory;
+
+            throw std::bad_alloc{};
+        }
+
+        virtual void do_deallocate(void* memory, std::size_t bytes, std::size_t alignment) override
+        {
+            if (alignment > alignof(std::max_align_t))
+                ::operator delete(memory, bytes, std::align_val_t{ alignment });
+            else
+                std::free(memory);
+        }
+
+        virtual bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override
+        {
+            return (this == &other);
+        }
+    };
+
+    struct snapshot_t
+    {
+        std::uint64_t prom_data_bytes;
+        std::uint64_t other_bytes;
+        std::uint64_t heap_bytes;
+        std::uint64_t allocations;
+        std::size_t resident_bytes;
+    };
+
+    struct subject_t
+    {
+        async::manager& manager;
+        counting_resource& resource;
+        const bench::options_t& options;
+        std::vector<bench::result_t>& results;
+        const std::string name;
+
+        snapshot_t snapshot() const noexcept
+        {
+            return {
+                resource.prom_data_bytes.load(),
+                resource.other_bytes.load(),
+                bench::allocated_bytes(),
+                resource.allocations.load() + bench::allocations_count(),
+                resident_bytes() };
+        }
+
+        void add_stage(const std::string& stage, const snapshot_t& before, std::size_t count) const
+        {
+            const snapshot_t after{ snapshot() };
+
+            const auto per_object = [count](auto after_value, auto before_value)
+            {
+                return (static_cast<double>(after_value) - static_cast<double>(before_value)) / static_cast<double>(count);
+            };
+
+            const double prom_data{ per_object(after.prom_data_bytes, before.prom_data_bytes) };
+            const double closure{ per_object(after.other_bytes, before.other_bytes) };
+            const double heap{ per_object(after.heap_bytes, before.heap_bytes) };
+
+            results.push_back({ "memory"s, name, 1, stage + "_prom_data"s, count, prom_data, "bytes/object" });
+            results.push_back({ "memory"s, name, 1, stage + "_closure"s, count, closure, "bytes/object" });
+            results.push_back({ "memory"s, name, 1, stage + "_heap"s, count, heap, "bytes/object" });
+            results.push_back({ "memory"s, name, 1, stage + "_total"s, count, prom_data + closure + heap, "bytes/object" });
+            results.push_back({ "memory"s, name, 1, stage + "_allocs"s, count, per_object(after.allocations, before.allocations), "allocs/object" });
+            results.push_back({ "memory"s, name, 1, stage + "_rss"s, count, per_object(after.resident_bytes, before.resident_bytes), "bytes/object" });
+        }
+    };
+
+    void bench_promises(const subject_t& subject)
+    {
+        const std::size_t count{ subject.options.population };
+
+        std::vector<async::promise<int>> promises{};
+        std::vector<async::promise<int>::send> senders{};
+        std::vector<async::promise<int>::send> sender_copies{};
+        std::vector<async::promise<int>> next_promises{};
+
+        // The vectors are not the footprint of the objects
+        promises.reserve(count);
+        senders.reserve(count);
+        sender_copies.reserve(count);
+        next_promises.reserve(count);
+
+        {
+            const snapshot_t before{ subject.snapshot() };
+
+            for (std::size_t index = 0; index < count; ++index)
+            {
+                auto [prom, sender] = bench::pending_promise<int>(subject.manager);
+                promises.push_back(std::move(prom));
+                senders.push_back(std::move(sender));
+            }
+
+            subject.add_stage("pending"s, before, count);
+        }
+
+        {
+            const snapshot_t before{ subject.snapshot() };
+
+            for (const async::promise<int>::send& sender : senders)
+                sender_copies.push_back(sender);
+
+            subject.add_stage("send_copy"s, before, count);
+        }
+
+        {
+            const snapshot_t before{ subject.snapshot() };
+
+            for (async::promise<int>& prom : promises)
+                next_promises.push_back(prom.success<int>([](int value) { return value + 1; }));
+
+            subject.add_stage("continuation"s, before, count);
+        }
+
+        for (std::size_t index = 0; index < count; ++index)
+            senders[index].resolve(static_cast<int>(index));
+
+        subject.manager.wait_tasks_complete();
+    }
+
+    void bench_all(const subject_t& subject)
+    {
+        const std::size_t count{ subject.options.population };
+
+        std::vector<async::promise<int>> promises{};
+        std::vector<async::promise<int>::send> senders{};
+
+        promises.reserve(count);
+        senders.reserve(count);
+
+        for (std::size_t index = 0; index < count; ++index)
+        {
+            auto [prom, sender] = bench::pending_promise<int>(subject.manager);
+            promises.push_back(std::move(prom));
+            senders.push_back(std::move(sender));
+        }
+
+        const snapshot_t before{ subject.snapshot() };
+
+        async::promise<std::vector<int>> all_promise{ subject.manager.all(L"all"s, std::move(promises)) };
+
+        subject.add_stage("all"s, before, count);
+
+        all_promise.success<void>([](std::vector<int>) {});
+
+        for (std::size_t index = 0; index < count; ++index)
+            senders[index].resolve(static_cast<int>(index));
+
+        subject.manager.wait_tasks_complete();
+    }
+
+    void run_subject(const std::string& name, bool with_logger, const bench::options_t& options, std::vector<bench::result_t>& results)
+    {
+        std::fprintf(stderr, "memory: %s, %zu object(s)\n", name.c_str(), options.population);
+
+        counting_resource resource{};
+        resource.prom_data_sizes = { sizeof(async::details::prom_data_t<int>), sizeof(async::details::prom_data_t<std::vector<int>>) };
+
+        std::unique_ptr<async::logger> logger{ with_logger ? std::make_unique<bench::null_logger>() : nullptr };
+
+        async::manager manager{ std::make_unique<async::pool_threads::always>(std::move(logger), L"bench"s, 1, nullptr), &resource };
+
+        const subject_t subject{ manager, resource, options, results, name };
+
+        bench_promises(subject);
+        bench_all(subject);
+    }
+
+    void add_sizes(std::vector<bench::result_t>& results)
+    {
+        const auto add_size = [&results](const char* type_name, std::size_t size)
+        {
+            results.push_back({ "memory"s, "sizeof"s, 1, type_name, 1, static_cast<double>(size), "bytes" });
+        };
+
+        add_size("promise", sizeof(async::promise<int>));
+        add_size("send", sizeof(async::promise<int>::send));
+        add_size("prom_data_t", sizeof(async::details::prom_data_t<int>));
+        add_size("result_t", sizeof(async::details::result_t<int>));
+        add_size("log_ctx_t", sizeof(async::log_ctx_t));
+        add_size("task_t", sizeof(async::pool::task_t));
+        add_size("std_function", sizeof(std::function<int(int)>));
+    }
+
+} // namespace
+
+
+void bench::run_memory(const options_t& options, std::vector<result_t>& results)
+{
+    add_sizes(results);
+
+    run_subject("no_logger"s, false, options, results);
+    run_subject("logger"s, true, options, results);
+}
@@ -0,0 +1,158 @@
+//
+// pool.bench.cpp
+// Benchmarks of the pools with 1..N threads:
+//   - external:  tasks/second, the empty tasks are added by the thread out of the pool (the queue of the pool)
+//   - internal:  tasks/second, every task adds the next one by the context of its thread (UseThreadReservationAlgorithm)
+//   - wakeup:    microseconds from the adding of the task to the idle pool until the start of the task
+//
+
+#include "bench.hpp"
+
+#include <async/pool_threads_numa.hpp>
+#include <async/pool_threads_always.hpp>
+#include <async/pool_threads_hybrid.hpp>
+#include <async/pool_threads_stealing.hpp>
+#include <async/pool_threads_ondemand.hpp>
+
+#include <atomic>
+#include <memory>
+#include <cstdio>
+#include <utility>
+#include <functional>
+
+
+using namespace std::literals::string_literals;
+
+
+namespace
+{
+    using bench::clock_t;
+
+    using make_pool_t = std::function<std::unique_ptr<async::pool>(std::size_t threads_count)>;
+
+    double tasks_per_second(std::size_t tasks, double seconds) noexcept
+    {
+        return (seconds > 0) ? (static_cast<double>(tasks) / seconds) : 0;
+    }
+
+    /** \brief The empty tasks are added by the thread out of the pool.
+     */
+    double bench_external(async::pool& pool, std::size_t tasks)
+    {
+        std::atomic<std::size_t> executed{ 0 };
+
+        const clock_t::time_point start{ clock_t::now() };
+
+        for (std::size_t index = 0; index < tasks; ++index)
+            pool.add_task(async::pool::unknown_ctx, [&executed](async::pool::ctx_t) { executed.fetch_add(1, std::memory_order_relaxed); });
+
+        pool.wait_tasks_complete();
+
+        return tasks_per_second(executed.load(), bench::seconds_since(start));
+    }
+
+    /** \brief Every thread of pool runs the chain: the task adds the next one by the context of its thread.
+     */
+    double bench_internal(async::pool& pool, std::size_t threads_count, std::size_t tasks)
+    {
+        struct chain_t
+        {
+            async::pool& pool;
+            const std::size_t tasks;
+            std::atomic<std::size_t> added;
+            std::atomic<std::size_t> executed;
+        };
+
+        struct step_t
+        {
+            chain_t* chain;
+
+            void operator()(async::pool::ctx_t this_ctx) const
+            {
+                chain->executed.fetch_add(1, std::memory_order_relaxed);
+
+                if (chain->added.fetch_add(1, std::memory_order_relaxed) < chain->tasks)
+                    chain->pool.add_task(this_ctx, step_t{ chain });
+            }
+        };
+
+        const std::size_t chains_count{ std::min(threads_count, tasks) };
+
+        chain_t chain{ pool, tasks, { chains_count }, { 0 } };
+
+        const clock_t::time_point start{ clock_t::now() };
+
+        for (std::size_t index = 0; index < chains_count; ++index)
+            pool.add_task(async::pool::unknown_ctx, step_t{ &chain });
+
+        pool.wait_tasks_complete();
+
+        return tasks_per_second(chain.executed.load(), bench::seconds_since(start));
+    }
+
+    /** \brief The latencies (microseconds) from the adding of the task to the idle pool until the start of the task.
+     */
+    std::vector<double> bench_wakeup(async::pool& pool, std::size_t rounds)
+    {
+        std::vector<double> latencies{};
+        latencies.reserve(rounds);
+
+        for (std::size_t round = 0; round < rounds; ++round)
+        {
+            pool.wait_tasks_complete();
+
+            // The threads fall asleep (or leave the pool, e.g. ondemand) while the pool has no tasks
+            std::this_thread::sleep_for(std::chrono::microseconds{ 500 });
+
+            std::atomic<clock_t::rep> started{ 0 };
+
+            const clock_t::time_point added{ clock_t::now() };
+
+            pool.add_task(async::pool::unknown_ctx, [&started](async::pool::ctx_t)
+            {
+                started.store(clock_t::now().time_since_epoch().count(), std::memory_order_release);
+            });
+
+            pool.wait_tasks_complete();
+
+            const clock_t::duration latency{ clock_t::duration{ started.load(std::memory_order_acquire) } - added.time_since_epoch() };
+            latencies.push_back(std::chrono::duration<double, std::micro>(latency).count());
+        }
+
+        return latencies;
+    }
+
+    void run_pool(const std::string& pool_name, const make_pool_t& make_pool, const bench::options_t& options, std::vector<bench::result_t>& results)
+    {
+        for (std::size_t threads_count = 1; threads_count <= options.max_threads; ++threads_count)
+        {
+            std::fprintf(stderr, "pools: %s, %zu thread(s)\n", pool_name.c_str(), threads_count);
+
+            const std::unique_ptr<async::pool> pool{ make_pool(threads_count) };
+
+            bench_external(*pool, std::min<std::size_t>(options.tasks, 10'000)); // Warm-up: the threads are started, the memory is allocated
+
+            results.push_back({ "pools"s, pool_name, threads_count, "external"s, options.tasks, bench_external(*pool, options.tasks), "tasks/s" });
+            results.push_back({ "pools"s, pool_name, threads_count, "internal"s, options.tasks, bench_internal(*pool, threads_count, options.tasks), "tasks/s" });
+
+            bench::add_percentiles(results, { "pools"s, pool_name, threads_count, "wakeup"s, 0, 0, "us" }, bench_wakeup(*pool, options.rounds));
+        }
+    }
+
+} // namespace
+
+
+void bench::run_pools(const options_t& options, std::vector<result_t>& results)
+{
+    // The new pool is added here: its name and how it is made with the given number of threads
+    const std::vector<std::pair<std::string, make_pool_t>> pools{
+        { "always"s, [](std::size_t threads_count) { return std::make_unique<async::pool_threads::always>(nullptr, L""s, threads_count, nullptr); } },
+        { "ondemand"s, [](std::size_t threads_count) { return std::make_unique<async::pool_threads::ondemand>(nullptr, L""s, threads_count, async::pool_threads::ondemand::waiting_time_new_tasks_default(), nullptr); } },
+        { "hybrid"s, [](std::size_t threads_count) { return std::make_unique<async::pool_threads::hybrid>(nullptr, L""s, 1, threads_count, async::pool_threads::hybrid::keep_alive_default(), nullptr); } },
+        { "numa"s, [](std::size_t threads_count) { return std::make_unique<async::pool_threads::numa>(nullptr, L""s, threads_count, nullptr); } },
+        { "stealing"s, [](std::size_t threads_count) { return std::make_unique<async::pool_threads::stealing>(nullptr, L""s, threads_count, nullptr); } },
+    };
+
+    for (const auto& [pool_name, make_pool] : pools)
+        run_pool(pool_name, make_pool, options, results);
+}
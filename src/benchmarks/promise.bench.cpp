@@ -0,0 +1,276 @@
+//
+// promise.bench.cpp
+// Benchmarks of the promises (the pool always, without the logger and with the logger, which drops the messages):
+//   - resolve_to_then:   microseconds from promise<T>::send::resolve to the start of the bound continuation
+//   - then/success/reject_hop: nanoseconds per step of the chain of --depth steps (from the resolve of the first
+//                        promise to the end of the chain), with the allocations per step
+//   - all_vector_N:      microseconds of manager::all of N resolved promises (the container) until its continuation
+//   - all_tuple_N:       the same for the variadic manager::all
+//   - task_here_and_now: nanoseconds of the call, which resolves the promise at once
+//
+
+#include "bench.hpp"
+#include "bench_promise.hpp"
+
+#include <atomic>
+#include <memory>
+#include <cstdio>
+#include <utility>
+#include <stdexcept>
+
+
+using namespace std::literals::string_literals;
+
+
+namespace
+{
+    using bench::clock_t;
+
+    enum class chain_kind
+    {
+        then,
+        success,
+        reject,
+    };
+
+    struct subject_t
+    {
+        async::manager& manager;
+        const bench::options_t& options;
+        std::vector<bench::result_t>& results;
+        const std::string name;
+        const std::size_t threads_count;
+
+        bench::result_t head(std::string benchmark, const char* unit) const
+        {
+            return { "promises"s, name, threads_count, std::move(benchmark), 0, 0, unit };
+        }
+
+        void add_value(std::string benchmark, std::size_t samples, double value, const char* unit) const
+        {
+            bench::result_t result{ head(std::move(benchmark), unit) };
+            result.samples = samples;
+            result.value = value;
+            results.push_back(std::move(result));
+        }
+    };
+
+    double micro_since(clock_t::rep start, clock_t::rep finish) noexcept
+    {
+        return std::chrono::duration<double, std::micro>(clock_t::duration{ finish - start }).count();
+    }
+
+    clock_t::rep now() noexcept
+    {
+        return clock_t::now().time_since_epoch().count();
+    }
+
+    void bench_resolve_to_then(const subject_t& subject)
+    {
+        std::vector<double> latencies{};
+        latencies.reserve(subject.options.rounds);
+
+        for (std::size_t round = 0; round < subject.options.rounds; ++round)
+        {
+            auto [prom, sender] = bench::pending_promise<int>(subject.manager);
+
+            std::atomic<clock_t::rep> started{ 0 };
+
+            prom.success<void>([&started](int) { started.store(now(), std::memory_order_release); });
+
+            const clock_t::rep resolved{ now() };
+            sender.resolve(static_cast<int>(round));
+
+            subject.manager.wait_tasks_complete();
+
+            latencies.push_back(micro_since(resolved, started.load(std::memory_order_acquire)));
+        }
+
+        bench::add_percentiles(subject.results, subject.head("resolve_to_then"s, "us"), std::move(latencies));
+    }
+
+    void bench_chain(const subject_t& subject, chain_kind kind, const std::string& benchmark)
+    {
+        const std::size_t depth{ subject.options.depth };
+        const std::size_t rounds{ std::max<std::size_t>(10, subject.options.rounds / 10) };
+
+        std::vector<double> hop_times{};
+        hop_times.reserve(rounds);
+
+        std::uint64_t allocations{ 0 };
+
+        for (std::size_t round = 0; round < rounds; ++round)
+        {
+            const std::uint64_t allocations_before{ bench::allocations_count() };
+
+            auto [prom, sender] = bench::pending_promise<int>(subject.manager);
+
+            async::promise<int> last{ std::move(prom) };
+
+            for (std::size_t step = 0; step < depth; ++step)
+            {
+                switch (kind)
+                {
+                case chain_kind::then:
+                    last = last.then<int>([](async::value_t<int> value) { return value.get_value() + 1; });
+                    break;
+
+                case chain_kind::success:
+                    last = last.success<int>([](int value) { return value + 1; });
+                    break;
+
+                case chain_kind::reject:
+                    // The rejection goes through every step
+                    last = last.reject([](std::exception_ptr except) -> int { std::rethrow_exception(except); });
+                    break;
+                }
+            }
+
+            std::atomic<clock_t::rep> finished{ 0 };
+
+            last.then<void>([&finished](async::value_t<int>) { finished.store(now(), std::memory_order_release); });
+
+            const clock_t::rep started{ now() };
+
+            if (kind == chain_kind::reject)
+                sender.reject(std::make_exception_ptr(std::runtime_error{ "bench" }));
+            else
+                sender.resolve(0);
+
+            subject.manager.wait_tasks_complete();
+
+            hop_times.push_back(micro_since(started, finished.load(std::memory_order_acquire)) * 1000 / static_cast<double>(depth));
+            allocations += bench::allocations_count() - allocations_before;
+        }
+
+        bench::add_percentiles(subject.results, subject.head(benchmark, "ns"), std::move(hop_times));
+        subject.add_value(benchmark + "_allocs"s, rounds, static_cast<double>(allocations) / static_cast<double>(rounds * depth), "allocs/hop");
+    }
+
+    void bench_all_vector(const subject_t& subject, std::size_t count)
+    {
+        const std::size_t rounds{ std::max<std::size_t>(3, std::min<std::size_t>(subject.options.rounds, 100'000 / count)) };
+
+        std::vector<double> latencies{};
+        latencies.reserve(rounds);
+
+        std::uint64_t allocations{ 0 };
+
+        for (std::size_t round = 0; round < rounds; ++round)
+        {
+            std::vector<async::promise<int>> promises{};
+            promises.reserve(count);
+
+            for (std::size_t index = 0; index < count; ++index)
+                promises.push_back(subject.manager.resolve(L"item"s, static_cast<int>(index)));
+
+            std::atomic<clock_t::rep> finished{ 0 };
+
+            const std::uint64_t allocations_before{ bench::allocations_count() };
+            const clock_t::rep started{ now() };
+
+            subject.manager.all(L"all"s, std::move(promises)).success<void>([&finished](std::vector<int>) { finished.store(now(), std::memory_order_release); });
+
+            subject.manager.wait_tasks_complete();
+
+            latencies.push_back(micro_since(started, finished.load(std::memory_order_acquire)));
+            allocations += bench::allocations_count() - allocations_before;
+        }
+
+        const std::string benchmark{ "all_vector_"s + std::to_string(count) };
+
+        bench::add_percentiles(subject.results, subject.head(benchmark, "us"), std::move(latencies));
+        subject.add_value(benchmark + "_allocs"s, rounds, static_cast<double>(allocations) / static_cast<double>(rounds * count), "allocs/promise");
+    }
+
+    template<std::size_t... _Indexes>
+    void bench_all_tuple(const subject_t& subject, std::index_sequence<_Indexes...>)
+    {
+        constexpr std::size_t count{ sizeof...(_Indexes) };
+
+        std::vector<double> latencies{};
+        latencies.reserve(subject.options.rounds);
+
+        for (std::size_t round = 0; round < subject.options.rounds; ++round)
+        {
+            std::atomic<clock_t::rep> finished{ 0 };
+
+            const clock_t::rep started{ now() };
+
+            subject.manager.all(L"all"s, subject.manager.resolve(L"item"s, static_cast<int>(_Indexes))...)
+                .template success<void>([&finished](std::tuple<decltype(static_cast<int>(_Indexes))...>) { finished.store(now(), std::memory_order_release); });
+
+            subject.manager.wait_tasks_complete();
+
+            latencies.push_back(micro_since(started, finished.load(std::memory_order_acquire)));
+        }
+
+        bench::add_percentiles(subject.results, subject.head("all_tuple_"s + std::to_string(count), "us"), std::move(latencies));
+    }
+
+    void bench_task_here_and_now(const subject_t& subject)
+    {
+        std::vector<double> times{};
+        times.reserve(subject.options.rounds);
+
+        const std::uint64_t allocations_before{ bench::allocations_count() };
+
+        for (std::size_t round = 0; round < subject.options.rounds; ++round)
+        {
+            const clock_t::rep started{ now() };
+
+            async::promise<int> prom{ subject.manager.task_here_and_now<int>(L"now"s, [round](async::promise<int>::send async_send)
+            {
+                async_send.resolve(static_cast<int>(round));
+            }) };
+
+            times.push_back(micro_since(started, now()) * 1000);
+        }
+
+        const std::uint64_t allocations{ bench::allocations_count() - allocations_before };
+
+        bench::add_percentiles(subject.results, subject.head("task_here_and_now"s, "ns"), std::move(times));
+        subject.add_value("task_here_and_now_allocs"s, subject.options.rounds, static_cast<double>(allocations) / static_cast<double>(subject.options.rounds), "allocs/call");
+    }
+
+    void run_subject(const std::string& name, bool with_logger, const bench::options_t& options, std::vector<bench::result_t>& results)
+    {
+        const std::size_t threads_count{ options.max_threads };
+
+        std::fprintf(stderr, "promises: %s, %zu thread(s)\n", name.c_str(), threads_count);
+
+        std::unique_ptr<async::logger> logger{ with_logger ? std::make_unique<bench::null_logger>() : nullptr };
+
+        async::manager manager{ std::make_unique<async::pool_threads::always>(std::move(logger), L"bench"s, threads_count, nullptr) };
+
+        const subject_t subject{ manager, options, results, name, threads_count };
+
+        // Warm-up: the threads are started, the memory is allocated
+        {
+            std::vector<bench::result_t> warm_up_results{};
+            bench_resolve_to_then({ manager, options, warm_up_results, name, threads_count });
+        }
+
+        bench_resolve_to_then(subject);
+
+        bench_chain(subject, chain_kind::then, "then_hop"s);
+        bench_chain(subject, chain_kind::success, "success_hop"s);
+        bench_chain(subject, chain_kind::reject, "reject_hop"s);
+
+        for (std::size_t count : { 2, 10, 100, 1'000, 10'000, 100'000 })
+            bench_all_vector(subject, count);
+
+        bench_all_tuple(subject, std::make_index_sequence<2>{});
+        bench_all_tuple(subject, std::make_index_sequence<8>{});
+
+        bench_task_here_and_now(subject);
+    }
+
+} // namespace
+
+
+void bench::run_promises(const options_t& options, std::vector<result_t>& results)
+{
+    run_subject("no_logger"s, false, options, results);
+    run_subject("logger"s, true, options, results);
+}
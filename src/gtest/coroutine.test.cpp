@@ -0,0 +1,172 @@
+#include "pch.h"
+
+#include <async.hpp>
+
+#ifdef ASYNC_LIB_COROUTINES
+
+#include <atomic>
+#include <thread>
+#include <stdexcept>
+#include <memory_resource>
+
+
+namespace
+{
+    class counting_resource : public std::pmr::memory_resource
+    {
+    public:
+
+        std::atomic<std::size_t> allocations{ 0 };
+        std::atomic<std::ptrdiff_t> in_use{ 0 };
+
+    protected:
+
+        void* do_allocate(std::size_t bytes, std::size_t alignment) override
+        {
+            allocations += 1;
+            in_use += 1;
+            return std::pmr::new_delete_resource()->allocate(bytes, alignment);
+        }
+
+        void do_deallocate(void* ptr, std::size_t bytes, std::size_t alignment) override
+        {
+            in_use -= 1;
+            std::pmr::new_delete_resource()->deallocate(ptr, bytes, alignment);
+        }
+
+        bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override
+        {
+            return (this == &other);
+        }
+    };
+
+    async::promise<int> sum_of_steps(async::manager& manager, async::promise<int> pending, std::thread::id& ready_thread_id, std::thread::id& pending_thread_id)
+    {
+        const int first{ co_await manager.resolve(L"first"s, 1) };
+        ready_thread_id = std::this_thread::get_id();
+
+        const int second{ co_await std::move(pending) };
+        pending_thread_id = std::this_thread::get_id();
+
+        co_return first + second;
+    }
+
+    async::promise<int> catch_rejected(async::manager& manager)
+    {
+        try
+        {
+            co_await manager.reject<int>(L"rejected"s, std::make_exception_ptr(std::runtime_error{ "rejected" }));
+        }
+        catch (const std::runtime_error&)
+        {
+            co_return 1;
+        }
+
+        co_return 0;
+    }
+
+    async::promise<void> throw_after_task(async::manager& manager)
+    {
+        co_await manager.task(L"task"s, [] {});
+
+        throw std::runtime_error{ "thrown" };
+    }
+
+    async::promise<int> chain_of_tasks(async::manager& manager, int count)
+    {
+        int sum{ 0 };
+
+        for (int index = 0; index < count; ++index)
+            sum += co_await manager.task<int>(L"task"s, [index] { return index; });
+
+        co_return sum;
+    }
+
+    async::promise<void> nothing(async::manager&)
+    {
+        co_return;
+    }
+
+} // namespace
+
+
+TEST(coroutine, co_await_ready_and_pending)
+{
+    async::manager manager{ async::make_manager<async::pool_threads::always>(1, nullptr) };
+
+    async::promise<int>::send sender{};
+    async::promise<int> pending{ manager.task_here_and_now<int>(L"pending"s, [&sender](async::promise<int>::send async_send) { sender = std::move(async_send); }) };
+
+    std::thread::id ready_thread_id{};
+    std::thread::id pending_thread_id{};
+
+    async::promise<int> prom{ sum_of_steps(manager, std::move(pending), ready_thread_id, pending_thread_id) };
+
+    // The coroutine is executed in this thread until the pending promise
+    EXPECT_EQ(std::this_thread::get_id(), ready_thread_id);
+
+    std::atomic<int> result{ 0 };
+    prom.success<void>([&result](int value) { result = value; });
+
+    sender.resolve(2);
+    manager.wait_tasks_complete();
+
+    EXPECT_EQ(3, result.load());
+    EXPECT_NE(std::this_thread::get_id(), pending_thread_id);
+}
+
+TEST(coroutine, exceptions)
+{
+    async::manager manager{ async::make_manager<async::pool_threads::always>(2, nullptr) };
+
+    std::atomic<int> caught{ 0 };
+    catch_rejected(manager).success<void>([&caught](int value) { caught = value; });
+
+    std::atomic<bool> rejected{ false };
+    throw_after_task(manager).reject([&rejected](std::exception_ptr) { rejected = true; });
+
+    manager.wait_tasks_complete();
+
+    EXPECT_EQ(1, caught.load());
+    EXPECT_TRUE(rejected.load());
+}
+
+TEST(coroutine, chain_of_tasks)
+{
+    async::manager manager{ async::make_manager<async::pool_threads::always>(hardware_thread_count, nullptr) };
+
+    std::atomic<int> result{ 0 };
+    chain_of_tasks(manager, 1000).success<void>([&result](int value) { result = value; });
+
+    manager.wait_tasks_complete();
+
+    EXPECT_EQ(999 * 1000 / 2, result.load());
+}
+
+TEST(coroutine, frame_from_memory_resource)
+{
+    counting_resource resource;
+    {
+        async::manager manager{ std::make_unique<async::pool_threads::always>(1, nullptr), &resource };
+
+        {
+            async::promise<void> prom{ nothing(manager) };
+
+            // The frame and the shared state of the result; the frame is already freed
+            EXPECT_EQ(2u, resource.allocations.load());
+            EXPECT_EQ(1, resource.in_use.load());
+        }
+
+        EXPECT_EQ(0, resource.in_use.load());
+
+        std::atomic<int> result{ 0 };
+        chain_of_tasks(manager, 10).success<void>([&result](int value) { result = value; });
+
+        manager.wait_tasks_complete();
+
+        EXPECT_EQ(45, result.load());
+    }
+    EXPECT_EQ(0, resource.in_use.load());
+}
+
+#endif // ASYNC_LIB_COROUTINES
@@ -0,0 +1,31 @@
+#include "pch.h"
+
+#include <async.hpp>
+
+#include <atomic>
+
+
+TEST(current_ctx, thread_of_pool)
+{
+    EXPECT_EQ(async::pool::unknown_ctx, async::pool::current_ctx());
+
+    async::manager manager{ async::make_manager<async::pool_threads::always>(2, nullptr) };
+
+    std::atomic<async::pool*> ctx_pool{ nullptr };
+    std::atomic<std::size_t> ctx_index{ static_cast<std::size_t>(-1) };
+
+    manager.task(L"task"s, [&ctx_pool, &ctx_index]
+    {
+        const async::pool::ctx_t ctx{ async::pool::current_ctx() };
+
+        ctx_pool = std::get<async::pool*>(ctx);
+        ctx_index = std::get<std::size_t>(ctx);
+    });
+
+    manager.wait_tasks_complete();
+
+    EXPECT_NE(nullptr, ctx_pool.load());
+    EXPECT_LT(ctx_index.load(), manager.max_threads_count());
+
+    EXPECT_EQ(async::pool::unknown_ctx, async::pool::current_ctx());
+}
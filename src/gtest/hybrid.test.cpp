@@ -0,0 +1,134 @@
+#include "pch.h"
+
+#include <async.hpp>
+
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <vector>
+
+
+TEST(hybrid, core_and_burst)
+{
+    async::manager manager{ async::make_manager<async::pool_threads::hybrid>(1, 4, std::chrono::milliseconds{ 50 }, nullptr) };
+
+    EXPECT_EQ(std::size_t{ 4 }, manager.max_threads_count());
+    EXPECT_TRUE(manager.wait_tasks_complete_for(std::chrono::seconds{ 5 })); // The core thread is started
+
+    std::atomic<int> count{ 0 };
+
+    for (int index = 0; index < 100; ++index)
+    {
+        manager.task(L"task"s, [&count]
+        {
+            std::this_thread::sleep_for(std::chrono::microseconds{ 100 });
+            count += 1;
+        });
+    }
+
+    manager.wait_tasks_complete();
+    EXPECT_EQ(100, count.load());
+    EXPECT_EQ(std::size_t{ 0 }, manager.busy_threads_count());
+}
+
+TEST(hybrid, burst_threads_retire)
+{
+    async::pool_threads::hybrid pool{ 2, 8, std::chrono::milliseconds{ 20 }, nullptr };
+    EXPECT_EQ(std::size_t{ 2 }, pool.running_threads_count());
+
+    std::atomic<int> count{ 0 };
+
+    for (int index = 0; index < 64; ++index)
+    {
+        pool.add_task(async::pool::unknown_ctx, [&count](async::pool::ctx_t)
+        {
+            std::this_thread::sleep_for(std::chrono::milliseconds{ 1 });
+            count += 1;
+        });
+    }
+
+    EXPECT_TRUE(pool.wait_tasks_complete());
+    EXPECT_EQ(64, count.load());
+
+    std::this_thread::sleep_for(std::chrono::milliseconds{ 200 });
+    EXPECT_EQ(std::size_t{ 2 }, pool.running_threads_count());
+
+    pool.stop_threads_and_wait_them_complete();
+    EXPECT_EQ(std::size_t{ 0 }, pool.running_threads_count());
+
+    pool.resume_threads();
+    EXPECT_EQ(std::size_t{ 2 }, pool.running_threads_count());
+}
+
+TEST(hybrid, burst_threads_from_many_producers)
+{
+    async::pool_threads::hybrid pool{ 1, 16, std::chrono::milliseconds{ 1 }, nullptr };
+
+    std::atomic<int> count{ 0 };
+
+    for (int round = 0; round < 10; ++round)
+    {
+        std::vector<std::thread> producers;
+
+        for (int producer = 0; producer < 4; ++producer)
+        {
+            producers.emplace_back([&pool, &count]
+            {
+                for (int index = 0; index < 100; ++index)
+                {
+                    pool.add_task(async::pool::unknown_ctx, [&count](async::pool::ctx_t)
+                    {
+                        std::this_thread::sleep_for(std::chrono::microseconds{ 50 });
+                        count += 1;
+                    });
+                }
+            });
+        }
+
+        for (std::thread& producer : producers)
+            producer.join();
+
+        // The burst threads, which are being started by the producers, are joined too
+        pool.stop_threads_and_wait_them_complete();
+        EXPECT_EQ(std::size_t{ 0 }, pool.running_threads_count());
+
+        pool.resume_threads();
+    }
+
+    EXPECT_TRUE(pool.wait_tasks_complete());
+    EXPECT_EQ(10 * 4 * 100, count.load());
+}
+
+TEST(hybrid, burst_threads_follow_queue_pressure)
+{
+    constexpr std::size_t tasks_count{ 8 };
+
+    // The tasks are added while the core thread is still starting
+    async::pool_threads::hybrid pool{ 1, 64, std::chrono::seconds{ 5 }, nullptr };
+
+    std::atomic<std::size_t> started{ 0 };
+    std::atomic<bool> release{ false };
+
+    const auto deadline{ std::chrono::steady_clock::now() + std::chrono::seconds{ 10 } };
+
+    for (std::size_t index = 0; index < tasks_count; ++index)
+    {
+        pool.add_task(async::pool::unknown_ctx, [&started, &release, deadline](async::pool::ctx_t)
+        {
+            started += 1;
+
+            while (!release.load() && std::chrono::steady_clock::now() < deadline)
+                std::this_thread::sleep_for(std::chrono::milliseconds{ 1 });
+        });
+    }
+
+    while (started.load() < tasks_count && std::chrono::steady_clock::now() < deadline)
+        std::this_thread::sleep_for(std::chrono::milliseconds{ 1 });
+
+    // A thread per task, the reserved threads are not reserved again by the next tasks
+    EXPECT_EQ(tasks_count, started.load());
+    EXPECT_LE(pool.running_threads_count(), tasks_count);
+
+    release = true;
+    EXPECT_TRUE(pool.wait_tasks_complete());
+}
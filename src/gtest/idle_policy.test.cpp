@@ -0,0 +1,125 @@
+#include "pch.h"
+
+#include <async.hpp>
+
+#include <atomic>
+#include <chrono>
+#include <thread>
+
+
+namespace
+{
+    using spinner_t = async::details::idle_spinner;
+
+    // The spinner is disabled on the single CPU: the tests pretend there are several of them
+    constexpr unsigned hardware_threads_count{ 4 };
+
+} // namespace
+
+
+TEST(idle_policy, spinner_disabled)
+{
+    EXPECT_FALSE(spinner_t(async::idle_policy::park(), hardware_threads_count).enabled());
+    EXPECT_FALSE(spinner_t(async::idle_policy::low_latency(), 1).enabled());
+
+    spinner_t spinner{ async::idle_policy::park(), hardware_threads_count };
+
+    // Does not spin and does not look at the readiness at all
+    bool asked{ false };
+    EXPECT_FALSE(spinner.spin([&asked] { asked = true; return true; }));
+    EXPECT_FALSE(asked);
+}
+
+TEST(idle_policy, spinner_hits_shrink_budget)
+{
+    const async::idle_policy policy{ std::chrono::seconds{ 1 }, 0 };
+    spinner_t spinner{ policy, hardware_threads_count };
+
+    ASSERT_TRUE(spinner.enabled());
+    EXPECT_EQ(policy.spin_max, spinner.budget());
+
+    // The tasks come at once: the budget goes down to its lower bound, but not below it
+    for (int index = 0; index < 100; ++index)
+    {
+        EXPECT_TRUE(spinner.spin([] { return true; }));
+
+        EXPECT_GE(spinner.budget(), policy.spin_max / 16);
+        EXPECT_LE(spinner.budget(), policy.spin_max);
+    }
+
+    EXPECT_EQ(policy.spin_max / 16, spinner.budget());
+}
+
+TEST(idle_policy, spinner_late_hits_grow_budget)
+{
+    const async::idle_policy policy{ std::chrono::milliseconds{ 200 }, 0 };
+    spinner_t spinner{ policy, hardware_threads_count };
+
+    for (int index = 0; index < 20; ++index)
+        ASSERT_TRUE(spinner.spin([] { return true; }));
+
+    ASSERT_EQ(policy.spin_max / 16, spinner.budget());
+
+    // The tasks come after 10ms of spinning: the budget grows above the lower bound to twice the average waiting
+    for (int index = 0; index < 8; ++index)
+    {
+        EXPECT_TRUE(spinner.spin([] { std::this_thread::sleep_for(std::chrono::milliseconds{ 10 }); return true; }));
+
+        EXPECT_GE(spinner.budget(), policy.spin_max / 16);
+        EXPECT_LE(spinner.budget(), policy.spin_max);
+    }
+
+    EXPECT_GT(spinner.budget(), policy.spin_max / 16);
+}
+
+TEST(idle_policy, spinner_misses_turn_off_budget)
+{
+    const async::idle_policy policy{ std::chrono::milliseconds{ 1 }, 4 };
+    spinner_t spinner{ policy, hardware_threads_count };
+
+    // No task during the whole budget: the thread parks, the task comes much later than the budget
+    int ready_checks{ 0 };
+    EXPECT_FALSE(spinner.spin([&ready_checks] { ++ready_checks; return false; }));
+    EXPECT_GT(ready_checks, 0);
+
+    std::this_thread::sleep_for(std::chrono::milliseconds{ 20 });
+    spinner.wake_up();
+
+    // The average waiting is longer than spin_max: the thread parks at once
+    EXPECT_EQ(std::chrono::nanoseconds::zero(), spinner.budget());
+
+    ready_checks = 0;
+    EXPECT_FALSE(spinner.spin([&ready_checks] { ++ready_checks; return true; }));
+    EXPECT_EQ(0, ready_checks);
+
+    // The parked thread gets the tasks at once again: the budget comes back within its bounds
+    for (int index = 0; index < 100 && spinner.budget() == std::chrono::nanoseconds::zero(); ++index)
+    {
+        EXPECT_FALSE(spinner.spin([] { return true; }));
+        spinner.wake_up();
+    }
+
+    EXPECT_GE(spinner.budget(), policy.spin_max / 16);
+    EXPECT_LE(spinner.budget(), policy.spin_max);
+}
+
+TEST(idle_policy, low_latency)
+{
+    async::manager manager{ async::make_manager<async::pool_threads::always>(2, nullptr, async::idle_policy::low_latency()) };
+
+    std::atomic<int> count{ 0 };
+
+    // Ping-pong chain: every next step is added, when the previous one is completed
+    async::promise<int> prom{ manager.resolve(L"chain"s, 0) };
+    for (int index = 0; index < 1000; ++index)
+        prom = prom.success<int>([&count](int value) { count += 1; return value + 1; });
+
+    std::atomic<int> result{ 0 };
+    prom.success<void>([&result](int value) { result = value; });
+
+    manager.wait_tasks_complete();
+
+    EXPECT_EQ(1000, count.load());
+    EXPECT_EQ(1000, result.load());
+    EXPECT_EQ(std::size_t{ 0 }, manager.busy_threads_count());
+}
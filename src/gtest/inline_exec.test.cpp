@@ -0,0 +1,53 @@
+#include "pch.h"
+
+#include <async.hpp>
+
+#include <atomic>
+#include <thread>
+
+
+TEST(inline_exec, resolved_promise)
+{
+    async::manager manager{ async::make_manager<async::pool_threads::always>(1, nullptr) };
+
+    int result{ 0 };
+    std::thread::id thread_id{};
+
+    async::promise<int> prom{ manager.resolve(L"value"s, 1) };
+    EXPECT_EQ(async::pool::exec_t::queued, prom.exec());
+
+    // The next step of the ready promise is executed at once in this thread
+    prom.success<void>(async::inline_exec, [&result, &thread_id](int value)
+    {
+        result = value;
+        thread_id = std::this_thread::get_id();
+    });
+
+    EXPECT_EQ(1, result);
+    EXPECT_EQ(std::this_thread::get_id(), thread_id);
+
+    manager.wait_tasks_complete();
+}
+
+TEST(inline_exec, pool_default_and_depth_guard)
+{
+    async::manager manager{ async::make_manager<async::pool_threads::always>(2, nullptr) };
+    manager.set_continuations_exec(async::pool::exec_t::inline_exec);
+
+    async::promise<int> prom{ manager.task<int>(L"task"s, [] { return 0; }) };
+    EXPECT_EQ(async::pool::exec_t::inline_exec, prom.exec());
+
+    prom.set_exec(async::pool::exec_t::queued);
+    EXPECT_EQ(async::pool::exec_t::queued, prom.exec());
+
+    // The chain is longer than pool::inline_exec_depth_max: the rest goes through the queue
+    for (int index = 0; index < 1000; ++index)
+        prom = prom.success<int>([](int value) { return value + 1; });
+
+    std::atomic<int> result{ 0 };
+    prom.success<void>([&result](int value) { result = value; });
+
+    manager.wait_tasks_complete();
+
+    EXPECT_EQ(1000, result.load());
+}
@@ -0,0 +1,128 @@
+#include "pch.h"
+
+#include <async.hpp>
+
+#include <atomic>
+#include <thread>
+#include <vector>
+
+
+namespace
+{
+    struct counted_t
+    {
+        std::atomic<std::size_t> refs_count{ 1 };
+        std::atomic<int>* destroyed{ nullptr };
+    };
+
+    void intrusive_ptr_add_ref(counted_t* counted) noexcept
+    {
+        counted->refs_count.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    void intrusive_ptr_release(counted_t* counted) noexcept
+    {
+        if (counted->refs_count.fetch_sub(1, std::memory_order_acq_rel) == 1)
+        {
+            *counted->destroyed += 1;
+            delete counted;
+        }
+    }
+
+    using counted_ptr = async::details::intrusive_ptr<counted_t>;
+
+    counted_ptr make_counted(std::atomic<int>& destroyed)
+    {
+        counted_t* const counted{ new counted_t{} };
+        counted->destroyed = &destroyed;
+        return counted_ptr::adopt(counted);
+    }
+
+} // namespace
+
+
+TEST(intrusive_ptr, copy_move_reset)
+{
+    std::atomic<int> destroyed{ 0 };
+    {
+        counted_ptr first{ make_counted(destroyed) };
+        counted_ptr second{ first };
+
+        EXPECT_EQ(first, second);
+        EXPECT_EQ(2u, first->refs_count.load());
+
+        counted_ptr third{ std::move(second) };
+        EXPECT_TRUE(second == nullptr);
+        EXPECT_EQ(2u, first->refs_count.load());
+
+        first.reset();
+        EXPECT_EQ(0, destroyed.load());
+        EXPECT_EQ(1u, third->refs_count.load());
+    }
+    EXPECT_EQ(1, destroyed.load());
+}
+
+TEST(intrusive_ptr, exchange_once)
+{
+    std::atomic<int> destroyed{ 0 };
+    std::atomic<int> taken{ 0 };
+
+    for (int round = 0; round < 1000; ++round)
+    {
+        counted_ptr shared{ make_counted(destroyed) };
+
+        std::vector<std::thread> threads;
+        for (int index = 0; index < 4; ++index)
+        {
+            threads.emplace_back([&shared, &taken]
+            {
+                if (counted_ptr data = shared.exchange(nullptr))
+                    taken += 1;
+            });
+        }
+
+        for (std::thread& thread : threads)
+            thread.join();
+    }
+
+    EXPECT_EQ(1000, taken.load());
+    EXPECT_EQ(1000, destroyed.load());
+}
+
+TEST(intrusive_ptr, atomic_copy_and_exchange)
+{
+    std::atomic<int> destroyed{ 0 };
+    std::atomic<int> copied{ 0 };
+
+    for (int round = 0; round < 1000; ++round)
+    {
+        counted_ptr shared{ make_counted(destroyed) };
+
+        // The copies race with the exchange: the copy is either empty or holds the live object
+        std::vector<std::thread> threads;
+        for (int index = 0; index < 3; ++index)
+        {
+            threads.emplace_back([&shared, &copied]
+            {
+                if (const counted_ptr copy = shared.atomic_copy())
+                {
+                    EXPECT_LE(1u, copy->refs_count.load());
+                    copied += 1;
+                }
+            });
+        }
+
+        threads.emplace_back([&shared]
+        {
+            counted_ptr taken{ shared.exchange(nullptr) };
+        });
+
+        for (std::thread& thread : threads)
+            thread.join();
+
+        EXPECT_TRUE(shared == nullptr);
+    }
+
+    EXPECT_EQ(1000, destroyed.load());
+    EXPECT_GE(3000, copied.load());
+}
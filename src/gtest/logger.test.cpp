@@ -76,3 +76,72 @@ TEST_F(logger, except_nullptr)
 {
     async::log_except(m_log, nullptr, L"except"sv);
 }
+TEST(log_ctx, no_log_ctx)
+{
+    static_assert(std::is_empty_v<async::no_log_ctx>);
+    static_assert(std::is_same_v<async::log_ctx_t, std::conditional_t<async::logging_enabled, async::interned_log_ctx, async::no_log_ctx>>);
+
+    // The arguments of the public API are accepted with any policy
+    static_assert(std::is_convertible_v<std::wstring, async::no_log_ctx>);
+    static_assert(std::is_convertible_v<std::wstring_view, async::no_log_ctx>);
+    static_assert(std::is_convertible_v<const wchar_t*, async::no_log_ctx>);
+    static_assert(!std::is_convertible_v<int, async::no_log_ctx>);
+
+    const async::no_log_ctx log_ctx{ L"ctx"s };
+    EXPECT_TRUE(log_ctx.empty());
+}
+TEST(log_ctx, no_logging_state_of_promise)
+{
+    // The state of promise, as it is with the context of log
+    struct prom_data_with_log_ctx_t
+    {
+        async::pool_ptr pool;
+        async::details::result_t<int> result;
+        async::interned_log_ctx log_ctx;
+        std::atomic<std::size_t> refs_count;
+        std::pmr::memory_resource* resource;
+    };
+
+    if constexpr (async::logging_enabled)
+        EXPECT_EQ(sizeof(prom_data_with_log_ctx_t), sizeof(async::details::prom_data_t<int>));
+    else
+        EXPECT_LT(sizeof(async::details::prom_data_t<int>), sizeof(prom_data_with_log_ctx_t));
+}
+TEST(log_ctx, interned_labels)
+{
+    async::log_labels& labels{ async::log_labels::instance() };
+
+    const async::log_labels::id_t id{ labels.intern(L"interned-label"sv) };
+    EXPECT_NE(async::log_labels::empty_id, id);
+    EXPECT_EQ(id, labels.intern(L"interned-label"s));
+    EXPECT_EQ(L"interned-label"sv, labels.text(id));
+    EXPECT_EQ(async::log_labels::empty_id, labels.intern(L""sv));
+
+    // The label is normalized: the separator of the steps is replaced
+    const async::interned_log_ctx log_ctx{ L"a/b"s };
+    EXPECT_EQ(L"a\\b"s, log_ctx.str());
+    EXPECT_EQ(L"a\\b"sv, labels.text(log_ctx.label_id()));
+}
+TEST(log_ctx, interned_chain)
+{
+    async::interned_log_ctx log_ctx{ L"task"s };
+    log_ctx.add_details(L"task"sv);
+    EXPECT_EQ(L"task{task}"s, log_ctx.str());
+
+    // The steps are shared by the chains with the common beginning
+    async::interned_log_ctx log_ctx_copy{ log_ctx };
+    log_ctx_copy.add_details(L"sync"sv);
+    EXPECT_EQ(L"task{task|sync}"s, log_ctx_copy.str());
+    EXPECT_EQ(L"task{task}"s, log_ctx.str());
+
+    log_ctx.append(L"next"s);
+    log_ctx.add_details(L"fnly"sv);
+    log_ctx.add_details(L"scss"sv);
+    EXPECT_EQ(L"task{task}/next{scss|fnly}"s, log_ctx.str());
+
+    log_ctx.append({});
+    EXPECT_EQ(L"task{task}/next{scss|fnly}/"s, log_ctx.str());
+    EXPECT_EQ(L"task{task|sync}"s, log_ctx_copy.str());
+
+    EXPECT_EQ(L"[task{task|sync}]"s, async::log_details::make_string(L'[', log_ctx_copy, L']'));
+}
@@ -0,0 +1,87 @@
+#include "pch.h"
+
+#include <async.hpp>
+
+#include <thread>
+#include <vector>
+#include <sstream>
+#include <algorithm>
+
+
+namespace
+{
+    std::size_t lines_count(const std::wostringstream& stream)
+    {
+        const std::wstring text{ stream.str() };
+        return static_cast<std::size_t>(std::count(text.begin(), text.end(), L'\n'));
+    }
+
+    void log_from_threads(async::logger& log, int threads_count, int messages_count)
+    {
+        std::vector<std::thread> threads;
+        for (int thread_number = 0; thread_number < threads_count; ++thread_number)
+        {
+            threads.emplace_back([&log, thread_number, messages_count]
+            {
+                for (int number = 0; number < messages_count; ++number)
+                    async::log_msg(&log, L"[thread: "sv, thread_number, L"] [message: "sv, number, L']');
+            });
+        }
+
+        for (std::thread& thread : threads)
+            thread.join();
+    }
+
+} // namespace
+
+
+TEST(logger_async, flush)
+{
+    if constexpr (!async::logging_enabled)
+        GTEST_SKIP() << "The log is not written with ASYNC_LIB_NO_LOGGING";
+
+    std::wostringstream stream;
+    async::logger_async log{ stream };
+
+    {
+        const async::log_scope log_scope_guard{ &log, L"scope"sv };
+        async::log_msg(&log, L"message"sv);
+    }
+
+    log.flush();
+
+    const std::wstring text{ stream.str() };
+    EXPECT_NE(std::wstring::npos, text.find(L"--->scope"sv));
+    EXPECT_NE(std::wstring::npos, text.find(L"     message"sv)); // The level of the scope
+    EXPECT_NE(std::wstring::npos, text.find(L"<---scope"sv));
+    EXPECT_EQ(3u, lines_count(stream));
+}
+
+TEST(logger_async, block_writes_all_on_shutdown)
+{
+    if constexpr (!async::logging_enabled)
+        GTEST_SKIP() << "The log is not written with ASYNC_LIB_NO_LOGGING";
+
+    std::wostringstream stream;
+    {
+        async::logger_async log{ stream, async::logger_async::overflow_policy::block, 1024 };
+        log_from_threads(log, 4, 10000);
+        EXPECT_EQ(0u, log.dropped_count());
+    }
+
+    EXPECT_EQ(40000u, lines_count(stream));
+}
+
+TEST(logger_async, drop_counts_lost_records)
+{
+    if constexpr (!async::logging_enabled)
+        GTEST_SKIP() << "The log is not written with ASYNC_LIB_NO_LOGGING";
+
+    std::wostringstream stream;
+    async::logger_async log{ stream, async::logger_async::overflow_policy::drop, 1024 };
+
+    log_from_threads(log, 4, 10000);
+    log.flush();
+
+    EXPECT_EQ(40000u, lines_count(stream) + log.dropped_count());
+}
@@ -0,0 +1,68 @@
+#include "pch.h"
+
+#include <async.hpp>
+
+#include <atomic>
+#include <sstream>
+
+
+TEST(logger_trace, tasks_of_pool)
+{
+    std::ostringstream stream;
+    {
+        async::manager manager{ std::make_unique<async::pool_threads::always>(std::make_unique<async::logger_trace>(stream), L"trace-pool"s, 2, nullptr) };
+
+        std::atomic<int> count{ 0 };
+
+        // The inner task is added by the task of pool: the flow arrow from the outer task to the inner one
+        manager.task(L"outer"s, [&manager, &count]
+        {
+            count += 1;
+            manager.task(L"inner"s, [&count] { count += 1; });
+        });
+
+        manager.wait_tasks_complete();
+        EXPECT_EQ(2, count.load());
+    } // The trace is written by the destructor of the logger
+
+    const std::string trace{ stream.str() };
+    EXPECT_EQ(0u, trace.find("{\"traceEvents\":["));
+
+    if constexpr (!async::logging_enabled)
+        return; // The tasks are not traced with ASYNC_LIB_NO_LOGGING
+
+    EXPECT_NE(std::string::npos, trace.find("\"name\":\"trace-pool #"));
+    EXPECT_NE(std::string::npos, trace.find("\"ph\":\"b\""));
+    EXPECT_NE(std::string::npos, trace.find("\"ph\":\"s\""));
+    EXPECT_NE(std::string::npos, trace.find("\"ph\":\"f\""));
+    EXPECT_NE(std::string::npos, trace.find("\"cat\":\"task\""));
+}
+
+TEST(logger_trace, thread_alternates_loggers)
+{
+    async::pool_threads::always pool{ 1, nullptr };
+
+    std::ostringstream stream_first;
+    std::ostringstream stream_second;
+    {
+        async::logger_trace first{ stream_first };
+        async::logger_trace second{ stream_second };
+
+        // This thread runs the task of the first logger, the events of the second one come in the middle
+        first.task_dequeued(1);
+        second.message(L"second"sv);
+        first.task_enqueued(pool);
+        second.message(L"second"sv);
+        first.task_finished(1);
+    }
+
+    const std::string trace{ stream_first.str() };
+
+    // One thread of the first logger and the enqueue from the running task: the flow arrow
+    std::size_t threads_count{ 0 };
+    for (std::size_t pos = trace.find("\"thread_name\""); pos != std::string::npos; pos = trace.find("\"thread_name\"", pos + 1))
+        threads_count += 1;
+
+    EXPECT_EQ(1u, threads_count);
+    EXPECT_NE(std::string::npos, trace.find("\"ph\":\"s\""));
+}
@@ -0,0 +1,148 @@
+#include "pch.h"
+
+#include <async.hpp>
+
+#include <atomic>
+#include <thread>
+#include <vector>
+#include <algorithm>
+#include <memory_resource>
+
+
+namespace
+{
+    class counting_resource : public std::pmr::memory_resource
+    {
+    public:
+
+        std::atomic<std::size_t> allocations{ 0 };
+        std::atomic<std::ptrdiff_t> in_use{ 0 };
+
+    protected:
+
+        void* do_allocate(std::size_t bytes, std::size_t alignment) override
+        {
+            allocations += 1;
+            in_use += 1;
+            return std::pmr::new_delete_resource()->allocate(bytes, alignment);
+        }
+
+        void do_deallocate(void* ptr, std::size_t bytes, std::size_t alignment) override
+        {
+            in_use -= 1;
+            std::pmr::new_delete_resource()->deallocate(ptr, bytes, alignment);
+        }
+
+        bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override
+        {
+            return (this == &other);
+        }
+    };
+
+} // namespace
+
+
+TEST(memory_resource, pool_resource_reuses_blocks)
+{
+    counting_resource upstream;
+    {
+        async::pool_resource resource{ &upstream };
+
+        void* const first{ resource.allocate(100) };
+        resource.deallocate(first, 100);
+
+        void* const second{ resource.allocate(120) }; // The same size class
+        EXPECT_EQ(first, second);
+        resource.deallocate(second, 120);
+
+        void* const big{ resource.allocate(4096) }; // Directly from the upstream
+        resource.deallocate(big, 4096);
+
+        EXPECT_EQ(2u, upstream.allocations.load());
+    }
+    EXPECT_EQ(0, upstream.in_use.load());
+}
+
+TEST(memory_resource, pool_resource_concurrent)
+{
+    async::pool_resource resource;
+
+    std::atomic<std::size_t> errors{ 0 };
+
+    std::vector<std::thread> threads;
+    for (unsigned char thread_number = 1; thread_number <= 4; ++thread_number)
+    {
+        threads.emplace_back([&resource, &errors, thread_number]
+        {
+            std::vector<std::pair<unsigned char*, std::size_t>> blocks;
+
+            for (std::size_t index = 0; index < 100000; ++index)
+            {
+                const std::size_t bytes{ 16 + (index * 37) % 496 };
+
+                unsigned char* const block{ static_cast<unsigned char*>(resource.allocate(bytes)) };
+                std::fill_n(block, bytes, thread_number);
+                blocks.emplace_back(block, bytes);
+
+                if (blocks.size() > 64 || index % 3 == 0)
+                {
+                    const auto [last_block, last_bytes] = blocks.back();
+                    blocks.pop_back();
+
+                    if (std::count(last_block, last_block + last_bytes, thread_number) != static_cast<std::ptrdiff_t>(last_bytes))
+                        errors += 1;
+
+                    resource.deallocate(last_block, last_bytes);
+                }
+            }
+
+            for (const auto& [block, bytes] : blocks)
+                resource.deallocate(block, bytes);
+        });
+    }
+
+    for (std::thread& thread : threads)
+        thread.join();
+
+    EXPECT_EQ(0u, errors.load());
+}
+
+TEST(memory_resource, manager_chain)
+{
+    counting_resource upstream;
+    {
+        async::pool_resource resource{ &upstream };
+
+        async::manager manager{ std::make_unique<async::pool_threads::always>(2, nullptr), &resource };
+        EXPECT_EQ(&resource, manager.memory_resource());
+
+        const auto run_chain = [&manager]
+        {
+            return manager.task<int>(L"task"s, [] { return 1; })
+                .success<int>([](int value) { return value + 1; })
+                .success<int>([](int value) { return value + 1; })
+                .success<int>([](int value) { return value + 1; })
+                .success<int>([](int value) { return value + 1; });
+        };
+
+        std::atomic<int> result{ 0 };
+
+        run_chain().success<void>([&](int value) { result = value; });
+        manager.wait_tasks_complete();
+        EXPECT_EQ(5, result.load());
+
+        manager.all(run_chain(), run_chain()).success<void>([&](std::tuple<int, int> values) { result = std::get<0>(values) + std::get<1>(values); });
+        manager.wait_tasks_complete();
+        EXPECT_EQ(10, result.load());
+
+        // The blocks of the previous chains are reused: the next chain does not touch the upstream
+        const std::size_t allocations{ upstream.allocations.load() };
+
+        run_chain().success<void>([&](int value) { result = value; });
+        manager.wait_tasks_complete();
+        EXPECT_EQ(5, result.load());
+
+        EXPECT_EQ(allocations, upstream.allocations.load());
+    }
+    EXPECT_EQ(0, upstream.in_use.load());
+}
@@ -0,0 +1,433 @@
+#include "pch.h"
+
+#include <async.hpp>
+
+#include <atomic>
+#include <thread>
+#include <vector>
+#include <cstdint>
+
+
+namespace
+{
+    // The item: the number of the producer in the high bits, the number of the item of the producer in the low bits
+    constexpr std::uint64_t make_item(std::uint64_t producer, std::uint64_t number) noexcept
+    {
+        return (producer << 32) | number;
+    }
+
+    constexpr std::uint64_t producer_of(std::uint64_t item) noexcept
+    {
+        return (item >> 32);
+    }
+
+    constexpr std::uint64_t number_of(std::uint64_t item) noexcept
+    {
+        return (item & 0xFFFFFFFFu);
+    }
+
+    struct pool_access : async::pool
+    {
+        using async::pool::tasks_lockfree_t;
+    };
+
+    using tasks_lockfree_t = pool_access::tasks_lockfree_t;
+
+} // namespace
+
+
+TEST(mpmc_queue, ring_wrap_around)
+{
+    async::details::mpmc_queue<int> queue{ 4 };
+    EXPECT_EQ(std::size_t{ 4 }, queue.capacity());
+
+    // The indexes of the ring go round many times, the order is kept
+    int next_push{ 0 };
+    int next_pop{ 0 };
+
+    for (int round = 0; round < 100; ++round)
+    {
+        for (int index = 0; index < 3; ++index)
+        {
+            int item{ next_push++ };
+            EXPECT_TRUE(queue.try_push(item));
+        }
+
+        for (int index = 0; index < 3; ++index)
+        {
+            int item{ -1 };
+            EXPECT_TRUE(queue.try_pop(item));
+            EXPECT_EQ(next_pop++, item);
+        }
+    }
+
+    int item{ -1 };
+    EXPECT_FALSE(queue.try_pop(item));
+    EXPECT_TRUE(queue.empty_approx());
+}
+
+TEST(mpmc_queue, try_push_fails_at_capacity)
+{
+    async::details::mpmc_queue<int> queue{ 4 };
+
+    for (int index = 0; index < 4; ++index)
+    {
+        int item{ index };
+        EXPECT_TRUE(queue.try_push(item));
+    }
+
+    int item{ 4 };
+    EXPECT_FALSE(queue.try_push(item));
+    EXPECT_EQ(4, item); // The item is not taken
+    EXPECT_EQ(std::size_t{ 4 }, queue.size_approx());
+
+    int popped{ -1 };
+    EXPECT_TRUE(queue.try_pop(popped));
+    EXPECT_EQ(0, popped);
+
+    EXPECT_TRUE(queue.try_push(item));
+    EXPECT_FALSE(queue.try_push(item));
+}
+
+TEST(mpmc_queue, overflow_and_back)
+{
+    async::details::mpmc_queue<int> queue{ 4 };
+
+    // The ring is full: the next items go to the overflow
+    for (int index = 0; index < 10; ++index)
+        queue.push(index);
+
+    EXPECT_EQ(std::size_t{ 10 }, queue.size_approx());
+
+    // The ring has room, but the overflow is not empty: the item follows the overflow
+    int item{ -1 };
+    EXPECT_TRUE(queue.try_pop(item));
+    EXPECT_EQ(0, item);
+    queue.push(10);
+
+    for (int index = 1; index <= 10; ++index)
+    {
+        EXPECT_TRUE(queue.try_pop(item));
+        EXPECT_EQ(index, item);
+    }
+
+    EXPECT_FALSE(queue.try_pop(item));
+    EXPECT_TRUE(queue.empty_approx());
+
+    // The overflow is empty: the ring is used again
+    for (int index = 0; index < 4; ++index)
+    {
+        item = index;
+        EXPECT_TRUE(queue.try_push(item));
+    }
+
+    item = 4;
+    EXPECT_FALSE(queue.try_push(item));
+}
+
+TEST(mpmc_queue, fifo_of_producer_through_overflow)
+{
+    // The small ring: the producers go to the overflow and back many times
+    async::details::mpmc_queue<std::uint64_t> queue{ 8 };
+
+    constexpr std::uint64_t producers_count{ 4 };
+    constexpr std::uint64_t items_count{ 20000 };
+
+    std::vector<std::thread> producers;
+
+    for (std::uint64_t producer = 0; producer < producers_count; ++producer)
+    {
+        producers.emplace_back([&queue, producer]
+        {
+            for (std::uint64_t number = 0; number < items_count; ++number)
+                queue.push(make_item(producer, number));
+        });
+    }
+
+    // One consumer: the items of every producer are taken in the order of their pushes
+    std::vector<std::uint64_t> next_numbers(producers_count, 0);
+    bool in_order{ true };
+
+    for (std::uint64_t taken = 0; taken < producers_count * items_count; )
+    {
+        std::uint64_t item{ 0 };
+
+        if (!queue.try_pop(item))
+        {
+            std::this_thread::yield();
+            continue;
+        }
+
+        std::uint64_t& next_number{ next_numbers[producer_of(item)] };
+
+        in_order = in_order && (number_of(item) == next_number);
+        next_number = number_of(item) + 1;
+        taken += 1;
+    }
+
+    for (std::thread& producer : producers)
+        producer.join();
+
+    EXPECT_TRUE(in_order);
+
+    for (std::uint64_t producer = 0; producer < producers_count; ++producer)
+        EXPECT_EQ(items_count, next_numbers[producer]);
+
+    std::uint64_t item{ 0 };
+    EXPECT_FALSE(queue.try_pop(item));
+}
+
+TEST(mpmc_queue, concurrent_push_pop)
+{
+    async::details::mpmc_queue<std::uint64_t> queue{ 64 };
+
+    constexpr std::uint64_t producers_count{ 4 };
+    constexpr std::uint64_t consumers_count{ 4 };
+    constexpr std::uint64_t items_count{ 50000 };
+
+    std::atomic<std::uint64_t> taken_count{ 0 };
+    std::atomic<std::uint64_t> taken_sum{ 0 };
+
+    std::vector<std::thread> threads;
+
+    for (std::uint64_t producer = 0; producer < producers_count; ++producer)
+    {
+        threads.emplace_back([&queue, producer]
+        {
+            for (std::uint64_t number = 0; number < items_count; ++number)
+            {
+                std::uint64_t item{ make_item(producer, number) };
+
+                // The bounded path and the overflow path both
+                if (number % 2 == 0 || !queue.try_push(item))
+                    queue.push(item);
+            }
+        });
+    }
+
+    for (std::uint64_t consumer = 0; consumer < consumers_count; ++consumer)
+    {
+        threads.emplace_back([&queue, &taken_count, &taken_sum]
+        {
+            while (taken_count.load() < producers_count * items_count)
+            {
+                std::uint64_t item{ 0 };
+
+                if (queue.try_pop(item))
+                {
+                    taken_sum += number_of(item);
+                    taken_count += 1;
+                }
+                else
+                    std::this_thread::yield();
+            }
+        });
+    }
+
+    for (std::thread& thread : threads)
+        thread.join();
+
+    EXPECT_EQ(producers_count * items_count, taken_count.load());
+    EXPECT_EQ(producers_count * (items_count * (items_count - 1) / 2), taken_sum.load());
+    EXPECT_TRUE(queue.empty_approx());
+}
+
+
+TEST(mpmc_lanes, fifo_inside_lane)
+{
+    async::details::mpmc_lanes<int, 3> lanes;
+
+    // More items than the ring of a lane: the lane spills to its overflow
+    for (int index = 0; index < 3000; ++index)
+        lanes.push(index, 1);
+
+    lanes.push(-1, 0);
+    EXPECT_EQ(std::size_t{ 3001 }, lanes.size_approx());
+    EXPECT_TRUE(lanes.empty_approx(2));
+
+    int item{ 0 };
+    EXPECT_TRUE(lanes.try_pop(item));
+    EXPECT_EQ(-1, item); // The upper lane first
+
+    for (int index = 0; index < 3000; ++index)
+    {
+        EXPECT_TRUE(lanes.try_pop(item));
+        EXPECT_EQ(index, item);
+    }
+
+    EXPECT_FALSE(lanes.try_pop(item));
+    EXPECT_TRUE(lanes.empty_approx());
+}
+
+TEST(mpmc_lanes, aging_of_lower_lane)
+{
+    async::details::mpmc_lanes<int, 3> lanes;
+
+    for (int index = 0; index < 100; ++index)
+        lanes.push(index, 0);
+
+    lanes.push(1000, 2);
+
+    // The lower lane is not starved by the upper one
+    int item{ 0 };
+    bool lower_taken{ false };
+
+    for (int index = 0; index < 100 && !lower_taken; ++index)
+    {
+        EXPECT_TRUE(lanes.try_pop(item));
+        lower_taken = (item == 1000);
+    }
+
+    EXPECT_TRUE(lower_taken);
+}
+
+TEST(mpmc_lanes, concurrent_push_pop)
+{
+    async::details::mpmc_lanes<std::uint64_t, 3> lanes;
+
+    constexpr std::uint64_t producers_count{ 3 };
+    constexpr std::uint64_t items_count{ 30000 };
+
+    std::atomic<std::uint64_t> taken_count{ 0 };
+    std::vector<std::atomic<std::uint64_t>> taken_by_lanes(3);
+
+    std::vector<std::thread> threads;
+
+    for (std::uint64_t producer = 0; producer < producers_count; ++producer)
+    {
+        threads.emplace_back([&lanes, producer]
+        {
+            for (std::uint64_t number = 0; number < items_count; ++number)
+                lanes.push(make_item(producer, number), producer);
+        });
+    }
+
+    for (std::size_t consumer = 0; consumer < 3; ++consumer)
+    {
+        threads.emplace_back([&lanes, &taken_count, &taken_by_lanes]
+        {
+            while (taken_count.load() < producers_count * items_count)
+            {
+                std::uint64_t item{ 0 };
+
+                if (lanes.try_pop(item))
+                {
+                    taken_by_lanes[producer_of(item)] += 1;
+                    taken_count += 1;
+                }
+                else
+                    std::this_thread::yield();
+            }
+        });
+    }
+
+    for (std::thread& thread : threads)
+        thread.join();
+
+    for (std::size_t lane = 0; lane < 3; ++lane)
+        EXPECT_EQ(items_count, taken_by_lanes[lane].load());
+
+    EXPECT_TRUE(lanes.empty_approx());
+}
+
+
+TEST(tasks_lockfree, queue_and_out_of_queue)
+{
+    tasks_lockfree_t tasks;
+    tasks.out_of_queue_by_threads.resize(2);
+
+    std::vector<int> order;
+
+    tasks.add_task_in_queue([&order](async::pool::ctx_t) { order.push_back(1); }, async::pool::priority_t::normal);
+    tasks.add_task_in_queue([&order](async::pool::ctx_t) { order.push_back(2); }, async::pool::priority_t::normal);
+    tasks.add_task_in_queue([&order](async::pool::ctx_t) { order.push_back(0); }, async::pool::priority_t::critical);
+    tasks.set_task_out_of_queue(1, [&order](async::pool::ctx_t) { order.push_back(-1); });
+
+    EXPECT_EQ(std::size_t{ 3 }, tasks.queue_size());
+    EXPECT_TRUE(tasks.out_of_queue_is_exists(1));
+    EXPECT_FALSE(tasks.out_of_queue_is_exists(0));
+    EXPECT_FALSE(tasks.queue_is_empty_above(async::pool::priority_t::normal));
+
+    // The task out of the queue is taken by its thread only, before the queue
+    for (async::pool::task_t task{}; tasks.try_take_next_task(1, task); task = nullptr)
+        task(async::pool::unknown_ctx);
+
+    EXPECT_EQ((std::vector<int>{ -1, 0, 1, 2 }), order);
+    EXPECT_FALSE(tasks.tasks_is_exists());
+}
+
+TEST(tasks_lockfree, move_extra_tasks_in_begin_queue)
+{
+    tasks_lockfree_t tasks;
+    tasks.out_of_queue_by_threads.resize(2);
+
+    std::vector<int> order;
+
+    // More tasks than the ring of the lane: the part of them is in the overflow
+    for (int index = 1; index <= 2000; ++index)
+        tasks.add_task_in_queue([&order, index](async::pool::ctx_t) { order.push_back(index); }, async::pool::priority_t::critical);
+
+    tasks.set_task_out_of_queue(0, [&order](async::pool::ctx_t) { order.push_back(0); });
+
+    // The stopped pool: the task out of the queue goes before all tasks of the queue
+    tasks.move_extra_tasks_in_begin_queue();
+
+    EXPECT_FALSE(tasks.out_of_queue_is_exists(0));
+    EXPECT_EQ(std::size_t{ 2001 }, tasks.queue_size());
+
+    for (async::pool::task_t task{}; tasks.try_take_next_task(1, task); task = nullptr)
+        task(async::pool::unknown_ctx);
+
+    ASSERT_EQ(std::size_t{ 2001 }, order.size());
+
+    for (int index = 0; index <= 2000; ++index)
+        EXPECT_EQ(index, order[static_cast<std::size_t>(index)]);
+}
+
+TEST(tasks_lockfree, concurrent_add_and_take)
+{
+    tasks_lockfree_t tasks;
+    tasks.out_of_queue_by_threads.resize(4);
+
+    constexpr int producers_count{ 4 };
+    constexpr int tasks_count{ 20000 };
+
+    std::atomic<int> executed{ 0 };
+    std::atomic<int> taken{ 0 };
+
+    std::vector<std::thread> threads;
+
+    for (int producer = 0; producer < producers_count; ++producer)
+    {
+        threads.emplace_back([&tasks, &executed, producer]
+        {
+            for (int index = 0; index < tasks_count; ++index)
+                tasks.add_task_in_queue([&executed](async::pool::ctx_t) { executed += 1; }, static_cast<async::pool::priority_t>(producer % 3));
+        });
+    }
+
+    for (std::size_t thread_index = 0; thread_index < 4; ++thread_index)
+    {
+        threads.emplace_back([&tasks, &taken, thread_index]
+        {
+            while (taken.load() < producers_count * tasks_count)
+            {
+                async::pool::task_t task{};
+
+                if (tasks.try_take_next_task(thread_index, task))
+                {
+                    task(async::pool::unknown_ctx);
+                    taken += 1;
+                }
+                else
+                    std::this_thread::yield();
+            }
+        });
+    }
+
+    for (std::thread& thread : threads)
+        thread.join();
+
+    EXPECT_EQ(producers_count * tasks_count, executed.load());
+    EXPECT_FALSE(tasks.tasks_is_exists());
+}
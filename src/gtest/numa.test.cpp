@@ -0,0 +1,54 @@
+#include "pch.h"
+
+#include <async.hpp>
+
+#include <atomic>
+#include <vector>
+
+
+TEST(numa, topology)
+{
+    const std::vector<async::numa_node> nodes{ async::numa_topology() };
+
+    ASSERT_FALSE(nodes.empty());
+    for (const async::numa_node& node : nodes)
+        EXPECT_FALSE(node.cpus.empty());
+}
+
+TEST(numa, single_node)
+{
+    async::manager manager{ async::make_manager<async::pool_threads::numa>(hardware_thread_count, nullptr) };
+
+    EXPECT_EQ(hardware_thread_count, manager.max_threads_count());
+    EXPECT_TRUE(manager.wait_tasks_complete_for(async::pool::wait_time_zero));
+
+    manager.stop_threads_and_wait_them_complete();
+    EXPECT_EQ(std::size_t{ 0 }, manager.busy_threads_count());
+
+    manager.resume_threads();
+    manager.wait_tasks_complete();
+}
+
+TEST(numa, several_nodes)
+{
+    // The nodes are made up: the pool does not depend on the real topology
+    std::vector<async::numa_node> nodes{ { 0, { 0 } }, { 1, { 0 } }, { 2, { 0 } } };
+
+    async::manager manager{ async::make_manager<async::pool_threads::numa>(nullptr, std::wstring{}, 4, std::move(nodes), nullptr) };
+    EXPECT_EQ(std::size_t{ 4 }, manager.max_threads_count());
+
+    std::vector<async::promise<int>> promises;
+    for (int value = 1; value <= 100; ++value)
+        promises.push_back(manager.resolve(L"item"s, value));
+
+    std::atomic<int> sum{ 0 };
+
+    manager.all(L"all"s, std::move(promises)).success<void>([&sum](std::vector<int> values)
+    {
+        for (const int value : values)
+            sum += value;
+    });
+
+    manager.wait_tasks_complete();
+    EXPECT_EQ(5050, sum.load());
+}
@@ -4,6 +4,10 @@
 
 #include <async.hpp>
 
+#include <atomic>
+#include <chrono>
+#include <thread>
+
 
 namespace
 {
@@ -39,4 +43,44 @@ TEST_F(ondemand, 2)
 {
     EXPECT_EQ(hardware_thread_count, m_manager.max_threads_count());
     EXPECT_EQ(std::size_t{ 0 }, m_manager.busy_threads_count());
-}
\ No newline at end of file
+}
+
+TEST(ondemand_many_threads, more_than_32)
+{
+    const std::size_t threads_count{ 100 };
+
+    async::manager manager{ async::make_manager<async::pool_threads::ondemand>(threads_count, waiting_time_new_tasks, nullptr) };
+    EXPECT_EQ(threads_count, manager.max_threads_count());
+    EXPECT_EQ(std::size_t{ 0 }, manager.busy_threads_count());
+
+    std::atomic<std::size_t> started{ 0 };
+    std::atomic<std::size_t> completed{ 0 };
+    std::atomic<bool> release{ false };
+
+    // Each task holds its thread until all of them are started: more than 32 threads are busy at once
+    const auto deadline{ std::chrono::steady_clock::now() + std::chrono::seconds{ 10 } };
+
+    for (std::size_t index = 0; index < threads_count; ++index)
+    {
+        manager.task(L"task"s, [&started, &completed, &release, deadline]
+        {
+            started += 1;
+
+            while (!release.load() && std::chrono::steady_clock::now() < deadline)
+                std::this_thread::sleep_for(std::chrono::milliseconds{ 1 });
+
+            completed += 1;
+        });
+    }
+
+    while (started.load() < threads_count && std::chrono::steady_clock::now() < deadline)
+        std::this_thread::sleep_for(std::chrono::milliseconds{ 1 });
+
+    EXPECT_EQ(threads_count, started.load());
+    EXPECT_GT(manager.busy_threads_count(), std::size_t{ 32 });
+
+    release = true;
+
+    manager.wait_tasks_complete();
+    EXPECT_EQ(threads_count, completed.load());
+}
@@ -0,0 +1,115 @@
+#include "pch.h"
+
+#include <async.hpp>
+
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <vector>
+
+
+namespace
+{
+    template<class _PoolImpl, class... _PoolArgs>
+    void check_tasks_counted(_PoolArgs&&... pool_args)
+    {
+        async::manager manager{ async::make_manager<_PoolImpl>(std::forward<_PoolArgs>(pool_args)...) };
+
+        std::atomic<int> count{ 0 };
+
+        for (int index = 0; index < 100; ++index)
+            manager.task(L"task"s, [&count] { count += 1; });
+
+        manager.wait_tasks_complete();
+        EXPECT_EQ(100, count.load());
+
+        const async::pool_stats stats{ manager.stats() };
+
+        EXPECT_GE(stats.tasks_enqueued, 100u);
+        EXPECT_EQ(stats.tasks_enqueued, stats.tasks_dequeued);
+        EXPECT_EQ(stats.tasks_dequeued, stats.tasks_executed);
+        EXPECT_EQ(0u, stats.queue_depth);
+        EXPECT_GE(stats.park_count, stats.wake_count);
+    }
+
+} // namespace
+
+
+TEST(pool_stats, always)
+{
+    check_tasks_counted<async::pool_threads::always>(2, nullptr);
+}
+
+TEST(pool_stats, ondemand)
+{
+    check_tasks_counted<async::pool_threads::ondemand>(2, async::pool_threads::ondemand::waiting_time_new_tasks_default(), nullptr);
+}
+
+TEST(pool_stats, hybrid)
+{
+    check_tasks_counted<async::pool_threads::hybrid>(1, 2, async::pool_threads::hybrid::keep_alive_default(), nullptr);
+}
+
+TEST(pool_stats, numa)
+{
+    check_tasks_counted<async::pool_threads::numa>(2, nullptr);
+}
+
+TEST(pool_stats, stealing)
+{
+    check_tasks_counted<async::pool_threads::stealing>(2, nullptr);
+}
+
+TEST(pool_stats, queue_depth_and_wait_time)
+{
+    async::manager manager{ async::make_manager<async::pool_threads::always>(2, nullptr) };
+
+    manager.stop_threads_and_wait_them_complete();
+
+    const async::pool_stats before{ manager.stats() };
+
+    std::atomic<int> count{ 0 };
+
+    for (int index = 0; index < 10; ++index)
+        manager.task(L"task"s, [&count] { count += 1; });
+
+    // The tasks wait in the queue of the stopped pool
+    std::this_thread::sleep_for(std::chrono::milliseconds{ 10 });
+
+    const async::pool_stats stopped{ manager.stats() };
+    EXPECT_EQ(before.queue_depth + 10, stopped.queue_depth);
+    EXPECT_GE(stopped.wait_time - before.wait_time, std::chrono::milliseconds{ 10 * 10 });
+
+    manager.resume_threads();
+    manager.wait_tasks_complete();
+    EXPECT_EQ(10, count.load());
+
+    const async::pool_stats resumed{ manager.stats() };
+    EXPECT_EQ(0u, resumed.queue_depth);
+    EXPECT_EQ(resumed.tasks_enqueued, resumed.tasks_executed);
+    EXPECT_GE(resumed.wait_time, stopped.wait_time);
+}
+
+TEST(pool_stats, many_external_producers)
+{
+    // The producers out of the pool share the few slots of counters and do not wait for each other
+    async::details::pool_counters counters{ 2 };
+
+    std::vector<std::thread> producers;
+
+    for (int producer = 0; producer < 16; ++producer)
+    {
+        producers.emplace_back([&counters]
+        {
+            for (int index = 0; index < 10000; ++index)
+                counters.enqueued(async::details::pool_counters::external_thread, 2);
+        });
+    }
+
+    for (std::thread& producer : producers)
+        producer.join();
+
+    const async::pool_stats stats{ counters.snapshot() };
+    EXPECT_EQ(16u * 10000u * 2u, stats.tasks_enqueued);
+    EXPECT_EQ(16u * 10000u * 2u, stats.queue_depth);
+}
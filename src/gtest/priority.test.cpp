@@ -0,0 +1,54 @@
+#include "pch.h"
+
+#include <async.hpp>
+
+#include <mutex>
+#include <string>
+
+
+TEST(priority, inherited_by_next_steps)
+{
+    async::manager manager{ async::make_manager<async::pool_threads::always>(1, nullptr) };
+
+    async::promise<int> prom{ manager.task<int>(L"task"s, [] { return 1; }, async::pool::priority_t::critical) };
+    EXPECT_EQ(async::pool::priority_t::critical, prom.priority());
+
+    async::promise<int> prom_next{ prom.success<int>([](int value) { return value + 1; }) };
+    EXPECT_EQ(async::pool::priority_t::critical, prom_next.priority());
+
+    prom_next.set_priority(async::pool::priority_t::background);
+
+    async::promise<void> prom_last{ prom_next.success<void>([](int) {}) };
+    EXPECT_EQ(async::pool::priority_t::background, prom_last.priority());
+
+    manager.wait_tasks_complete();
+}
+
+TEST(priority, critical_first)
+{
+    async::manager manager{ async::make_manager<async::pool_threads::always>(1, nullptr) };
+    manager.stop_threads_and_wait_them_complete();
+
+    std::mutex order_access;
+    std::string order;
+
+    const auto add = [&](char label, async::pool::priority_t priority)
+    {
+        manager.task(L"task"s, [&order_access, &order, label]
+        {
+            const std::lock_guard<std::mutex> lk{ order_access };
+            order += label;
+        }, priority);
+    };
+
+    add('b', async::pool::priority_t::background);
+    add('n', async::pool::priority_t::normal);
+    add('c', async::pool::priority_t::critical);
+    add('n', async::pool::priority_t::normal);
+    add('c', async::pool::priority_t::critical);
+
+    manager.resume_threads();
+    manager.wait_tasks_complete();
+
+    EXPECT_EQ("ccnnb"s, order);
+}
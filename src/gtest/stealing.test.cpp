@@ -0,0 +1,107 @@
+#include "pch.h"
+
+#include <async.hpp>
+
+#include <set>
+#include <mutex>
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <vector>
+
+
+struct stealing : testing::Test
+{
+protected:
+
+    virtual void SetUp() override
+    {
+        m_manager = async::make_manager<async::pool_threads::stealing>(hardware_thread_count, nullptr);
+    }
+    virtual void TearDown() override
+    {
+        m_manager = async::manager{};
+    }
+
+protected:
+
+    async::manager m_manager;
+};
+
+TEST_F(stealing, 1)
+{
+    EXPECT_EQ(hardware_thread_count, m_manager.max_threads_count());
+    EXPECT_TRUE(m_manager.wait_tasks_complete_for(async::pool::wait_time_zero));
+}
+
+TEST_F(stealing, stop_and_resume)
+{
+    m_manager.stop_threads_and_wait_them_complete();
+    EXPECT_EQ(std::size_t{ 0 }, m_manager.busy_threads_count());
+
+    m_manager.resume_threads();
+    m_manager.wait_tasks_complete();
+    EXPECT_EQ(hardware_thread_count, m_manager.max_threads_count());
+}
+
+TEST_F(stealing, all_of_resolved)
+{
+    std::vector<async::promise<int>> promises;
+    for (int value = 1; value <= 100; ++value)
+        promises.push_back(m_manager.resolve(L"item"s, value));
+
+    std::atomic<int> sum{ 0 };
+
+    m_manager.all(L"all"s, std::move(promises)).success<void>([&sum](std::vector<int> values)
+    {
+        for (const int value : values)
+            sum += value;
+    });
+
+    m_manager.wait_tasks_complete();
+    EXPECT_EQ(5050, sum.load());
+}
+
+TEST_F(stealing, subtasks_of_task_are_stolen)
+{
+    // Several threads even on the single core: the spawner thread is busy, the others steal
+    async::manager manager{ async::make_manager<async::pool_threads::stealing>(4, nullptr) };
+
+    constexpr int subtasks_count{ 1000 };
+
+    std::atomic<int> done_count{ 0 };
+    std::thread::id spawner_thread_id{};
+
+    std::mutex access;
+    std::set<std::thread::id> subtask_thread_ids;
+
+    manager.task(L"spawner"s, [&]
+    {
+        spawner_thread_id = std::this_thread::get_id();
+
+        // The subtasks go into the own deque of this thread
+        for (int index = 0; index < subtasks_count; ++index)
+        {
+            manager.task(L"subtask"s, [&]
+            {
+                {
+                    const std::lock_guard<std::mutex> lock{ access };
+                    subtask_thread_ids.insert(std::this_thread::get_id());
+                }
+
+                done_count += 1;
+            });
+        }
+
+        // This thread is busy until the subtasks complete: only the other threads can take them
+        const auto deadline{ std::chrono::steady_clock::now() + std::chrono::seconds{ 10 } };
+        while (done_count.load() < subtasks_count && std::chrono::steady_clock::now() < deadline)
+            std::this_thread::sleep_for(std::chrono::milliseconds{ 1 });
+    });
+
+    manager.wait_tasks_complete();
+
+    EXPECT_EQ(subtasks_count, done_count.load());
+    EXPECT_FALSE(subtask_thread_ids.empty());
+    EXPECT_EQ(std::size_t{ 0 }, subtask_thread_ids.count(spawner_thread_id));
+}
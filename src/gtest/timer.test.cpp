@@ -0,0 +1,137 @@
+#include "pch.h"
+
+#include <async.hpp>
+
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <vector>
+
+
+namespace
+{
+    template<class _Predicate>
+    bool wait_for(_Predicate&& predicate, std::chrono::milliseconds timeout = std::chrono::seconds{ 5 })
+    {
+        const std::chrono::steady_clock::time_point deadline{ std::chrono::steady_clock::now() + timeout };
+
+        while (!predicate())
+        {
+            if (std::chrono::steady_clock::now() >= deadline)
+                return false;
+
+            std::this_thread::sleep_for(std::chrono::milliseconds{ 1 });
+        }
+
+        return true;
+    }
+
+} // namespace
+
+
+TEST(timer, delay)
+{
+    async::manager manager{ async::make_manager<async::pool_threads::always>(2, nullptr) };
+
+    std::atomic<bool> resolved{ false };
+
+    const std::chrono::steady_clock::time_point start{ std::chrono::steady_clock::now() };
+    std::atomic<std::chrono::steady_clock::duration::rep> elapsed{ 0 };
+
+    manager.delay(L"delay"s, std::chrono::milliseconds{ 20 }).success<void>([&]
+    {
+        elapsed = (std::chrono::steady_clock::now() - start).count();
+        resolved = true;
+    });
+
+    EXPECT_TRUE(wait_for([&] { return resolved.load(); }));
+    EXPECT_GE(std::chrono::steady_clock::duration{ elapsed.load() }, std::chrono::milliseconds{ 20 });
+}
+
+TEST(timer, schedule_at)
+{
+    async::manager manager{ async::make_manager<async::pool_threads::always>(2, nullptr) };
+
+    std::atomic<int> result{ 0 };
+
+    manager.schedule_at<int>(L"schedule_at"s, std::chrono::steady_clock::now() + std::chrono::milliseconds{ 10 }, [] { return 42; })
+        .success<void>([&](int value) { result += value; });
+
+    // The time has passed: the task is executed at once
+    manager.schedule_at(L"schedule_at_passed"s, std::chrono::steady_clock::now() - std::chrono::seconds{ 1 }, [&] { result += 1; });
+
+    EXPECT_TRUE(wait_for([&] { return result.load() == 43; }));
+}
+
+TEST(timer, every_and_cancel)
+{
+    async::manager manager{ async::make_manager<async::pool_threads::always>(2, nullptr) };
+
+    std::atomic<int> count{ 0 };
+
+    async::timer periodic{ manager.every(L"every"s, std::chrono::milliseconds{ 5 }, [&] { count += 1; }) };
+
+    EXPECT_TRUE(wait_for([&] { return count.load() >= 3; }));
+
+    EXPECT_TRUE(periodic.cancel());
+    EXPECT_FALSE(periodic.cancel());
+
+    manager.wait_tasks_complete();
+
+    const int count_after_cancel{ count.load() };
+    std::this_thread::sleep_for(std::chrono::milliseconds{ 30 });
+
+    EXPECT_EQ(count_after_cancel, count.load());
+}
+
+TEST(timer, cancel_many)
+{
+    async::manager manager{ async::make_manager<async::pool_threads::always>(2, nullptr) };
+
+    std::atomic<int> count{ 0 };
+
+    std::vector<async::timer> timers;
+    for (int index = 0; index < 10000; ++index)
+        timers.push_back(manager.every(L"every"s, std::chrono::milliseconds{ 50 + index % 100 }, [&] { count += 1; }));
+
+    for (async::timer& periodic : timers)
+        EXPECT_TRUE(periodic.cancel());
+
+    std::this_thread::sleep_for(std::chrono::milliseconds{ 200 });
+
+    EXPECT_EQ(0, count.load());
+}
+
+TEST(timer, dropped_timers_break_promises)
+{
+    std::atomic<int> broken{ 0 };
+
+    const auto count_broken = [&broken](std::exception_ptr except)
+    {
+        try
+        {
+            std::rethrow_exception(except);
+        }
+        catch (const async::promise_error& error)
+        {
+            if (error.code() == async::promise_errc::broken_promise)
+                broken += 1;
+        }
+        catch (...)
+        {
+        }
+    };
+
+    {
+        async::manager manager{ async::make_manager<async::pool_threads::always>(2, nullptr) };
+
+        // The next steps are executed by the thread, which drops the timers
+        manager.set_continuations_exec(async::pool::exec_t::inline_exec);
+
+        manager.delay(L"delay"s, std::chrono::hours{ 1 }).reject(count_broken);
+        manager.schedule_at<int>(L"schedule_at"s, std::chrono::steady_clock::now() + std::chrono::hours{ 1 }, [] { return 42; })
+            .reject([&count_broken](std::exception_ptr except) { count_broken(except); return 0; });
+    } // The manager drops the armed timers
+
+    EXPECT_EQ(2, broken.load());
+}
@@ -0,0 +1,50 @@
+#include "pch.h"
+
+#include <async.hpp>
+
+#include <array>
+#include <memory>
+
+
+TEST(unique_task, empty)
+{
+    async::pool::task_t tsk{};
+    EXPECT_FALSE(tsk);
+    EXPECT_TRUE(tsk == nullptr);
+
+    std::function<void(async::pool::ctx_t)> empty_function{};
+    EXPECT_FALSE(async::pool::task_t{ empty_function });
+}
+
+TEST(unique_task, move_only_capture)
+{
+    async::unique_task<int(int)> tsk{ [value = std::make_unique<int>(40)](int arg) { return *value + arg; } };
+    ASSERT_TRUE(tsk);
+    EXPECT_EQ(42, tsk(2));
+
+    async::unique_task<int(int)> tsk_moved{ std::move(tsk) };
+    EXPECT_FALSE(tsk);
+    ASSERT_TRUE(tsk_moved);
+    EXPECT_EQ(43, tsk_moved(3));
+}
+
+TEST(unique_task, inline_and_heap)
+{
+    const std::shared_ptr<int> counter{ std::make_shared<int>(0) };
+
+    std::array<char, 2 * async::unique_task_inline_size_default> big_capture{};
+    big_capture[0] = 1;
+
+    async::pool::task_t tsk_inline{ [counter](async::pool::ctx_t) { *counter += 1; } };
+    async::pool::task_t tsk_heap{ [counter, big_capture](async::pool::ctx_t) { *counter += big_capture[0] * 10; } };
+
+    tsk_inline.swap(tsk_heap);
+    tsk_inline(async::pool::unknown_ctx);
+    tsk_heap(async::pool::unknown_ctx);
+    EXPECT_EQ(11, *counter);
+    EXPECT_EQ(3, counter.use_count());
+
+    tsk_inline = nullptr;
+    tsk_heap.reset();
+    EXPECT_EQ(1, counter.use_count());
+}
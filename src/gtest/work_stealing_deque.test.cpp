@@ -0,0 +1,197 @@
+#include "pch.h"
+
+#include <async.hpp>
+
+#include <atomic>
+#include <thread>
+#include <vector>
+#include <cstddef>
+#include <algorithm>
+
+
+namespace
+{
+    using deque_t = async::details::work_stealing_deque<std::size_t>;
+
+} // namespace
+
+
+TEST(work_stealing_deque, pop_is_lifo)
+{
+    deque_t deque;
+
+    for (std::size_t item = 1; item <= 10; ++item)
+        deque.push(item);
+
+    EXPECT_EQ(std::size_t{ 10 }, deque.size_approx());
+
+    for (std::size_t expected = 10; expected >= 1; --expected)
+    {
+        std::size_t item{ 0 };
+        ASSERT_TRUE(deque.pop(item));
+        EXPECT_EQ(expected, item);
+    }
+
+    std::size_t item{ 0 };
+    EXPECT_FALSE(deque.pop(item));
+    EXPECT_FALSE(deque.steal(item));
+    EXPECT_TRUE(deque.empty_approx());
+}
+
+TEST(work_stealing_deque, steal_is_fifo)
+{
+    deque_t deque;
+
+    for (std::size_t item = 1; item <= 10; ++item)
+        deque.push(item);
+
+    for (std::size_t expected = 1; expected <= 10; ++expected)
+    {
+        std::size_t item{ 0 };
+        ASSERT_TRUE(deque.steal(item));
+        EXPECT_EQ(expected, item);
+    }
+
+    std::size_t item{ 0 };
+    EXPECT_FALSE(deque.steal(item));
+    EXPECT_FALSE(deque.pop(item));
+}
+
+TEST(work_stealing_deque, last_item_by_pop_and_steal)
+{
+    deque_t deque;
+    std::size_t item{ 0 };
+
+    deque.push(1);
+    ASSERT_TRUE(deque.steal(item));
+    EXPECT_EQ(std::size_t{ 1 }, item);
+    EXPECT_FALSE(deque.pop(item));
+
+    deque.push(2);
+    ASSERT_TRUE(deque.pop(item));
+    EXPECT_EQ(std::size_t{ 2 }, item);
+    EXPECT_FALSE(deque.steal(item));
+
+    // The indexes are moved on: the deque is used again after the empty one
+    deque.push(3);
+    deque.push(4);
+    ASSERT_TRUE(deque.steal(item));
+    EXPECT_EQ(std::size_t{ 3 }, item);
+    ASSERT_TRUE(deque.pop(item));
+    EXPECT_EQ(std::size_t{ 4 }, item);
+}
+
+TEST(work_stealing_deque, grow)
+{
+    // The minimal capacity (32): the buffer is doubled several times
+    deque_t deque{ 1 };
+
+    constexpr std::size_t count{ 1000 };
+
+    std::size_t item{ 0 };
+
+    // The top is moved from zero, so the items are wrapped in the buffers before the grow
+    for (std::size_t index = 0; index < 20; ++index)
+    {
+        deque.push(index);
+        ASSERT_TRUE(deque.steal(item));
+    }
+
+    for (std::size_t index = 0; index < count; ++index)
+        deque.push(index);
+
+    EXPECT_EQ(count, deque.size_approx());
+
+    // Half from the top in FIFO order, half from the bottom in LIFO order
+    for (std::size_t expected = 0; expected < count / 2; ++expected)
+    {
+        ASSERT_TRUE(deque.steal(item));
+        EXPECT_EQ(expected, item);
+    }
+
+    for (std::size_t expected = count - 1; expected >= count / 2; --expected)
+    {
+        ASSERT_TRUE(deque.pop(item));
+        EXPECT_EQ(expected, item);
+    }
+
+    EXPECT_FALSE(deque.pop(item));
+    EXPECT_TRUE(deque.empty_approx());
+}
+
+TEST(work_stealing_deque, owner_and_thieves)
+{
+    // The small initial capacity: the owner grows the deque while it is stolen from
+    deque_t deque{ 32 };
+
+    constexpr std::size_t count{ 200000 };
+    constexpr std::size_t thieves_count{ 4 };
+
+    std::vector<std::atomic<int>> taken(count);
+    std::atomic<bool> owner_done{ false };
+    std::atomic<std::size_t> stolen_count{ 0 };
+
+    std::vector<std::thread> thieves;
+    for (std::size_t thief = 0; thief < thieves_count; ++thief)
+    {
+        thieves.emplace_back([&]
+        {
+            std::size_t item{ 0 };
+
+            for (;;)
+            {
+                if (deque.steal(item))
+                {
+                    taken[item] += 1;
+                    stolen_count += 1;
+                }
+                else if (owner_done.load())
+                {
+                    break;
+                }
+                else
+                {
+                    std::this_thread::yield();
+                }
+            }
+        });
+    }
+
+    std::size_t popped_count{ 0 };
+    std::size_t item{ 0 };
+
+    // The bursts of pushes, then the owner pops a part of them back (races with the thieves for the last items)
+    for (std::size_t next = 0; next < count; )
+    {
+        const std::size_t burst_end{ std::min(count, next + 1000) };
+
+        for (; next < burst_end; ++next)
+            deque.push(next);
+
+        for (std::size_t pops = 0; pops < 300 && deque.pop(item); ++pops)
+        {
+            taken[item] += 1;
+            ++popped_count;
+        }
+    }
+
+    while (deque.pop(item))
+    {
+        taken[item] += 1;
+        ++popped_count;
+    }
+
+    owner_done = true;
+
+    for (std::thread& thief : thieves)
+        thief.join();
+
+    EXPECT_EQ(count, popped_count + stolen_count.load());
+
+    std::size_t not_once{ 0 };
+    for (const std::atomic<int>& times : taken)
+        not_once += (times.load() != 1);
+
+    EXPECT_EQ(std::size_t{ 0 }, not_once);
+    EXPECT_TRUE(deque.empty_approx());
+}